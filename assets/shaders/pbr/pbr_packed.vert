@@ -0,0 +1,43 @@
+#version 450
+
+// Variant of pbr.vert for quantized vertices. Positions are unorm in the mesh
+// bounds, the transform includes the mesh dequantize matrix.
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec2 in_normal;
+layout(location = 2) in vec2 in_uv;
+layout(location = 3) in vec4 in_color;
+
+layout(location = 0) out vec3 out_world_position;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec2 out_uv;
+layout(location = 3) out vec3 out_color;
+
+layout(set = 0, binding = 0) uniform Camera3D {
+    float aspect_ratio;
+    float fov_v;
+    vec3 position;
+    vec3 forward;
+    vec3 up;
+    mat4 proj_view;
+} camera;
+
+layout(push_constant) uniform Transform {
+    mat4 matrix;
+} transform;
+
+vec3 octahedral_decode(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    const float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+void main() {
+    const vec4 world_position = transform.matrix * vec4(in_position, 1.0);
+    gl_Position = camera.proj_view * world_position;
+    out_world_position = world_position.xyz;
+    out_normal = octahedral_decode(in_normal);
+    out_uv = in_uv;
+    out_color = in_color.rgb;
+}
@@ -6,6 +6,7 @@ layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec2 in_tex_coords;
 
 layout(location = 0) out vec2 out_tex_coords;
+layout(location = 1) flat out vec4 out_overlap_color;
 
 layout(set = 0, binding = 0) uniform Camera {
     vec2 position;
@@ -16,6 +17,10 @@ layout(set = 0, binding = 0) uniform Camera {
 
 layout(push_constant) uniform Pvm {
 	mat4 matrix;
+	// x/y is the offset of the slice in the atlas page, in normalized coordinates
+	// z/w is the size of the slice in the atlas page, in normalized coordinates
+	vec4 uv_rect;
+	vec4 overlap_color;
 } pvm;
 
 void main() {
@@ -37,5 +42,6 @@ void main() {
         1.0
     );
 
-    out_tex_coords = in_tex_coords;
+    out_tex_coords = in_tex_coords * pvm.uv_rect.zw + pvm.uv_rect.xy;
+    out_overlap_color = pvm.overlap_color;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "core/app.hpp"
 #include "core/console.hpp"
+#include "core/job_system.hpp"
 #include "core/timing.hpp"
 #include "core/window.hpp"
 #include "ecs/context.hpp"
@@ -8,6 +9,9 @@
 #include "input/input.hpp"
 #include "resources/resources.hpp"
 
+#include <fstream>
+#include <string>
+
 namespace kzn {
 
 class BasicApp : public App {
@@ -16,22 +20,50 @@ public:
         : BasicApp("test app", 1200, 800) {}
 
     BasicApp(std::string_view name, int width, int height)
-        : m_window(name, width, height)
+        : m_job_system()
+        , m_window(name, width, height)
         , m_input(m_window)
+        // Console variables from the config file must be set before the
+        // systems reading them at creation are constructed
+        , m_console(std::filesystem::path{"kazan.cfg"})
         , m_renderer(m_window) {
 
         // Add some resource path aliases
         const auto current_path = std::filesystem::current_path();
-        g_resources.path_aliases.add("engine", current_path);
-        g_resources.path_aliases.add("assets", current_path / "assets");
-        g_resources.path_aliases.add("shaders", current_path / "assets/shaders");
-        g_resources.path_aliases.add("textures", current_path / "assets/textures");
-        g_resources.path_aliases.add("models", current_path / "assets/models");
-        g_resources.path_aliases.add("fonts", current_path / "assets/fonts");
-        g_resources.path_aliases.add("tmp", "/tmp");
+        g_resources.path_aliases.add("engine"_sh, current_path);
+        g_resources.path_aliases.add("assets"_sh, current_path / "assets");
+        g_resources.path_aliases.add("shaders"_sh, current_path / "assets/shaders");
+        g_resources.path_aliases.add("textures"_sh, current_path / "assets/textures");
+        g_resources.path_aliases.add("models"_sh, current_path / "assets/models");
+        g_resources.path_aliases.add("fonts"_sh, current_path / "assets/fonts");
+        g_resources.path_aliases.add("tmp"_sh, "/tmp");
+
+        // Mount packed assets, cooked with kpak_cooker, over loose files
+        for (const std::string_view alias : {"shaders", "textures", "models", "fonts"}) {
+            const auto archive_path =
+                current_path / "assets" / fmt::format("{}.kpak", alias);
+            if (!std::filesystem::exists(archive_path)) {
+                continue;
+            }
+            try {
+                g_resources.mount(alias, archive_path);
+            }
+            catch (const LoadingError& e) {
+                Log::error("{}", e.message);
+            }
+        }
 
         // Create commands
         m_console.create_cmd("exit", [this]() { m_window.close(); });
+        m_console.create_cmd("res_profile", [](std::string path) {
+            auto file = std::ofstream{path};
+            if (!file.is_open()) {
+                Log::error("Failed to open file '{}'", path);
+                return;
+            }
+            file << g_resources.load_profile_json();
+            Log::info("Saved resource load profile to '{}'", path);
+        });
     }
 
     ~BasicApp() {}
@@ -44,34 +76,54 @@ public:
 
         // Game loop
         float accum_time = 0.f;
+        m_frame_clock.reset();
         while (!m_window.is_closed()) {
             // Compute delta time
-            float frame_time = delta_time();
-            accum_time += frame_time;
+            const float frame_time = m_frame_clock.tick();
+            accum_time += m_frame_clock.raw_delta_time();
 
             // Update window events and input state
             m_window.poll_events();
             m_input.update_state();
+
+            // Publish resources finished loading in the background
+            g_resources.update();
             
             // Update systems
             executor.update(m_scene, frame_time);
             
-            // Update FPS in window title every seconds
+            // Update frame stats in window title every seconds
             if (accum_time > 1.f) {
-                auto title = fmt::format("FPS: {:.0f}", 1.f / frame_time);
+                auto title = fmt::format(
+                    "FPS: {:.0f} | {:.2f} ms | p99: {:.2f} ms",
+                    m_frame_clock.average_fps(),
+                    m_frame_clock.smoothed_delta_time() * 1000.f,
+                    m_frame_clock.percentile(0.99f) * 1000.f
+                );
                 m_window.set_title(title);
                 accum_time = 0.f;
             }
+
+            // Cap frame rate
+            const int max_fps = cvar_max_fps.get();
+            m_frame_limiter.wait(
+                float((max_fps < 0) ? m_window.refresh_rate() : max_fps)
+            );
         }
     }
 
 protected:
+    // Job system is created first and destroyed last so that every other
+    // member can schedule jobs during its whole lifetime
+    Context<JobSystem> m_job_system;
     Context<Window> m_window;
     Context<Input> m_input;
     Context<Console> m_console;
     Context<Renderer> m_renderer;
     Scheduler m_systems;
     Scene m_scene;
+    FrameClock m_frame_clock;
+    FrameLimiter m_frame_limiter;
 };
 
 } // namespace kzn
\ No newline at end of file
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "core/console_types.hpp"
+#include "core/cvar.hpp"
 #include "core/log.hpp"
 #include "core/string.hpp"
 #include "core/string_hash.hpp"
 #include "core/traits.hpp"
 
 #include <charconv>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <span>
 #include <stdexcept>
@@ -43,7 +46,27 @@ ArgsTuple convert_to_args_tuple(std::span<std::string_view> cmd_args) {
 class Console {
 public:
     // Ctor
-    Console() = default;
+    Console() {
+        create_cmd("cvars", []() {
+            for (const auto& name : CVarRegistry::instance().names()) {
+                const auto cvar_ptr = CVarRegistry::instance().find(name);
+                Log::info(
+                    "{} = {} ({})",
+                    name,
+                    cvar_ptr->to_string(),
+                    cvar_ptr->description()
+                );
+            }
+        });
+    }
+    //! Creates a console and executes the config file at \p config_path, if
+    //! it exists.
+    explicit Console(const std::filesystem::path& config_path)
+        : Console() {
+        if (std::filesystem::exists(config_path)) {
+            execute_file(config_path);
+        }
+    }
     // Copy
     Console(const Console&) = delete;
     Console& operator=(const Console&) = delete;
@@ -108,10 +131,55 @@ public:
             return true;
         }
 
+        // Fallback to console variables, `<name>` prints the value and
+        // `<name> <value>` sets it
+        auto cvar_ptr = CVarRegistry::instance().find(splitted_cmd[0]);
+        if (cvar_ptr != nullptr) {
+            if (splitted_cmd.size() == 1) {
+                Log::info("{} = {}", cvar_ptr->name(), cvar_ptr->to_string());
+                return true;
+            }
+            if (splitted_cmd.size() != 2) {
+                Log::error("Console error: Invalid argument count!");
+                return false;
+            }
+            try {
+                cvar_ptr->set_from_string(splitted_cmd[1]);
+            }
+            catch (const std::runtime_error& re) {
+                Log::error("Console error: {}", re.what());
+                return false;
+            }
+            return true;
+        }
+
         Log::error("Command not found");
         return false;
     }
 
+    //! Execute every line of a file as a command. Empty lines and lines
+    //! starting with '#' are ignored.
+    //! \return false if the file could not be opened or any command failed.
+    bool execute_file(const std::filesystem::path& file_path) {
+        std::ifstream file{file_path};
+        if (!file.is_open()) {
+            Log::error("Cannot open '{}'", file_path.string());
+            return false;
+        }
+
+        bool all_executed = true;
+        std::string line;
+        while (std::getline(file, line)) {
+            const auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') {
+                continue;
+            }
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            all_executed &= execute_cmd(line);
+        }
+        return all_executed;
+    }
+
     std::span<const std::string> cmds() const {
         return std::span{m_commands_names.data(), m_commands_names.size()};
     }
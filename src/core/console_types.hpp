@@ -5,6 +5,7 @@
 #include <charconv>
 #include <concepts>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 
 namespace kzn {
@@ -17,6 +18,21 @@ concept ConsoleType = requires(T a, std::string_view arg) {
     { ConsoleTypeTraits<T>::convert_to(arg) } -> std::convertible_to<T>;
 };
 
+template<>
+struct ConsoleTypeTraits<bool> {
+    [[nodiscard]]
+    static bool convert_to(std::string_view arg) {
+        if (arg == "1" || arg == "true" || arg == "on") {
+            return true;
+        }
+        if (arg == "0" || arg == "false" || arg == "off") {
+            return false;
+        }
+        throw std::runtime_error(fmt::format("Cannot convert '{}' to bool", arg)
+        );
+    }
+};
+
 template<std::integral I>
 struct ConsoleTypeTraits<I> {
     [[nodiscard]]
@@ -49,4 +65,12 @@ struct ConsoleTypeTraits<F> {
     }
 };
 
+template<>
+struct ConsoleTypeTraits<std::string> {
+    [[nodiscard]]
+    static std::string convert_to(std::string_view arg) {
+        return std::string{arg};
+    }
+};
+
 } // namespace kzn
\ No newline at end of file
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "core/console_types.hpp"
+#include "core/string_hash.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+//! Type erased console variable interface used by the console to list, read
+//! and write variables by name.
+class CVarBase {
+public:
+    // Copy
+    CVarBase(const CVarBase&) = delete;
+    CVarBase& operator=(const CVarBase&) = delete;
+    // Move
+    CVarBase(CVarBase&&) = delete;
+    CVarBase& operator=(CVarBase&&) = delete;
+    // Dtor
+    virtual ~CVarBase();
+
+    [[nodiscard]]
+    std::string_view name() const {
+        return m_name;
+    }
+
+    [[nodiscard]]
+    std::string_view description() const {
+        return m_description;
+    }
+
+    //! Parses and sets the value.
+    //! \throws std::runtime_error if value cannot be converted.
+    virtual void set_from_string(std::string_view value) = 0;
+
+    [[nodiscard]]
+    virtual std::string to_string() const = 0;
+
+protected:
+    // Ctor
+    CVarBase(std::string_view name, std::string_view description);
+
+private:
+    std::string m_name;
+    std::string m_description;
+};
+
+//! Global registry of all console variables. Variables register themselves on
+//! construction and unregister on destruction.
+class CVarRegistry {
+public:
+    [[nodiscard]]
+    static CVarRegistry& instance() {
+        static CVarRegistry registry;
+        return registry;
+    }
+
+    //! Returns nullptr if there's no variable with such name.
+    [[nodiscard]]
+    CVarBase* find(StringHash name) const {
+        std::scoped_lock lock{m_mutex};
+        auto it = m_vars.find(name);
+        return (it != m_vars.end()) ? it->second : nullptr;
+    }
+
+    //! Sorted names of all registered variables.
+    [[nodiscard]]
+    std::span<const std::string> names() const {
+        return std::span{m_names.data(), m_names.size()};
+    }
+
+private:
+    friend class CVarBase;
+
+    void add(CVarBase& cvar) {
+        std::scoped_lock lock{m_mutex};
+        auto [_, inserted] = m_vars.try_emplace(cvar.name(), &cvar);
+        if (inserted) {
+            std::string name{cvar.name()};
+            m_names.insert(
+                std::upper_bound(m_names.begin(), m_names.end(), name),
+                std::move(name)
+            );
+        }
+    }
+
+    void remove(CVarBase& cvar) {
+        std::scoped_lock lock{m_mutex};
+        auto it = m_vars.find(cvar.name());
+        if (it != m_vars.end() && it->second == &cvar) {
+            m_vars.erase(it);
+            std::erase(m_names, cvar.name());
+        }
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<StringHash, CVarBase*> m_vars;
+    std::vector<std::string> m_names;
+};
+
+inline CVarBase::CVarBase(std::string_view name, std::string_view description)
+    : m_name{name}
+    , m_description{description} {
+    CVarRegistry::instance().add(*this);
+}
+
+inline CVarBase::~CVarBase() {
+    CVarRegistry::instance().remove(*this);
+}
+
+//! Typed console variable. Values are stored in an atomic so they can be read
+//! from any thread with a relaxed load, which is as cheap as a plain load on
+//! the hot paths that consume them.
+//!
+//! Console variables are meant to be declared as globals next to the code that
+//! reads them, and are settable from the console and startup config file by
+//! name.
+//!
+//! \example
+//! \code
+//! inline CVar<int> cvar_foo{"foo", 4, "Number of foos"};
+//! int foo = cvar_foo.get();
+//! \endcode
+template<ConsoleType T>
+    requires std::is_trivially_copyable_v<T>
+class CVar final : public CVarBase {
+public:
+    // Ctor
+    CVar(std::string_view name, T default_value, std::string_view description)
+        : CVarBase(name, description)
+        , m_value{default_value} {}
+    // Dtor
+    ~CVar() override = default;
+
+    [[nodiscard]]
+    T get() const noexcept {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    void set(T value) noexcept {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    operator T() const noexcept { return get(); }
+
+    void set_from_string(std::string_view value) override {
+        set(ConsoleTypeTraits<T>::convert_to(value));
+    }
+
+    [[nodiscard]]
+    std::string to_string() const override {
+        return fmt::format("{}", get());
+    }
+
+private:
+    std::atomic<T> m_value;
+};
+
+} // namespace kzn
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "file_watcher.hpp"
+
+#include "core/log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace kzn {
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher()
+    : m_inotify_fd{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+    , m_stop_fd{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)} {
+    if (m_inotify_fd < 0 || m_stop_fd < 0) {
+        Log::error("Failed to create file watcher");
+        return;
+    }
+    m_thread = std::thread([this] { watch_loop(); });
+    Log::trace("File watcher created");
+}
+
+FileWatcher::~FileWatcher() {
+    if (m_thread.joinable()) {
+        const std::uint64_t value = 1;
+        [[maybe_unused]] auto _ = write(m_stop_fd, &value, sizeof(value));
+        m_thread.join();
+    }
+    if (m_inotify_fd >= 0) {
+        close(m_inotify_fd);
+    }
+    if (m_stop_fd >= 0) {
+        close(m_stop_fd);
+    }
+}
+
+void FileWatcher::watch(const std::filesystem::path& directory) {
+    if (m_inotify_fd < 0) {
+        return;
+    }
+    std::scoped_lock lock{m_mutex};
+    // Editors usually save by writing a temporary file and moving it over
+    const int wd = inotify_add_watch(
+        m_inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO
+    );
+    if (wd < 0) {
+        Log::warning("Failed to watch directory '{}'", directory.native());
+        return;
+    }
+    if (m_directories.try_emplace(wd, directory).second) {
+        Log::trace("Watching directory '{}'", directory.native());
+    }
+}
+
+std::vector<std::filesystem::path> FileWatcher::poll_changes() {
+    std::scoped_lock lock{m_mutex};
+    return std::exchange(m_changes, {});
+}
+
+void FileWatcher::watch_loop() {
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    std::array<pollfd, 2> poll_fds{
+        pollfd{.fd = m_inotify_fd, .events = POLLIN},
+        pollfd{.fd = m_stop_fd, .events = POLLIN},
+    };
+
+    while (true) {
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            continue;
+        }
+        if (poll_fds[1].revents & POLLIN) {
+            break;
+        }
+
+        ssize_t length;
+        while ((length = read(m_inotify_fd, buffer.data(), buffer.size())) > 0) {
+            std::scoped_lock lock{m_mutex};
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event_ptr =
+                    reinterpret_cast<const inotify_event*>(&buffer[offset]);
+                offset += sizeof(inotify_event) + event_ptr->len;
+
+                auto it = m_directories.find(event_ptr->wd);
+                if (it == m_directories.end() || event_ptr->len == 0) {
+                    continue;
+                }
+                auto path = it->second / event_ptr->name;
+                if (std::ranges::find(m_changes, path) == m_changes.end()) {
+                    m_changes.push_back(std::move(path));
+                }
+            }
+        }
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher() {}
+
+FileWatcher::~FileWatcher() {}
+
+void FileWatcher::watch(const std::filesystem::path&) {}
+
+std::vector<std::filesystem::path> FileWatcher::poll_changes() {
+    return {};
+}
+
+void FileWatcher::watch_loop() {}
+
+#endif
+
+} // namespace kzn
\ No newline at end of file
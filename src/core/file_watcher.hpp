@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+//! Watches directories for files being written on a background thread.
+//!
+//! Changes are collected until `poll_changes()` is called, so a file saved
+//! several times between polls is only reported once.
+//! \note Only implemented on Linux (inotify), on other platforms no changes
+//! are ever reported.
+class FileWatcher {
+public:
+    // Ctor
+    FileWatcher();
+    // Copy
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    // Move
+    FileWatcher(FileWatcher&&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+    // Dtor
+    ~FileWatcher();
+
+    //! Watch files of \p directory, not recursive. Watching an already
+    //! watched directory does nothing.
+    void watch(const std::filesystem::path& directory);
+
+    //! Files written or moved into watched directories since the last call.
+    [[nodiscard]]
+    std::vector<std::filesystem::path> poll_changes();
+
+private:
+    void watch_loop();
+
+private:
+    int m_inotify_fd = -1;
+    //! Wakes up the watch thread to stop it.
+    int m_stop_fd = -1;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    //! Watched directories by watch descriptor.
+    std::unordered_map<int, std::filesystem::path> m_directories;
+    std::vector<std::filesystem::path> m_changes;
+};
+
+} // namespace kzn
\ No newline at end of file
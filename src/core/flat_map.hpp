@@ -5,6 +5,17 @@
 #include <algorithm>
 #include <stdexcept>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+
+namespace internal {
+
+//! True if comparator supports heterogeneous lookup (ie: std::less<>).
+template<typename Compare>
+concept TransparentCompare = requires { typename Compare::is_transparent; };
+
+} // namespace internal
 
 
 // A sorted VectorMap with binary search gives you most of the benefits of
@@ -33,6 +44,22 @@ public:
                              const Allocator& alloc = Allocator{})
         : m_data(alloc), m_comp(comp) {}
 
+    //! Bulk constructor, sorts and removes duplicates once which is
+    //! O(n log n) instead of O(n²) of inserting elements one by one. On
+    //! duplicate keys the first occurrence is kept.
+    template<std::input_iterator InputIt>
+    FlatMap(InputIt first, InputIt last,
+            const Compare& comp = Compare{},
+            const Allocator& alloc = Allocator{})
+        : m_data(alloc), m_comp(comp) {
+        insert(first, last);
+    }
+
+    FlatMap(std::initializer_list<value_type> init,
+            const Compare& comp = Compare{},
+            const Allocator& alloc = Allocator{})
+        : FlatMap(init.begin(), init.end(), comp, alloc) {}
+
     // ------------------------------------------------------------
     // Iterators
     // ------------------------------------------------------------
@@ -52,25 +79,36 @@ public:
     // Lookup
     // ------------------------------------------------------------
     iterator find(const Key& key) {
-        auto it = lower_bound(key);
-        if (it != end() && keys_equal(it->first, key)) {
-            return it;
-        }
-        return end();
+        return find_impl(*this, key);
     }
 
     const_iterator find(const Key& key) const {
-        auto it = lower_bound(key);
-        if (it != end() && keys_equal(it->first, key)) {
-            return it;
-        }
-        return end();
+        return find_impl(*this, key);
+    }
+
+    //! Heterogeneous lookup, only available with transparent comparators.
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    iterator find(const K& key) {
+        return find_impl(*this, key);
+    }
+
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    const_iterator find(const K& key) const {
+        return find_impl(*this, key);
     }
 
     bool contains(const Key& key) const {
         return find(key) != end();
     }
 
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    bool contains(const K& key) const {
+        return find(key) != end();
+    }
+
     T& at(const Key& key) {
         auto it = find(key);
         if (it == end()) {
@@ -108,6 +146,43 @@ public:
         return {it, true};
     }
 
+    //! Bulk insert. Appends all elements, sorts and merges them with the
+    //! existing ones once. Keys that already exist are not overwritten, and
+    //! among duplicated new keys the first occurrence is kept.
+    template<std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last) {
+        const auto old_size = static_cast<std::ptrdiff_t>(m_data.size());
+        m_data.insert(m_data.end(), first, last);
+
+        const auto by_key = [this](const value_type& a, const value_type& b) {
+            return m_comp(a.first, b.first);
+        };
+        const auto mid = m_data.begin() + old_size;
+        // Stable sort and merge keep existing elements before new ones and new
+        // ones in insertion order, so std::unique keeps the right element.
+        std::stable_sort(mid, m_data.end(), by_key);
+        std::inplace_merge(m_data.begin(), mid, m_data.end(), by_key);
+        m_data.erase(
+            std::unique(
+                m_data.begin(),
+                m_data.end(),
+                [this](const value_type& a, const value_type& b) {
+                    return keys_equal(a.first, b.first);
+                }
+            ),
+            m_data.end()
+        );
+    }
+
+    template<std::ranges::input_range R>
+    void insert_range(R&& range) {
+        insert(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    void insert(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
     template<typename... Args>
     std::pair<iterator, bool> emplace(Args&&... args) {
         value_type value(std::forward<Args>(args)...);
@@ -150,29 +225,291 @@ private:
     container_type m_data;
     Compare m_comp{};
 
-    iterator lower_bound(const Key& key) {
+    template<typename K>
+    iterator lower_bound(const K& key) {
         return std::lower_bound(
             m_data.begin(),
             m_data.end(),
             key,
-            [&](const value_type& v, const Key& k) {
+            [&](const value_type& v, const K& k) {
                 return m_comp(v.first, k);
             }
         );
     }
 
-    const_iterator lower_bound(const Key& key) const {
+    template<typename K>
+    const_iterator lower_bound(const K& key) const {
         return std::lower_bound(
             m_data.begin(),
             m_data.end(),
             key,
-            [&](const value_type& v, const Key& k) {
+            [&](const value_type& v, const K& k) {
                 return m_comp(v.first, k);
             }
         );
     }
 
-    bool keys_equal(const Key& a, const Key& b) const {
+    template<typename Self, typename K>
+    static auto find_impl(Self& self, const K& key) {
+        auto it = self.lower_bound(key);
+        if (it != self.end() && !self.m_comp(key, it->first)) {
+            return it;
+        }
+        return self.end();
+    }
+
+    template<typename A, typename B>
+    bool keys_equal(const A& a, const B& b) const {
         return !m_comp(a, b) && !m_comp(b, a);
     }
 };
+
+// Same interface as FlatMap but keys and values are stored in two separate
+// vectors. Binary search then only touches the keys array, which packs more
+// keys per cache line, and it's done without branches so the loop doesn't
+// suffer from branch mispredictions. Prefer it over FlatMap for lookup heavy
+// maps with small keys and big values.
+template<
+    typename Key,
+    typename T,
+    typename Compare = std::less<Key>
+>
+class FlatSplitMap {
+public:
+    using key_type   = Key;
+    using value_type = std::pair<const Key&, T&>;
+    using size_type  = std::size_t;
+
+    template<bool IsConst>
+    class Iterator {
+    public:
+        using MapPtr = std::conditional_t<IsConst, const FlatSplitMap*, FlatSplitMap*>;
+        using Value = std::conditional_t<IsConst, const T, T>;
+        using reference = std::pair<const Key&, Value&>;
+        using difference_type = std::ptrdiff_t;
+
+        struct ArrowProxy {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        Iterator() = default;
+        Iterator(MapPtr map_ptr, size_type idx)
+            : m_map_ptr{map_ptr}, m_idx{idx} {}
+
+        reference operator*() const {
+            return {m_map_ptr->m_keys[m_idx], m_map_ptr->m_values[m_idx]};
+        }
+        ArrowProxy operator->() const { return ArrowProxy{**this}; }
+
+        Iterator& operator++() { ++m_idx; return *this; }
+        Iterator operator++(int) { auto tmp = *this; ++m_idx; return tmp; }
+
+        bool operator==(const Iterator& other) const = default;
+
+        //! Index of the element in the keys and values arrays.
+        [[nodiscard]]
+        size_type index() const { return m_idx; }
+
+    private:
+        MapPtr m_map_ptr = nullptr;
+        size_type m_idx = 0;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // ------------------------------------------------------------
+    // Constructors
+    // ------------------------------------------------------------
+    FlatSplitMap() = default;
+
+    explicit FlatSplitMap(const Compare& comp) : m_comp(comp) {}
+
+    //! Bulk constructor, see FlatMap::insert(first, last).
+    template<std::input_iterator InputIt>
+    FlatSplitMap(InputIt first, InputIt last, const Compare& comp = Compare{})
+        : m_comp(comp) {
+        insert(first, last);
+    }
+
+    FlatSplitMap(std::initializer_list<std::pair<Key, T>> init,
+                 const Compare& comp = Compare{})
+        : FlatSplitMap(init.begin(), init.end(), comp) {}
+
+    // ------------------------------------------------------------
+    // Iterators
+    // ------------------------------------------------------------
+    iterator begin() noexcept { return {this, 0}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size()}; }
+    const_iterator end() const noexcept { return {this, size()}; }
+
+    // ------------------------------------------------------------
+    // Capacity
+    // ------------------------------------------------------------
+    bool empty() const noexcept { return m_keys.empty(); }
+    size_type size() const noexcept { return m_keys.size(); }
+    void reserve(size_type n) { m_keys.reserve(n); m_values.reserve(n); }
+
+    // ------------------------------------------------------------
+    // Lookup
+    // ------------------------------------------------------------
+    iterator find(const Key& key) { return {this, find_index(key)}; }
+    const_iterator find(const Key& key) const { return {this, find_index(key)}; }
+
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    iterator find(const K& key) { return {this, find_index(key)}; }
+
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    const_iterator find(const K& key) const { return {this, find_index(key)}; }
+
+    bool contains(const Key& key) const { return find_index(key) != size(); }
+
+    template<typename K>
+        requires internal::TransparentCompare<Compare>
+    bool contains(const K& key) const { return find_index(key) != size(); }
+
+    T& at(const Key& key) {
+        const auto idx = find_index(key);
+        if (idx == size()) {
+            throw std::out_of_range("FlatSplitMap::at");
+        }
+        return m_values[idx];
+    }
+
+    const T& at(const Key& key) const {
+        const auto idx = find_index(key);
+        if (idx == size()) {
+            throw std::out_of_range("FlatSplitMap::at");
+        }
+        return m_values[idx];
+    }
+
+    //! Contiguous sorted keys.
+    const std::vector<Key>& keys() const noexcept { return m_keys; }
+    //! Values in the same order as keys().
+    const std::vector<T>& values() const noexcept { return m_values; }
+
+    // ------------------------------------------------------------
+    // Modifiers
+    // ------------------------------------------------------------
+    template<typename V>
+    std::pair<iterator, bool> emplace(const Key& key, V&& value) {
+        const auto idx = lower_bound_index(key);
+        if (idx != size() && !m_comp(key, m_keys[idx])) {
+            return {iterator{this, idx}, false};
+        }
+        m_keys.insert(m_keys.begin() + idx, key);
+        m_values.insert(m_values.begin() + idx, std::forward<V>(value));
+        return {iterator{this, idx}, true};
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+        return emplace(value.first, value.second);
+    }
+
+    //! Bulk insert, see FlatMap::insert(first, last).
+    template<std::input_iterator InputIt>
+    void insert(InputIt first, InputIt last) {
+        std::vector<std::pair<Key, T>> merged;
+        merged.reserve(size());
+        for (size_type i = 0; i < size(); ++i) {
+            merged.emplace_back(std::move(m_keys[i]), std::move(m_values[i]));
+        }
+        const auto old_size = static_cast<std::ptrdiff_t>(merged.size());
+        merged.insert(merged.end(), first, last);
+
+        const auto by_key = [this](const auto& a, const auto& b) {
+            return m_comp(a.first, b.first);
+        };
+        const auto mid = merged.begin() + old_size;
+        std::stable_sort(mid, merged.end(), by_key);
+        std::inplace_merge(merged.begin(), mid, merged.end(), by_key);
+
+        m_keys.clear();
+        m_values.clear();
+        reserve(merged.size());
+        for (auto& [key, value] : merged) {
+            if (!m_keys.empty() && !m_comp(m_keys.back(), key)) {
+                continue;
+            }
+            m_keys.push_back(std::move(key));
+            m_values.push_back(std::move(value));
+        }
+    }
+
+    template<std::ranges::input_range R>
+    void insert_range(R&& range) {
+        insert(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    bool erase(const Key& key) {
+        const auto idx = find_index(key);
+        if (idx == size()) {
+            return false;
+        }
+        m_keys.erase(m_keys.begin() + idx);
+        m_values.erase(m_values.begin() + idx);
+        return true;
+    }
+
+    void clear() noexcept {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    // ------------------------------------------------------------
+    // Element access
+    // ------------------------------------------------------------
+    T& operator[](const Key& key) {
+        const auto idx = lower_bound_index(key);
+        if (idx != size() && !m_comp(key, m_keys[idx])) {
+            return m_values[idx];
+        }
+        m_keys.insert(m_keys.begin() + idx, key);
+        m_values.insert(m_values.begin() + idx, T{});
+        return m_values[idx];
+    }
+
+    // ------------------------------------------------------------
+    // Observers
+    // ------------------------------------------------------------
+    Compare key_comp() const {
+        return m_comp;
+    }
+
+private:
+    std::vector<Key> m_keys;
+    std::vector<T> m_values;
+    Compare m_comp{};
+
+    //! Branchless lower bound over the keys array. The conditional move on
+    //! `base` compiles to a cmov, so the loop always runs log2(n) iterations.
+    template<typename K>
+    size_type lower_bound_index(const K& key) const {
+        size_type len = m_keys.size();
+        if (len == 0) {
+            return 0;
+        }
+        const Key* const first = m_keys.data();
+        const Key* base = first;
+        while (len > 1) {
+            const size_type half = len / 2;
+            base = m_comp(base[half], key) ? base + half : base;
+            len -= half;
+        }
+        return static_cast<size_type>(base - first) + m_comp(*base, key);
+    }
+
+    template<typename K>
+    size_type find_index(const K& key) const {
+        const auto idx = lower_bound_index(key);
+        if (idx != size() && !m_comp(key, m_keys[idx])) {
+            return idx;
+        }
+        return size();
+    }
+};
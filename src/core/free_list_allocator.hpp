@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/assert.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <optional>
+
+namespace kzn {
+
+//! Allocator of ranges in a space of fixed capacity, such as the elements of a
+//! GPU buffer. It only does the bookkeeping, offsets are in whatever unit the
+//! owner of the space uses.
+//!
+//! Free ranges are kept sorted by offset. Allocation takes the first free
+//! range large enough, and freed ranges are merged with the free ranges next
+//! to them so the space doesn't stay fragmented.
+//!
+//! \warning Not thread safe.
+class FreeListAllocator {
+public:
+    // Ctor
+    explicit FreeListAllocator(std::size_t capacity)
+        : m_capacity{capacity}
+        , m_free_size{capacity}
+    {
+        if (capacity > 0) {
+            m_free_ranges.emplace(0, capacity);
+        }
+    }
+    // Copy
+    FreeListAllocator(const FreeListAllocator&) = default;
+    FreeListAllocator& operator=(const FreeListAllocator&) = default;
+    // Move
+    FreeListAllocator(FreeListAllocator&&) = default;
+    FreeListAllocator& operator=(FreeListAllocator&&) = default;
+    // Dtor
+    ~FreeListAllocator() = default;
+
+    //! Offset of a range of \p size, or nullopt if no free range is large
+    //! enough.
+    [[nodiscard]]
+    std::optional<std::size_t> allocate(std::size_t size) {
+        if (size == 0 || size > m_free_size) {
+            return std::nullopt;
+        }
+        for (auto it = m_free_ranges.begin(); it != m_free_ranges.end(); ++it) {
+            const auto [offset, range_size] = *it;
+            if (range_size < size) {
+                continue;
+            }
+            m_free_ranges.erase(it);
+            if (range_size > size) {
+                m_free_ranges.emplace(offset + size, range_size - size);
+            }
+            m_free_size -= size;
+            return offset;
+        }
+        return std::nullopt;
+    }
+
+    //! Gives back a range returned by `allocate()`.
+    void free(std::size_t offset, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        KZN_ASSERT_MSG(offset + size <= m_capacity, "Range out of bounds");
+        auto next_it = m_free_ranges.lower_bound(offset);
+        KZN_ASSERT_MSG(
+            next_it == m_free_ranges.end() || offset + size <= next_it->first,
+            "Range is already free"
+        );
+        m_free_size += size;
+
+        // Merge with the free ranges right before and after
+        if (next_it != m_free_ranges.begin()) {
+            const auto prev_it = std::prev(next_it);
+            KZN_ASSERT_MSG(
+                prev_it->first + prev_it->second <= offset,
+                "Range is already free"
+            );
+            if (prev_it->first + prev_it->second == offset) {
+                offset = prev_it->first;
+                size += prev_it->second;
+                m_free_ranges.erase(prev_it);
+            }
+        }
+        if (next_it != m_free_ranges.end() && offset + size == next_it->first) {
+            size += next_it->second;
+            m_free_ranges.erase(next_it);
+        }
+        m_free_ranges.emplace(offset, size);
+    }
+
+    [[nodiscard]]
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+    //! Sum of the free ranges, not all of it may fit a single allocation.
+    [[nodiscard]]
+    std::size_t free_size() const {
+        return m_free_size;
+    }
+    //! Number of free ranges, 1 when the space isn't fragmented.
+    [[nodiscard]]
+    std::size_t free_range_count() const {
+        return m_free_ranges.size();
+    }
+
+private:
+    std::size_t m_capacity;
+    std::size_t m_free_size;
+    //! Size of each free range, by offset.
+    std::map<std::size_t, std::size_t> m_free_ranges;
+};
+
+} // namespace kzn
@@ -0,0 +1,218 @@
+#include "job_system.hpp"
+
+#include "core/log.hpp"
+
+#include <fmt/format.h>
+
+#include <exception>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace kzn {
+
+namespace {
+
+//! Queue index of the current thread.
+thread_local std::size_t t_queue_index = 0;
+
+void setup_worker_thread(std::thread& thread, std::size_t index) {
+#ifdef __linux__
+    const auto name = fmt::format("kzn-worker-{}", index);
+    pthread_setname_np(thread.native_handle(), name.c_str());
+
+    // Pin worker to a core so its queue stays in that core's cache. Core 0 is
+    // left for the main thread.
+    const auto num_cores = std::thread::hardware_concurrency();
+    if (num_cores > 1) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(index % num_cores, &cpu_set);
+        pthread_setaffinity_np(
+            thread.native_handle(), sizeof(cpu_set_t), &cpu_set
+        );
+    }
+#endif
+}
+
+} // namespace
+
+JobSystem::JobSystem(std::size_t num_workers) {
+    // Queue 0 is owned by the creating thread
+    t_queue_index = 0;
+    m_queues.reserve(num_workers + 1);
+    for (std::size_t i = 0; i < num_workers + 1; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_workers.reserve(num_workers);
+    for (std::size_t i = 1; i < num_workers + 1; ++i) {
+        m_workers.emplace_back([this, i] { worker_loop(i); });
+        setup_worker_thread(m_workers.back(), i);
+    }
+
+    Log::trace("Job system created with {} workers", num_workers);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::scoped_lock lock{m_sleep_mutex};
+        m_stop = true;
+    }
+    m_sleep_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    Log::trace("Job system destroyed");
+}
+
+std::size_t JobSystem::default_worker_count() {
+    const std::size_t num_threads = std::thread::hardware_concurrency();
+    return (num_threads > 1) ? num_threads - 1 : 1;
+}
+
+std::size_t JobSystem::thread_index() noexcept {
+    return t_queue_index;
+}
+
+void JobSystem::schedule(JobFn job, JobCounter* counter) {
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(Job{std::move(job), counter});
+}
+
+void JobSystem::schedule_after(
+    JobCounter& dependency,
+    JobFn job,
+    JobCounter* counter
+) {
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::scoped_lock lock{dependency.m_mutex};
+        if (!dependency.is_done()) {
+            dependency.m_continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+    push(Job{std::move(job), counter});
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.is_done()) {
+        if (!try_run_job()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::try_run_job() {
+    auto job_opt = pop(t_queue_index);
+    if (!job_opt.has_value()) {
+        return false;
+    }
+    run(*job_opt);
+    return true;
+}
+
+void JobSystem::push(Job job) {
+    {
+        // Increment under the sleep mutex so a worker can't miss the wake up
+        // between checking the predicate and going to sleep
+        std::scoped_lock lock{m_sleep_mutex};
+        m_unfinished_jobs.fetch_add(1, std::memory_order_relaxed);
+        m_queued_jobs.fetch_add(1, std::memory_order_release);
+    }
+    auto& queue = *m_queues[t_queue_index];
+    {
+        std::scoped_lock lock{queue.mutex};
+        queue.jobs.push_back(std::move(job));
+    }
+    m_sleep_cv.notify_one();
+}
+
+std::optional<JobSystem::Job> JobSystem::pop(std::size_t queue_index) {
+    // Newest job from own queue
+    {
+        auto& queue = *m_queues[queue_index];
+        std::scoped_lock lock{queue.mutex};
+        if (!queue.jobs.empty()) {
+            auto job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    // Steal oldest job from other queues
+    const auto num_queues = m_queues.size();
+    for (std::size_t i = 1; i < num_queues; ++i) {
+        auto& queue = *m_queues[(queue_index + i) % num_queues];
+        std::unique_lock lock{queue.mutex, std::try_to_lock};
+        if (lock.owns_lock() && !queue.jobs.empty()) {
+            auto job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+void JobSystem::run(Job& job) {
+    try {
+        job.fn();
+    }
+    catch (const std::exception& e) {
+        Log::error("Job failed: {}", e.what());
+    }
+    catch (...) {
+        Log::error("Job failed with unknown exception");
+    }
+
+    auto counter_ptr = job.counter_ptr;
+    if (counter_ptr != nullptr) {
+        // Last job of the counter schedules its continuations
+        std::vector<std::pair<JobFn, JobCounter*>> continuations;
+        {
+            std::scoped_lock lock{counter_ptr->m_mutex};
+            if (counter_ptr->m_pending.fetch_sub(
+                    1, std::memory_order_acq_rel
+                ) == 1) {
+                continuations = std::move(counter_ptr->m_continuations);
+                counter_ptr->m_continuations.clear();
+            }
+        }
+        for (auto& [fn, continuation_counter_ptr] : continuations) {
+            push(Job{std::move(fn), continuation_counter_ptr});
+        }
+    }
+
+    // After pushing continuations, so the system never looks idle between
+    // a job and the jobs it unblocks
+    m_unfinished_jobs.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::worker_loop(std::size_t queue_index) {
+    t_queue_index = queue_index;
+    while (true) {
+        if (auto job_opt = pop(queue_index)) {
+            run(*job_opt);
+            continue;
+        }
+
+        std::unique_lock lock{m_sleep_mutex};
+        if (m_stop) {
+            break;
+        }
+        m_sleep_cv.wait(lock, [this] {
+            return m_stop ||
+                   m_queued_jobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+} // namespace kzn
\ No newline at end of file
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "core/singleton.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace kzn {
+
+using JobFn = std::function<void()>;
+
+//! Counts the unfinished jobs it was scheduled with. Used to wait for a group
+//! of jobs or to run jobs after them.
+//! \warning Must outlive every job scheduled with it, wait on it with
+//! `JobSystem::wait()` before destroying it.
+class JobCounter {
+public:
+    // Ctor
+    JobCounter() = default;
+    // Copy
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    // Move
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+    // Dtor
+    ~JobCounter() {
+        // The last job may still be releasing the lock after decrementing
+        std::scoped_lock lock{m_mutex};
+    }
+
+    [[nodiscard]]
+    bool is_done() const noexcept {
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+    [[nodiscard]]
+    std::uint32_t pending() const noexcept {
+        return m_pending.load(std::memory_order_acquire);
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<std::uint32_t> m_pending = 0;
+    //! Jobs scheduled once the counter reaches zero, with their own counters.
+    std::mutex m_mutex;
+    std::vector<std::pair<JobFn, JobCounter*>> m_continuations;
+};
+
+//! Thread pool with a work-stealing queue per thread.
+//!
+//! Each worker pushes and pops jobs at the back of its own queue, which keeps
+//! recently spawned (cache hot) jobs on the same core, and steals from the
+//! front of other queues when it runs out of work. Queue 0 belongs to the
+//! thread that created the job system, which only runs jobs while waiting on a
+//! counter, so it never idles while work it depends on is pending.
+//!
+//! \example
+//! \code
+//! JobCounter counter;
+//! job_system.schedule([] { load_textures(); }, &counter);
+//! job_system.schedule_after(counter, [] { upload_textures(); });
+//! job_system.parallel_for(0, meshes.size(), [&](std::size_t i) {
+//!     optimize(meshes[i]);
+//! });
+//! \endcode
+class JobSystem : public Singleton<JobSystem> {
+public:
+    // Ctor
+    explicit JobSystem(std::size_t num_workers = default_worker_count());
+    // Copy
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    // Move
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+    // Dtor
+    ~JobSystem();
+
+    //! One worker per hardware thread, minus the main thread.
+    [[nodiscard]]
+    static std::size_t default_worker_count();
+
+    //! Number of threads that run jobs, including the main thread.
+    [[nodiscard]]
+    std::size_t thread_count() const noexcept {
+        return m_queues.size();
+    }
+
+    //! Index of the calling thread, 0 for the main thread and for threads
+    //! not owned by the job system.
+    [[nodiscard]]
+    static std::size_t thread_index() noexcept;
+
+    //! Schedule a job. If \p counter is not null it is incremented now and
+    //! decremented when the job finishes.
+    void schedule(JobFn job, JobCounter* counter = nullptr);
+
+    //! Schedule a job to run once \p dependency reaches zero. Runs right away
+    //! if \p dependency is already done.
+    void schedule_after(
+        JobCounter& dependency,
+        JobFn job,
+        JobCounter* counter = nullptr
+    );
+
+    //! Runs pending jobs on the calling thread until \p counter is done.
+    void wait(JobCounter& counter);
+
+    //! Whether every scheduled job has finished, none is queued or running.
+    [[nodiscard]]
+    bool is_idle() const noexcept {
+        return m_unfinished_jobs.load(std::memory_order_acquire) == 0;
+    }
+
+    //! Runs one pending job on the calling thread.
+    //! \return false if there were no pending jobs.
+    bool try_run_job();
+
+    //! Calls \p fn for every index in [begin, end) across all threads and
+    //! returns when all calls are done.
+    //! \param grain_size Indices per job, 0 splits the range evenly between
+    //! the available threads.
+    template<typename Fn>
+    void parallel_for(
+        std::size_t begin,
+        std::size_t end,
+        Fn&& fn,
+        std::size_t grain_size = 0
+    ) {
+        if (begin >= end) {
+            return;
+        }
+        const std::size_t count = end - begin;
+        if (grain_size == 0) {
+            // A few chunks per thread to balance uneven work
+            grain_size = std::max<std::size_t>(
+                1, count / (thread_count() * 4)
+            );
+        }
+        if (grain_size >= count) {
+            for (std::size_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+            return;
+        }
+
+        JobCounter counter;
+        for (std::size_t chunk_begin = begin; chunk_begin < end;
+             chunk_begin += grain_size) {
+            const std::size_t chunk_end = std::min(chunk_begin + grain_size, end);
+            schedule(
+                [&fn, chunk_begin, chunk_end] {
+                    for (std::size_t i = chunk_begin; i < chunk_end; ++i) {
+                        fn(i);
+                    }
+                },
+                &counter
+            );
+        }
+        wait(counter);
+    }
+
+private:
+    struct Job {
+        JobFn fn;
+        JobCounter* counter_ptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+private:
+    void push(Job job);
+    [[nodiscard]]
+    std::optional<Job> pop(std::size_t queue_index);
+    void run(Job& job);
+    void worker_loop(std::size_t queue_index);
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+    //! Scheduled jobs not yet popped, used to put idle workers to sleep.
+    std::atomic<std::size_t> m_queued_jobs = 0;
+    //! Scheduled jobs that haven't finished running.
+    std::atomic<std::size_t> m_unfinished_jobs = 0;
+    std::atomic<bool> m_stop = false;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cv;
+};
+
+} // namespace kzn
\ No newline at end of file
@@ -3,22 +3,37 @@
 namespace kzn {
 
 void Log::error(std::string_view text) {
+    if (!is_enabled(LogLevel::Error)) {
+        return;
+    }
     fmt::print("[{}ERROR{}] {}\n", RED, RESET, text);
 }
 
 void Log::warning(std::string_view text) {
+    if (!is_enabled(LogLevel::Warning)) {
+        return;
+    }
     fmt::print("[{}WARNING{}] {}\n", YELLOW, RESET, text);
 }
 
 void Log::info(std::string_view text) {
+    if (!is_enabled(LogLevel::Info)) {
+        return;
+    }
     fmt::print("[{}INFO{}] {}\n", WHITE, RESET, text);
 }
 
 void Log::debug(std::string_view text) {
+    if (!is_enabled(LogLevel::Debug)) {
+        return;
+    }
     fmt::print("[{}DEBUG{}] {}\n", BLUE, RESET, text);
 }
 
 void Log::trace(std::string_view text) {
+    if (!is_enabled(LogLevel::Trace)) {
+        return;
+    }
     fmt::print("[{}TRACE{}] {}\n", GRAY, RESET, text);
 }
 
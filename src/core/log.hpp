@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/cvar.hpp"
+
 #include <fmt/core.h>
 #include <string_view>
 
@@ -14,7 +16,28 @@
 
 namespace kzn {
 
+enum class LogLevel : int {
+    Error = 0,
+    Warning,
+    Info,
+    Debug,
+    Trace,
+};
+
+inline CVar<int> cvar_log_level{
+    "log_level",
+    int(LogLevel::Trace),
+    "Most verbose log level printed (0: error, 1: warning, 2: info, 3: "
+    "debug, 4: trace)"
+};
+
 struct Log {
+    //! Whether messages of \p level are printed.
+    [[nodiscard]]
+    static bool is_enabled(LogLevel level) {
+        return int(level) <= cvar_log_level.get();
+    }
+
     // Simple string versions
     // Ex: Log::info("Hello World!") will write
     // [INFO] Hello World!
@@ -41,6 +64,9 @@ struct Log {
 
 template<typename... Args>
 void Log::error(fmt::format_string<Args...> in, Args&&... args) {
+    if (!is_enabled(LogLevel::Error)) {
+        return;
+    }
     fmt::print("[{}ERROR{}] ", RED, RESET);
     fmt::print(in, std::forward<Args>(args)...);
     fmt::print("\n");
@@ -48,6 +74,9 @@ void Log::error(fmt::format_string<Args...> in, Args&&... args) {
 
 template<typename... Args>
 void Log::warning(fmt::format_string<Args...> in, Args&&... args) {
+    if (!is_enabled(LogLevel::Warning)) {
+        return;
+    }
     fmt::print("[{}WARNING{}] ", YELLOW, RESET);
     fmt::print(in, std::forward<Args>(args)...);
     fmt::print("\n");
@@ -55,6 +84,9 @@ void Log::warning(fmt::format_string<Args...> in, Args&&... args) {
 
 template<typename... Args>
 void Log::info(fmt::format_string<Args...> in, Args&&... args) {
+    if (!is_enabled(LogLevel::Info)) {
+        return;
+    }
     fmt::print("[{}INFO{}] ", WHITE, RESET);
     fmt::print(in, std::forward<Args>(args)...);
     fmt::print("\n");
@@ -62,6 +94,9 @@ void Log::info(fmt::format_string<Args...> in, Args&&... args) {
 
 template<typename... Args>
 void Log::debug(fmt::format_string<Args...> in, Args&&... args) {
+    if (!is_enabled(LogLevel::Debug)) {
+        return;
+    }
     fmt::print("[{}DEBUG{}] ", BLUE, RESET);
     fmt::print(in, std::forward<Args>(args)...);
     fmt::print("\n");
@@ -69,6 +104,9 @@ void Log::debug(fmt::format_string<Args...> in, Args&&... args) {
 
 template<typename... Args>
 void Log::trace(fmt::format_string<Args...> in, Args&&... args) {
+    if (!is_enabled(LogLevel::Trace)) {
+        return;
+    }
     fmt::print("[{}TRACE{}] ", GRAY, RESET);
     fmt::print(in, std::forward<Args>(args)...);
     fmt::print("\n");
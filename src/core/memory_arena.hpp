@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace kzn {
+
+//! Memory arena for allocations that share the same lifetime, such as all the
+//! component storage of a scene.
+//!
+//! Memory is requested from the upstream resource in big chunks and carved
+//! sequentially, so allocations made one after the other are packed
+//! contiguously. Deallocated blocks are recycled through size-class pools, and
+//! `release()` gives every chunk back to the upstream resource at once, without
+//! visiting individual allocations.
+//!
+//! \warning Not thread safe.
+//! \warning After `release()` every pointer previously allocated from this
+//! arena is dangling. Owners must be destroyed before releasing.
+class MemoryArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t default_chunk_size = 1 << 20;
+
+public:
+    // Ctor
+    explicit MemoryArena(
+        std::size_t initial_chunk_size = default_chunk_size,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+    )
+        : m_chunks(initial_chunk_size, upstream)
+        , m_pools(&m_chunks) {}
+    // Copy
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+    // Move
+    MemoryArena(MemoryArena&&) = delete;
+    MemoryArena& operator=(MemoryArena&&) = delete;
+    // Dtor
+    ~MemoryArena() override = default;
+
+    //! Releases all memory allocated by this arena back to the upstream
+    //! resource in O(number of chunks).
+    void release() {
+        m_pools.release();
+        m_chunks.release();
+        m_bytes_in_use = 0;
+    }
+
+    //! Number of bytes currently handed out by this arena.
+    [[nodiscard]]
+    std::size_t bytes_in_use() const noexcept {
+        return m_bytes_in_use;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        m_bytes_in_use += bytes;
+        return m_pools.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+        override {
+        m_bytes_in_use -= bytes;
+        m_pools.deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other
+    ) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    //! Chunked bump allocator, deallocation is a no-op.
+    std::pmr::monotonic_buffer_resource m_chunks;
+    //! Recycles freed blocks by size class on top of the chunks.
+    std::pmr::unsynchronized_pool_resource m_pools;
+    std::size_t m_bytes_in_use = 0;
+};
+
+} // namespace kzn
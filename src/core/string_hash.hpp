@@ -1,12 +1,17 @@
 #pragma once
 
-#include <algorithm>
+#include <compare>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <string>
 #include <string_view>
 
+#ifdef DEBUG
+#include <mutex>
+#include <unordered_map>
+#endif
+
 namespace kzn {
 
 namespace internal {
@@ -27,47 +32,110 @@ struct Fnv1Params<std::uint64_t> {
     static constexpr std::uint64_t prime = 1099511628211ul;
 };
 
+#ifdef DEBUG
+//! Debug only table that maps hashes back to the strings they were computed
+//! from. Only hashes computed at runtime are registered.
+class StringHashTable {
+public:
+    static StringHashTable& instance() {
+        static StringHashTable table;
+        return table;
+    }
+
+    void record(std::uint64_t hash, std::string_view str) {
+        std::scoped_lock lock{m_mutex};
+        m_strings.try_emplace(hash, str);
+    }
+
+    [[nodiscard]]
+    std::string_view find(std::uint64_t hash) {
+        std::scoped_lock lock{m_mutex};
+        auto it = m_strings.find(hash);
+        // Node based container, references are stable across inserts
+        return (it != m_strings.end()) ? std::string_view{it->second}
+                                       : std::string_view{};
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::uint64_t, std::string> m_strings;
+};
+#endif
+
 } // namespace internal
 
 template<typename T>
 class BasicStringHash {
 public:
     using value_type = char;
+    using hash_type = T;
 
 public:
     //! Constructor of string hash with a c-style char array string.
     //! \note Does not take into account the null terminator (last character).
     template<size_t N>
-    BasicStringHash(const value_type (&str)[N])
+    constexpr BasicStringHash(const value_type (&str)[N])
         : BasicStringHash(std::string_view{str, N - 1}) {}
 
     //! Constructor of string hash with string.
     //! \note Assumes string does not include null terminator
-    BasicStringHash(const std::string& str)
+    constexpr BasicStringHash(const std::string& str)
         : BasicStringHash(std::string_view{str}) {}
 
     //! Constructor of string hash with string_view.
     //! \note Assumes string_view does not include null terminator
-    BasicStringHash(const std::string_view str)
-        : m_hash{std::ranges::fold_left(
-              str,
-              internal::Fnv1Params<T>::offset,
-              [](T accum, char c) {
-                  return accum * internal::Fnv1Params<T>::prime ^
-                         std::uint8_t(c);
-              }
-          )} {}
+    constexpr BasicStringHash(const std::string_view str)
+        : m_hash{hash(str)} {
+#ifdef DEBUG
+        if !consteval {
+            internal::StringHashTable::instance().record(m_hash, str);
+        }
+#endif
+    }
 
     // Copy
-    BasicStringHash(const BasicStringHash&) = default;
-    BasicStringHash& operator=(const BasicStringHash&) = default;
+    constexpr BasicStringHash(const BasicStringHash&) = default;
+    constexpr BasicStringHash& operator=(const BasicStringHash&) = default;
     // Move
-    BasicStringHash(BasicStringHash&&) = default;
-    BasicStringHash& operator=(BasicStringHash&&) = default;
+    constexpr BasicStringHash(BasicStringHash&&) = default;
+    constexpr BasicStringHash& operator=(BasicStringHash&&) = default;
     // Dtor
-    ~BasicStringHash() = default;
+    constexpr ~BasicStringHash() = default;
+
+    //! Computes FNV-1 hash of a string, multiplying before each xor.
+    //! \note Values may be stored, such as in pack archive tables, so this
+    //! stays FNV-1 rather than switching to FNV-1a.
+    [[nodiscard]]
+    static constexpr T hash(const std::string_view str) {
+        T accum = internal::Fnv1Params<T>::offset;
+        for (const char c : str) {
+            accum = accum * internal::Fnv1Params<T>::prime ^ std::uint8_t(c);
+        }
+        return accum;
+    }
 
-    operator std::uint32_t() const { return m_hash; }
+    //! Full width hash value.
+    [[nodiscard]]
+    constexpr T value() const noexcept {
+        return m_hash;
+    }
+
+    explicit constexpr operator T() const noexcept { return m_hash; }
+
+    constexpr bool operator==(const BasicStringHash&) const = default;
+    constexpr auto operator<=>(const BasicStringHash&) const = default;
+
+    //! Returns the string this hash was computed from, if known.
+    //! \note Only available in debug builds and for hashes computed at
+    //! runtime, otherwise returns an empty string_view.
+    [[nodiscard]]
+    std::string_view str() const {
+#ifdef DEBUG
+        return internal::StringHashTable::instance().find(m_hash);
+#else
+        return {};
+#endif
+    }
 
 public:
     T m_hash;
@@ -75,14 +143,29 @@ public:
 
 using StringHash = BasicStringHash<std::uint64_t>;
 
+inline namespace literals {
+
+//! Compile time string hash.
+//! \example
+//! \code
+//! constexpr StringHash id = "textures"_sh;
+//! \endcode
+consteval StringHash operator""_sh(const char* str, std::size_t size) {
+    return StringHash{std::string_view{str, size}};
+}
+
+} // namespace literals
+
 } // namespace kzn
 
 namespace std {
 
 template<typename T>
 struct hash<kzn::BasicStringHash<T>> {
-    std::uint32_t operator()(const kzn::BasicStringHash<T>& s) const noexcept {
-        return std::hash<T>{}(s.m_hash);
+    //! FNV-1 of a string is already well distributed, so the hash value is
+    //! used as is instead of hashing it again.
+    std::size_t operator()(const kzn::BasicStringHash<T>& s) const noexcept {
+        return static_cast<std::size_t>(s.value());
     }
 };
 
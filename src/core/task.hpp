@@ -0,0 +1,368 @@
+#pragma once
+
+#include "core/job_system.hpp"
+#include "resources/resource.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kzn {
+
+template<typename T = void>
+class Task;
+
+namespace internal {
+
+struct TaskPromiseBase {
+    //! Coroutine to resume when this one finishes.
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+
+    //! Resumes the awaiting coroutine through symmetric transfer, so long
+    //! chains of tasks don't grow the stack.
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> handle
+        ) noexcept {
+            return handle.promise().continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    // Tasks are lazy, they start when awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+        requires std::convertible_to<U, T>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+//! Eagerly started coroutine that destroys itself when done.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace internal
+
+//! Lazy coroutine task producing a value of type T.
+//!
+//! The coroutine starts when awaited and resumes its awaiter when it
+//! finishes, on whatever thread it finished on. Exceptions are propagated to
+//! the awaiter.
+//!
+//! \example
+//! \code
+//! Task<int> answer() { co_return 42; }
+//! Task<> print_answer() {
+//!     co_await schedule_on_worker();
+//!     Log::info("{}", co_await answer());
+//! }
+//! sync_wait(print_answer());
+//! \endcode
+//! \warning Coroutine parameters should be taken by value, references may
+//! dangle by the time the task runs.
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = internal::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+public:
+    // Ctor
+    Task() = default;
+    explicit Task(Handle handle)
+        : m_handle{handle} {}
+    // Copy
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    // Move
+    Task(Task&& other) noexcept
+        : m_handle{std::exchange(other.m_handle, nullptr)} {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    // Dtor
+    ~Task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    [[nodiscard]]
+    bool is_ready() const noexcept {
+        return !m_handle || m_handle.done();
+    }
+
+    //! Starts the task and resumes the awaiter with its result.
+    auto operator co_await() noexcept {
+        struct Awaiter : ReadyAwaiter {
+            T await_resume() { return this->handle.promise().result(); }
+        };
+        return Awaiter{{m_handle}};
+    }
+
+    //! Starts the task and resumes the awaiter when done, without consuming
+    //! the result or rethrowing exceptions.
+    auto when_ready() noexcept { return ReadyAwaiter{m_handle}; }
+
+    //! Result of a finished task. Rethrows the exception if the task failed.
+    T result() { return m_handle.promise().result(); }
+
+private:
+    struct ReadyAwaiter {
+        Handle handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<> awaiting
+        ) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+private:
+    Handle m_handle = nullptr;
+};
+
+namespace internal {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{
+        std::coroutine_handle<TaskPromise<void>>::from_promise(*this)
+    };
+}
+
+} // namespace internal
+
+///////////////////////////////////////////////////////////////////////////////
+// Awaitables
+///////////////////////////////////////////////////////////////////////////////
+
+//! Resumes the awaiting coroutine as a job. Doesn't suspend if there's no job
+//! system.
+struct ScheduleAwaiter {
+    JobSystem* job_system_ptr;
+
+    bool await_ready() const noexcept { return job_system_ptr == nullptr; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        job_system_ptr->schedule([handle] { handle.resume(); });
+    }
+
+    void await_resume() const noexcept {}
+};
+
+//! Continue the awaiting coroutine on a job system worker.
+[[nodiscard]]
+inline ScheduleAwaiter schedule_on_worker() {
+    return ScheduleAwaiter{
+        JobSystem::exists() ? &JobSystem::singleton() : nullptr
+    };
+}
+
+//! Resumes the awaiting coroutine once all jobs of a counter are done.
+struct CounterAwaiter {
+    JobSystem& job_system;
+    JobCounter& counter;
+
+    bool await_ready() const noexcept { return counter.is_done(); }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        job_system.schedule_after(counter, [handle] { handle.resume(); });
+    }
+
+    void await_resume() const noexcept {}
+};
+
+//! \example
+//! \code
+//! JobCounter counter;
+//! job_system.schedule(decode_job, &counter);
+//! co_await wait_for(job_system, counter);
+//! \endcode
+[[nodiscard]]
+inline CounterAwaiter wait_for(JobSystem& job_system, JobCounter& counter) {
+    return CounterAwaiter{job_system, counter};
+}
+
+namespace internal {
+
+template<typename T>
+struct WhenAllAwaiter {
+    std::span<Task<T>> tasks;
+    std::atomic<std::size_t> remaining = 0;
+    std::coroutine_handle<> awaiting;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        awaiting = handle;
+        // One extra count so the last task can't resume the awaiting
+        // coroutine before all tasks were started
+        remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+        for (auto& task : tasks) {
+            start(task, *this);
+        }
+        return remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+
+    static DetachedTask start(Task<T>& task, WhenAllAwaiter& self) {
+        co_await schedule_on_worker();
+        co_await task.when_ready();
+        if (self.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            self.awaiting.resume();
+        }
+    }
+};
+
+} // namespace internal
+
+//! Runs all tasks concurrently on the job system.
+//! \return The results in the same order as \p tasks. Rethrows the first
+//! failed task's exception.
+template<typename T>
+Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> when_all(
+    std::vector<Task<T>> tasks
+) {
+    co_await internal::WhenAllAwaiter<T>{
+        .tasks = std::span{tasks},
+        .remaining = 0,
+        .awaiting = nullptr,
+    };
+
+    if constexpr (std::is_void_v<T>) {
+        for (auto& task : tasks) {
+            task.result();
+        }
+    }
+    else {
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (auto& task : tasks) {
+            results.push_back(task.result());
+        }
+        co_return results;
+    }
+}
+
+//! Blocks until \p task finishes and returns its result. The calling thread
+//! runs pending jobs while waiting.
+template<typename T>
+T sync_wait(Task<T> task) {
+    // Shared so the flag outlives the detached coroutine signaling it
+    auto done_ptr = std::make_shared<std::atomic<bool>>(false);
+    [](Task<T>& task,
+       std::shared_ptr<std::atomic<bool>> done_ptr) -> internal::DetachedTask {
+        co_await task.when_ready();
+        done_ptr->store(true, std::memory_order_release);
+        done_ptr->notify_all();
+    }(task, done_ptr);
+
+    if (JobSystem::exists()) {
+        auto& job_system = JobSystem::singleton();
+        while (!done_ptr->load(std::memory_order_acquire)) {
+            if (!job_system.try_run_job()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    else {
+        done_ptr->wait(false, std::memory_order_acquire);
+    }
+    return task.result();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// I/O
+///////////////////////////////////////////////////////////////////////////////
+
+//! Reads a whole file on a job system worker.
+//! \throws LoadingError
+inline Task<std::vector<std::byte>> read_file_async(std::filesystem::path path
+) {
+    co_await schedule_on_worker();
+
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file.is_open()) {
+        throw LoadingError{
+            std::string("Failed to open file '") + path.string() + "'"
+        };
+    }
+    std::vector<std::byte> bytes(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    co_return bytes;
+}
+
+} // namespace kzn
\ No newline at end of file
@@ -1,19 +1,240 @@
 #pragma once
 
+#include "core/cvar.hpp"
+
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
 
 namespace kzn {
 
 //! Returns delta time in seconds from the last time delta_time was called.
 inline float delta_time() {
-    static auto begin = std::chrono::high_resolution_clock::now();
-    const auto end = std::chrono::high_resolution_clock::now();
-    auto microseconds =
-        std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
-            .count();
+    static auto begin = std::chrono::steady_clock::now();
+    const auto end = std::chrono::steady_clock::now();
+    const std::chrono::duration<float> seconds = end - begin;
     begin = end;
-    // FIXME: Bad conversion to seconds
-    return float(microseconds) / 1000000.f;
+    return seconds.count();
 }
 
-} // namespace kzn
+//! Frame rate cap in frames per second. 0 is uncapped and -1 caps to the
+//! display refresh rate.
+inline CVar<int> cvar_max_fps{
+    "max_fps", 0, "Frame rate cap (0: uncapped, -1: display refresh rate)"
+};
+
+//! Measures frame times with a monotonic clock and keeps a rolling history to
+//! compute smoothed statistics.
+//!
+//! Delta times handed to systems are clamped to `max_delta_time`, so a single
+//! hitch (loading, window drag, breakpoint) does not make the simulation jump.
+//! Raw frame times are still recorded in the history so that spikes show up
+//! in the percentiles.
+class FrameClock {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t history_size = 256;
+    //! Smoothing factor of the exponential moving average.
+    static constexpr float smoothing = 0.1f;
+
+public:
+    // Ctor
+    explicit FrameClock(float max_delta_time = 0.1f)
+        : m_max_delta_time{max_delta_time} {}
+    // Copy
+    FrameClock(const FrameClock&) = default;
+    FrameClock& operator=(const FrameClock&) = default;
+    // Move
+    FrameClock(FrameClock&&) = default;
+    FrameClock& operator=(FrameClock&&) = default;
+    // Dtor
+    ~FrameClock() = default;
+
+    //! Restarts timing from now without recording a frame. Useful after long
+    //! blocking operations that should not count as a frame.
+    void reset() { m_frame_begin = Clock::now(); }
+
+    //! Marks the beginning of a new frame.
+    //! \return Clamped delta time in seconds since the previous frame.
+    float tick() {
+        const auto now = Clock::now();
+        const std::chrono::duration<float> frame_time = now - m_frame_begin;
+        m_frame_begin = now;
+
+        m_raw_delta_time = frame_time.count();
+        m_delta_time = std::min(m_raw_delta_time, m_max_delta_time);
+        if (m_raw_delta_time > m_max_delta_time) {
+            ++m_clamped_frames;
+        }
+
+        m_smoothed_delta_time =
+            (m_frame_index == 0)
+                ? m_raw_delta_time
+                : m_smoothed_delta_time +
+                      smoothing * (m_raw_delta_time - m_smoothed_delta_time);
+
+        m_history[m_frame_index % history_size] = m_raw_delta_time;
+        ++m_frame_index;
+        return m_delta_time;
+    }
+
+    //! Number of frames ticked so far.
+    [[nodiscard]]
+    std::uint64_t frame_index() const noexcept {
+        return m_frame_index;
+    }
+
+    [[nodiscard]]
+    Clock::time_point frame_begin() const noexcept {
+        return m_frame_begin;
+    }
+
+    //! Delta time of the current frame clamped to the max delta time.
+    [[nodiscard]]
+    float delta_time() const noexcept {
+        return m_delta_time;
+    }
+
+    //! Unclamped delta time of the current frame.
+    [[nodiscard]]
+    float raw_delta_time() const noexcept {
+        return m_raw_delta_time;
+    }
+
+    //! Exponential moving average of the frame time.
+    [[nodiscard]]
+    float smoothed_delta_time() const noexcept {
+        return m_smoothed_delta_time;
+    }
+
+    //! Number of frames whose delta time was clamped.
+    [[nodiscard]]
+    std::uint64_t clamped_frames() const noexcept {
+        return m_clamped_frames;
+    }
+
+    //! Average frame time over the history.
+    [[nodiscard]]
+    float average_frame_time() const {
+        const auto samples = history_samples();
+        if (samples == 0) {
+            return 0.f;
+        }
+        float sum = 0.f;
+        for (std::size_t i = 0; i < samples; ++i) {
+            sum += m_history[i];
+        }
+        return sum / float(samples);
+    }
+
+    //! Average frames per second over the history.
+    [[nodiscard]]
+    float average_fps() const {
+        const float average = average_frame_time();
+        return (average > 0.f) ? 1.f / average : 0.f;
+    }
+
+    //! Frame time at percentile \p p of the history, in [0, 1].
+    //! \example
+    //! \code
+    //! float p99 = frame_clock.percentile(0.99f);
+    //! \endcode
+    [[nodiscard]]
+    float percentile(float p) const {
+        const auto samples = history_samples();
+        if (samples == 0) {
+            return 0.f;
+        }
+        auto sorted = m_history;
+        const auto nth = std::min(
+            std::size_t(std::clamp(p, 0.f, 1.f) * float(samples)), samples - 1
+        );
+        std::nth_element(
+            sorted.begin(), sorted.begin() + nth, sorted.begin() + samples
+        );
+        return sorted[nth];
+    }
+
+private:
+    [[nodiscard]]
+    std::size_t history_samples() const noexcept {
+        return std::size_t(std::min<std::uint64_t>(m_frame_index, history_size)
+        );
+    }
+
+private:
+    float m_max_delta_time;
+    Clock::time_point m_frame_begin = Clock::now();
+    std::uint64_t m_frame_index = 0;
+    std::uint64_t m_clamped_frames = 0;
+    float m_delta_time = 0.f;
+    float m_raw_delta_time = 0.f;
+    float m_smoothed_delta_time = 0.f;
+    std::array<float, history_size> m_history{};
+};
+
+//! Caps the frame rate by waiting until the next frame deadline.
+//!
+//! OS sleeps are coarse and may overshoot by more than a millisecond, so the
+//! limiter sleeps until shortly before the deadline and spins the remainder.
+//! The spin window adapts to the measured sleep overshoot, so most of the wait
+//! is spent sleeping and the CPU stays idle.
+class FrameLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    //! Waits until the next frame deadline for \p target_rate frames per
+    //! second. Does nothing if \p target_rate is not positive.
+    void wait(float target_rate) {
+        if (target_rate <= 0.f) {
+            m_next_frame = {};
+            return;
+        }
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(1.f / target_rate)
+        );
+        const auto now = Clock::now();
+        // Start scheduling, or drop deadlines that were missed by more than a
+        // frame instead of rushing frames to catch up
+        if (m_next_frame == Clock::time_point{} ||
+            now > m_next_frame + period) {
+            m_next_frame = now;
+        }
+        m_next_frame += period;
+
+        // Sleep
+        const auto sleep_until = m_next_frame - m_spin_window;
+        if (now < sleep_until) {
+            std::this_thread::sleep_until(sleep_until);
+            // Track how late the OS wakes us up
+            const auto overshoot = Clock::now() - sleep_until;
+            m_spin_window = std::clamp(
+                (m_spin_window * 7 + overshoot * 2) / 8,
+                min_spin_window,
+                max_spin_window
+            );
+        }
+
+        // Spin
+        while (Clock::now() < m_next_frame) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    static constexpr Clock::duration min_spin_window =
+        std::chrono::microseconds(200);
+    static constexpr Clock::duration max_spin_window =
+        std::chrono::milliseconds(4);
+
+private:
+    Clock::time_point m_next_frame{};
+    Clock::duration m_spin_window = std::chrono::milliseconds(1);
+};
+
+} // namespace kzn
\ No newline at end of file
@@ -75,6 +75,18 @@ float Window::aspect_ratio() const {
     return static_cast<float>(m_width) / static_cast<float>(m_height);
 }
 
+int Window::refresh_rate() const {
+    GLFWmonitor* monitor_ptr = glfwGetWindowMonitor(m_glfw_window);
+    if (monitor_ptr == nullptr) {
+        monitor_ptr = glfwGetPrimaryMonitor();
+    }
+    if (monitor_ptr == nullptr) {
+        return 0;
+    }
+    const GLFWvidmode* video_mode_ptr = glfwGetVideoMode(monitor_ptr);
+    return (video_mode_ptr != nullptr) ? video_mode_ptr->refreshRate : 0;
+}
+
 std::vector<const char*> Window::required_extensions() const {
     uint32_t glfw_extension_count = 0;
     // const char** glfw_extensions;
@@ -56,6 +56,10 @@ public:
     bool was_resized();
     [[nodiscard]]
     float aspect_ratio() const;
+    //! Refresh rate in Hz of the monitor the window is on, or of the primary
+    //! monitor in windowed mode. Returns 0 if unknown.
+    [[nodiscard]]
+    int refresh_rate() const;
     [[nodiscard]]
     std::vector<const char*> required_extensions() const;
 
@@ -4,8 +4,12 @@
 
 namespace kzn {
 
-entt::basic_registry<EntityId>& Registry::registry() {
-    return m_registry;
+Registry::Registry(MemoryArena& arena)
+    : m_arena_ptr{&arena}
+    , m_registry{std::in_place, EnttRegistry::allocator_type{&arena}} {}
+
+EnttRegistry& Registry::registry() {
+    return *m_registry;
 }
 
 Entity Registry::create() {
@@ -16,14 +20,16 @@ Entity Registry::create() {
 }
 
 void Registry::destroy(EntityId entity_id) {
-    m_registry.destroy(entity_id);
+    m_registry->destroy(entity_id);
     // entity.id = entt::null;
 }
 
 void Registry::destroy_all() {
-    for (auto entity : m_registry.view<EntityId>()) {
-        m_registry.destroy(entity);
-    }
+    // Storage must be destroyed before releasing the arena, otherwise
+    // component destructors would run on released memory.
+    m_registry.reset();
+    m_arena_ptr->release();
+    m_registry.emplace(EnttRegistry::allocator_type{m_arena_ptr});
 }
 
 } // namespace kzn
\ No newline at end of file
@@ -1,39 +1,62 @@
 #pragma once
 
+#include "core/memory_arena.hpp"
 #include "core/singleton.hpp"
 #include "entt/entity/entity.hpp"
 #include "entt/entity/fwd.hpp"
 #include "entt/entity/registry.hpp"
 #include <entt/entt.hpp>
 
+#include <memory_resource>
+#include <optional>
 #include <utility>
 
 namespace kzn {
 
 enum class EntityId : std::uint32_t {};
 
+//! Entt registry type used by the engine. All of its storage is allocated from
+//! a `MemoryArena` owned by the scene.
+using EnttRegistry =
+    entt::basic_registry<EntityId, std::pmr::polymorphic_allocator<EntityId>>;
+
 class Entity;
 
 //! Singleton wrapper class for managing entities.
 class Registry {
 public:
     friend class Entity;
-    Registry() = default;
+    //! Creates a registry whose component storage is allocated from `arena`.
+    //! The arena must outlive the registry.
+    explicit Registry(MemoryArena& arena);
+    // Copy
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+    // Move
+    Registry(Registry&&) = delete;
+    Registry& operator=(Registry&&) = delete;
+    // Dtor
     ~Registry() = default;
 
-    entt::basic_registry<EntityId>& registry();
+    EnttRegistry& registry();
 
     [[nodiscard]]
     Entity create();
 
     void destroy(EntityId entity_id);
 
+    //! Destroys all entities and releases all component storage at once.
+    //! Component destructors still run, but the memory is given back to the
+    //! arena in bulk instead of being freed allocation by allocation.
+    //! \warning Entity ids start over after this call, previously held ids
+    //! must not be used.
     void destroy_all();
 
     // TODO: [entity, c1, c2] = find_with<C1, C2>()
 
 private:
-    entt::basic_registry<EntityId> m_registry;
+    MemoryArena* m_arena_ptr;
+    std::optional<EnttRegistry> m_registry;
 };
 
 //! An identifier class that represents a entity
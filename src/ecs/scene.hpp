@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/memory_arena.hpp"
 #include "ecs/entity.hpp"
 
 namespace kzn {
@@ -8,7 +9,10 @@ namespace kzn {
 //! NOTE: For now it just owns the ECS registry, but in thee future this will
 //! be the serializable object of the scene/world.
 struct Scene {
-    Registry registry;
+    //! Backs all component storage of the registry. Declared before the
+    //! registry so that it outlives it.
+    MemoryArena arena;
+    Registry registry{arena};
 };
 
 } // namespace kzn
\ No newline at end of file
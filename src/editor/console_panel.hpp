@@ -182,16 +182,19 @@ public:
             word_start--;
         }
 
-        // Build a list of candidates
+        // Build a list of candidates from commands and console variables
         std::vector<std::string_view> candidates;
+        const std::string_view word{word_start, size_t(word_end - word_start)};
         for (const auto& command : commands) {
-            if (std::ranges::equal(
-                    command | std::ranges::views::take(word_end - word_start),
-                    std::string_view{word_start, size_t(word_end - word_start)}
-                )) {
+            if (command.starts_with(word)) {
                 candidates.push_back(command);
             }
         }
+        for (const auto& cvar_name : CVarRegistry::instance().names()) {
+            if (cvar_name.starts_with(word)) {
+                candidates.push_back(cvar_name);
+            }
+        }
 
         if (candidates.size() == 1) {
             // Single match. Delete the beginning of the word and replace it
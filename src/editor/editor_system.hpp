@@ -8,6 +8,7 @@
 #include "editor/console_panel.hpp"
 #include "editor/demo_panel.hpp"
 #include "editor/panel.hpp"
+#include "editor/resources_panel.hpp"
 #include "events/event_manager.hpp"
 #include "events/events.hpp"
 #include "graphics/render_system.hpp"
@@ -64,6 +65,7 @@ public:
         // Initialize default panels
         emplace_panel<ConsolePanel>(window, context<Console>());
         emplace_panel<DemoPanel>();
+        emplace_panel<ResourcesPanel>();
 
         // This event will inject ImGuiStage into the RenderSystem
         EventManager::send(EditorInitEvent{});
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "editor/panel.hpp"
+#include "events/event_manager.hpp"
+#include "input/input.hpp"
+#include "resources/resources.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace kzn {
+
+//! Resource cache hit ratio and how long each resource took to load, slowest
+//! first, to find the resources that dominate loading and the ones loaded
+//! redundantly. Toggled with F3.
+class ResourcesPanel
+    : public Panel
+    , public EventListener {
+public:
+    ResourcesPanel() { listen(&ResourcesPanel::on_key_event); }
+
+    void update(float delta_time) override {
+        if (!m_enabled) {
+            return;
+        }
+
+        ImGui::SetNextWindowSize(ImVec2(900, 400), ImGuiCond_FirstUseEver);
+        if (!ImGui::Begin("Resources", &m_enabled)) {
+            ImGui::End();
+            return;
+        }
+
+        auto records = g_resources.load_records();
+        const auto total = g_resources.total_stats();
+        const auto requests = total.hits + total.misses;
+        const auto redundant_count =
+            std::ranges::count_if(records, &ResourceLoadRecord::is_redundant);
+        float total_ms = 0.f;
+        for (const auto& record : records) {
+            total_ms += record.total_ms();
+        }
+        ImGui::Text(
+            "%zu loads, %.1f ms, %td redundant | %llu hits, %llu misses "
+            "(%.1f%% hit ratio) | %.1f MiB cached",
+            records.size(),
+            total_ms,
+            redundant_count,
+            static_cast<unsigned long long>(total.hits),
+            static_cast<unsigned long long>(total.misses),
+            requests > 0 ? 100.0 * double(total.hits) / double(requests) : 0.0,
+            double(total.bytes) / (1024.0 * 1024.0)
+        );
+
+        constexpr auto table_flags =
+            ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable |
+            ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+            ImGuiTableFlags_ScrollY;
+        if (ImGui::BeginTable("Loads", column_count, table_flags)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Path");
+            ImGui::TableSetupColumn("Type");
+            ImGui::TableSetupColumn("Call site");
+            ImGui::TableSetupColumn("Resolve ms");
+            ImGui::TableSetupColumn("I/O ms");
+            ImGui::TableSetupColumn("Decode ms");
+            ImGui::TableSetupColumn("Upload ms");
+            ImGui::TableSetupColumn(
+                "Total ms",
+                ImGuiTableColumnFlags_DefaultSort |
+                    ImGuiTableColumnFlags_PreferSortDescending
+            );
+            ImGui::TableSetupColumn("Read KiB");
+            ImGui::TableSetupColumn("Decoded KiB");
+            ImGui::TableSetupColumn("Hits");
+            ImGui::TableHeadersRow();
+
+            sort(records, ImGui::TableGetSortSpecs());
+            for (const auto& record : records) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                // Highlight resources loaded more than once
+                if (record.is_redundant) {
+                    ImGui::TextColored(
+                        ImVec4(1.f, 0.6f, 0.2f, 1.f), "%s", record.path.c_str()
+                    );
+                }
+                else {
+                    ImGui::TextUnformatted(record.path.c_str());
+                }
+                ImGui::TableNextColumn();
+                ImGui::Text(
+                    "%s%s%s",
+                    record.type.c_str(),
+                    record.is_async ? " (async)" : "",
+                    record.from_archive ? " (kpak)" : ""
+                );
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(record.call_site.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", record.resolve_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", record.io_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", record.decode_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", record.upload_ms);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", record.total_ms());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", double(record.bytes_read) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", double(record.decoded_bytes) / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text(
+                    "%llu", static_cast<unsigned long long>(record.hits)
+                );
+            }
+            ImGui::EndTable();
+        }
+        ImGui::End();
+    }
+
+    void on_key_event(const KeyboardKeyEvent& event) {
+        if (event.key == KeyboardKey::F3 &&
+            event.action == InputAction::Release) {
+            set_enabled(!m_enabled);
+        }
+    }
+
+private:
+    static constexpr int column_count = 11;
+
+private:
+    //! Sorts records by the sorted column of the table, records are kept in
+    //! load order if no column is sorted.
+    static void sort(
+        std::vector<ResourceLoadRecord>& records,
+        const ImGuiTableSortSpecs* sort_specs_ptr
+    ) {
+        if (sort_specs_ptr == nullptr || sort_specs_ptr->SpecsCount == 0) {
+            return;
+        }
+        const auto& spec = sort_specs_ptr->Specs[0];
+        const auto less = [&](const ResourceLoadRecord& a,
+                              const ResourceLoadRecord& b) {
+            switch (spec.ColumnIndex) {
+            case 0: return a.path < b.path;
+            case 1: return a.type < b.type;
+            case 2: return a.call_site < b.call_site;
+            case 3: return a.resolve_ms < b.resolve_ms;
+            case 4: return a.io_ms < b.io_ms;
+            case 5: return a.decode_ms < b.decode_ms;
+            case 6: return a.upload_ms < b.upload_ms;
+            case 8: return a.bytes_read < b.bytes_read;
+            case 9: return a.decoded_bytes < b.decoded_bytes;
+            case 10: return a.hits < b.hits;
+            default: return a.total_ms() < b.total_ms();
+            }
+        };
+        if (spec.SortDirection == ImGuiSortDirection_Descending) {
+            std::ranges::stable_sort(records, [&](const auto& a, const auto& b) {
+                return less(b, a);
+            });
+        }
+        else {
+            std::ranges::stable_sort(records, less);
+        }
+    }
+};
+
+} // namespace kzn
@@ -2,6 +2,9 @@
 
 #include "event_manager.hpp"
 
+#include <string>
+#include <typeindex>
+
 namespace kzn {
 
 //! Swapchain resize event, emitted when the Vulkan swapchain is recreated due
@@ -12,4 +15,31 @@ struct SwapchainResizeEvent : Event {};
 //! initializing.
 struct EditorInitEvent : Event {};
 
+//! Resource loaded event, emitted on the main thread by
+//! `ResourceCache::update` when a resource requested with
+//! `ResourceCache::load_async` finished loading or failed to load.
+struct ResourceLoadedEvent : Event {
+    std::string path;
+    std::type_index type;
+    bool success;
+};
+
+//! Resource reloaded event, emitted on the main thread by
+//! `ResourceCache::update` after a cached resource was loaded again in place
+//! because its file changed.
+struct ResourceReloadedEvent : Event {
+    //! Resolved path of the resource file.
+    std::string path;
+    std::type_index type;
+    const void* resource_ptr;
+
+    //! The reloaded resource if it's of type T, otherwise nullptr.
+    template<typename T>
+    [[nodiscard]]
+    const T* as() const {
+        return (type == typeid(T)) ? static_cast<const T*>(resource_ptr)
+                                   : nullptr;
+    }
+};
+
 } // namespace kzn
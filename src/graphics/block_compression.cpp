@@ -0,0 +1,402 @@
+#include "block_compression.hpp"
+
+#include "core/assert.hpp"
+#include "core/job_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace kzn::bc {
+
+namespace {
+
+constexpr std::size_t pixel_count = 16;
+
+template<std::size_t N>
+using Color = std::array<float, N>;
+
+//! Ends of the segment through the first N channels of the block pixels along
+//! their principal axis.
+template<std::size_t N>
+std::pair<Color<N>, Color<N>> principal_endpoints(const Block& block) {
+    Color<N> mean{};
+    Color<N> min_color;
+    Color<N> max_color;
+    min_color.fill(255.f);
+    max_color.fill(0.f);
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+        for (std::size_t c = 0; c < N; ++c) {
+            const float value = block[i * 4 + c];
+            mean[c] += value;
+            min_color[c] = std::min(min_color[c], value);
+            max_color[c] = std::max(max_color[c], value);
+        }
+    }
+    for (auto& value : mean) {
+        value /= float(pixel_count);
+    }
+
+    std::array<Color<N>, N> covariance{};
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+        Color<N> delta;
+        for (std::size_t c = 0; c < N; ++c) {
+            delta[c] = block[i * 4 + c] - mean[c];
+        }
+        for (std::size_t r = 0; r < N; ++r) {
+            for (std::size_t c = 0; c < N; ++c) {
+                covariance[r][c] += delta[r] * delta[c];
+            }
+        }
+    }
+
+    // Power iteration starting from the bounding box diagonal
+    Color<N> axis;
+    for (std::size_t c = 0; c < N; ++c) {
+        axis[c] = max_color[c] - min_color[c];
+    }
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        Color<N> next{};
+        for (std::size_t r = 0; r < N; ++r) {
+            for (std::size_t c = 0; c < N; ++c) {
+                next[r] += covariance[r][c] * axis[c];
+            }
+        }
+        float length = 0.f;
+        for (float value : next) {
+            length += value * value;
+        }
+        // Flat block
+        if (length < 1e-6f) {
+            break;
+        }
+        length = std::sqrt(length);
+        for (std::size_t c = 0; c < N; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float axis_length = 0.f;
+    for (float value : axis) {
+        axis_length += value * value;
+    }
+    if (axis_length < 1e-6f) {
+        return {mean, mean};
+    }
+
+    float min_t = std::numeric_limits<float>::max();
+    float max_t = std::numeric_limits<float>::lowest();
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+        float t = 0.f;
+        for (std::size_t c = 0; c < N; ++c) {
+            t += (block[i * 4 + c] - mean[c]) * axis[c];
+        }
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+    // Axis isn't normalized if the iteration stopped early
+    min_t /= axis_length;
+    max_t /= axis_length;
+
+    Color<N> low;
+    Color<N> high;
+    for (std::size_t c = 0; c < N; ++c) {
+        low[c] = std::clamp(mean[c] + axis[c] * min_t, 0.f, 255.f);
+        high[c] = std::clamp(mean[c] + axis[c] * max_t, 0.f, 255.f);
+    }
+    return {low, high};
+}
+
+//! Index of the palette color closest to a pixel, in the first N channels.
+template<std::size_t N, std::size_t P>
+std::uint32_t closest_index(
+    const Block& block,
+    std::size_t pixel,
+    const std::array<std::array<int, 4>, P>& palette
+) {
+    std::uint32_t best_index = 0;
+    int best_error = std::numeric_limits<int>::max();
+    for (std::size_t p = 0; p < P; ++p) {
+        int error = 0;
+        for (std::size_t c = 0; c < N; ++c) {
+            const int delta = int(block[pixel * 4 + c]) - palette[p][c];
+            error += delta * delta;
+        }
+        if (error < best_error) {
+            best_error = error;
+            best_index = std::uint32_t(p);
+        }
+    }
+    return best_index;
+}
+
+std::uint16_t to_rgb565(const Color<3>& color) {
+    const auto quantize = [](float value, float max) {
+        return std::uint16_t(std::lround(value * max / 255.f));
+    };
+    return std::uint16_t(
+        (quantize(color[0], 31.f) << 11) | (quantize(color[1], 63.f) << 5) |
+        quantize(color[2], 31.f)
+    );
+}
+
+std::array<int, 4> from_rgb565(std::uint16_t color) {
+    const int r = (color >> 11) & 31;
+    const int g = (color >> 5) & 63;
+    const int b = color & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+void write_le(std::byte* out_ptr, std::uint64_t value, std::size_t byte_count) {
+    for (std::size_t i = 0; i < byte_count; ++i) {
+        out_ptr[i] = std::byte(value >> (8 * i));
+    }
+}
+
+//! Writes bit fields from the least significant bit of a 128 bit block.
+class BitWriter {
+public:
+    void write(std::uint64_t value, std::size_t bit_count) {
+        for (std::size_t i = 0; i < bit_count; ++i, ++m_position) {
+            const std::uint64_t bit = (value >> i) & 1;
+            m_bits[m_position / 64] |= bit << (m_position % 64);
+        }
+    }
+
+    void store(std::byte* out_ptr) const {
+        KZN_ASSERT_MSG(m_position == 128, "Incomplete block");
+        write_le(out_ptr, m_bits[0], 8);
+        write_le(out_ptr + 8, m_bits[1], 8);
+    }
+
+private:
+    std::array<std::uint64_t, 2> m_bits{};
+    std::size_t m_position = 0;
+};
+
+//! BC7 endpoint with 7 bits per channel and a shared least significant bit.
+struct Bc7Endpoint {
+    std::array<std::uint32_t, 4> channels;
+    std::uint32_t p_bit;
+
+    [[nodiscard]]
+    std::array<int, 4> expand() const {
+        std::array<int, 4> color;
+        for (std::size_t c = 0; c < 4; ++c) {
+            color[c] = int((channels[c] << 1) | p_bit);
+        }
+        return color;
+    }
+};
+
+Bc7Endpoint quantize_bc7_endpoint(const Color<4>& color) {
+    Bc7Endpoint best{};
+    float best_error = std::numeric_limits<float>::max();
+    for (std::uint32_t p_bit = 0; p_bit < 2; ++p_bit) {
+        Bc7Endpoint endpoint{{}, p_bit};
+        float error = 0.f;
+        for (std::size_t c = 0; c < 4; ++c) {
+            endpoint.channels[c] = std::uint32_t(
+                std::clamp(std::lround((color[c] - float(p_bit)) / 2.f), 0l, 127l)
+            );
+            const float delta =
+                float((endpoint.channels[c] << 1) | p_bit) - color[c];
+            error += delta * delta;
+        }
+        if (error < best_error) {
+            best_error = error;
+            best = endpoint;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+void encode_bc1(const Block& block, std::byte* out_ptr) {
+    const auto [low, high] = principal_endpoints<3>(block);
+    std::uint16_t color0 = to_rgb565(high);
+    std::uint16_t color1 = to_rgb565(low);
+    // color0 > color1 selects the 4 color mode
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    std::uint32_t indices = 0;
+    // Equal endpoints decode as 3 color mode, index 0 is still color0
+    if (color0 != color1) {
+        const auto c0 = from_rgb565(color0);
+        const auto c1 = from_rgb565(color1);
+        std::array<std::array<int, 4>, 4> palette{c0, c1};
+        for (std::size_t c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+            palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+        }
+        for (std::size_t i = 0; i < pixel_count; ++i) {
+            indices |= closest_index<3>(block, i, palette) << (2 * i);
+        }
+    }
+
+    write_le(out_ptr, color0, 2);
+    write_le(out_ptr + 2, color1, 2);
+    write_le(out_ptr + 4, indices, 4);
+}
+
+void encode_bc4(const Block& block, std::size_t channel, std::byte* out_ptr) {
+    int min_value = 255;
+    int max_value = 0;
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+        min_value = std::min(min_value, int(block[i * 4 + channel]));
+        max_value = std::max(max_value, int(block[i * 4 + channel]));
+    }
+
+    std::uint64_t indices = 0;
+    // Equal endpoints decode as 6 value mode, index 0 is still the value
+    if (min_value != max_value) {
+        // value0 > value1 selects the 8 value mode
+        std::array<int, 8> palette{max_value, min_value};
+        for (int i = 2; i < 8; ++i) {
+            palette[i] = ((8 - i) * max_value + (i - 1) * min_value) / 7;
+        }
+        for (std::size_t i = 0; i < pixel_count; ++i) {
+            const int value = block[i * 4 + channel];
+            std::uint64_t best_index = 0;
+            for (std::uint64_t p = 1; p < palette.size(); ++p) {
+                if (std::abs(palette[p] - value) <
+                    std::abs(palette[best_index] - value)) {
+                    best_index = p;
+                }
+            }
+            indices |= best_index << (3 * i);
+        }
+    }
+
+    out_ptr[0] = std::byte(max_value);
+    out_ptr[1] = std::byte(min_value);
+    write_le(out_ptr + 2, indices, 6);
+}
+
+void encode_bc3(const Block& block, std::byte* out_ptr) {
+    encode_bc4(block, 3, out_ptr);
+    encode_bc1(block, out_ptr + 8);
+}
+
+void encode_bc5(const Block& block, std::byte* out_ptr) {
+    encode_bc4(block, 0, out_ptr);
+    encode_bc4(block, 1, out_ptr + 8);
+}
+
+void encode_bc7(const Block& block, std::byte* out_ptr) {
+    constexpr std::array<int, 16> weights = {
+        0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+    };
+
+    const auto [low, high] = principal_endpoints<4>(block);
+    auto endpoint0 = quantize_bc7_endpoint(low);
+    auto endpoint1 = quantize_bc7_endpoint(high);
+
+    const auto e0 = endpoint0.expand();
+    const auto e1 = endpoint1.expand();
+    std::array<std::array<int, 4>, 16> palette;
+    for (std::size_t p = 0; p < palette.size(); ++p) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            palette[p][c] =
+                ((64 - weights[p]) * e0[c] + weights[p] * e1[c] + 32) >> 6;
+        }
+    }
+    std::array<std::uint32_t, pixel_count> indices;
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+        indices[i] = closest_index<4>(block, i, palette);
+    }
+
+    // The first index is stored without its most significant bit, which must
+    // be 0, flip the endpoints otherwise
+    if (indices[0] >= 8) {
+        std::swap(endpoint0, endpoint1);
+        for (auto& index : indices) {
+            index = 15 - index;
+        }
+    }
+
+    BitWriter writer;
+    // Mode 6
+    writer.write(1 << 6, 7);
+    for (std::size_t c = 0; c < 4; ++c) {
+        writer.write(endpoint0.channels[c], 7);
+        writer.write(endpoint1.channels[c], 7);
+    }
+    writer.write(endpoint0.p_bit, 1);
+    writer.write(endpoint1.p_bit, 1);
+    writer.write(indices[0], 3);
+    for (std::size_t i = 1; i < pixel_count; ++i) {
+        writer.write(indices[i], 4);
+    }
+    writer.store(out_ptr);
+}
+
+std::vector<std::byte> compress(
+    TextureFormat format,
+    std::span<const std::uint8_t> rgba,
+    std::uint32_t width,
+    std::uint32_t height
+) {
+    KZN_ASSERT_MSG(
+        rgba.size() == std::size_t{width} * height * 4,
+        "Image size doesn't match its extent"
+    );
+    if (!is_block_compressed(format)) {
+        const auto* bytes_ptr = reinterpret_cast<const std::byte*>(rgba.data());
+        return {bytes_ptr, bytes_ptr + rgba.size()};
+    }
+
+    void (*encode_fn)(const Block&, std::byte*) = nullptr;
+    switch (format) {
+        case TextureFormat::Bc1: encode_fn = encode_bc1; break;
+        case TextureFormat::Bc3: encode_fn = encode_bc3; break;
+        case TextureFormat::Bc5: encode_fn = encode_bc5; break;
+        case TextureFormat::Bc7: encode_fn = encode_bc7; break;
+        case TextureFormat::Rgba8: break;
+    }
+
+    const std::size_t blocks_x = (width + 3) / 4;
+    const std::size_t blocks_y = (height + 3) / 4;
+    const std::size_t block_size = block_byte_size(format);
+    std::vector<std::byte> compressed(blocks_x * blocks_y * block_size);
+
+    const auto encode_row = [&](std::size_t block_y) {
+        Block block;
+        for (std::size_t block_x = 0; block_x < blocks_x; ++block_x) {
+            for (std::size_t y = 0; y < 4; ++y) {
+                const std::size_t src_y =
+                    std::min<std::size_t>(block_y * 4 + y, height - 1);
+                for (std::size_t x = 0; x < 4; ++x) {
+                    const std::size_t src_x =
+                        std::min<std::size_t>(block_x * 4 + x, width - 1);
+                    std::memcpy(
+                        &block[(y * 4 + x) * 4],
+                        &rgba[(src_y * width + src_x) * 4],
+                        4
+                    );
+                }
+            }
+            encode_fn(
+                block,
+                compressed.data() + (block_y * blocks_x + block_x) * block_size
+            );
+        }
+    };
+
+    if (JobSystem::exists()) {
+        JobSystem::singleton().parallel_for(0, blocks_y, encode_row);
+    }
+    else {
+        for (std::size_t block_y = 0; block_y < blocks_y; ++block_y) {
+            encode_row(block_y);
+        }
+    }
+    return compressed;
+}
+
+} // namespace kzn::bc
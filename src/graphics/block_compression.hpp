@@ -0,0 +1,44 @@
+#pragma once
+
+#include "graphics/texture_format.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//! CPU encoders of BCn block compressed formats.
+namespace kzn::bc {
+
+//! 4x4 RGBA8 pixels, row major.
+using Block = std::array<std::uint8_t, 4 * 4 * 4>;
+
+//! Encodes RGB in 8 bytes, alpha is ignored.
+void encode_bc1(const Block& block, std::byte* out_ptr);
+
+//! Encodes one channel in 8 bytes.
+void encode_bc4(const Block& block, std::size_t channel, std::byte* out_ptr);
+
+//! Encodes alpha as BC4 and RGB as BC1 in 16 bytes.
+void encode_bc3(const Block& block, std::byte* out_ptr);
+
+//! Encodes red and green as BC4 in 16 bytes.
+void encode_bc5(const Block& block, std::byte* out_ptr);
+
+//! Encodes RGBA in 16 bytes using BC7 mode 6 only, a single subset with 4 bit
+//! indices, which is enough for most color textures.
+void encode_bc7(const Block& block, std::byte* out_ptr);
+
+//! Compresses a whole RGBA8 image, on the job system if there's one. Partial
+//! blocks at the edges are padded by repeating the last row and column.
+//! \return Pixels in \p format, copied as is for uncompressed formats.
+[[nodiscard]]
+std::vector<std::byte> compress(
+    TextureFormat format,
+    std::span<const std::uint8_t> rgba,
+    std::uint32_t width,
+    std::uint32_t height
+);
+
+} // namespace kzn::bc
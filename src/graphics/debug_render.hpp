@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/cvar.hpp"
 #include "core/type.hpp"
 #include "graphics/renderer.hpp"
 #include "math/types.hpp"
@@ -14,6 +15,8 @@ struct LineDraw {
     Vec3 color;
 };
 
+inline CVar<bool> cvar_r_debug{"r_debug", false, "Render debug geometry"};
+
 //! An immediate debug render helper class to draw basic geometry on the screen.
 class DebugRender {
 public:
@@ -32,7 +35,17 @@ public:
     // Dtor
     ~DebugRender() = default;
 
+    //! Whether draw calls are being recorded. Draws issued while disabled are
+    //! discarded.
+    [[nodiscard]]
+    bool is_enabled() const {
+        return cvar_r_debug.get();
+    }
+
     void draw_rect(Vec2 position, Vec2 size, Vec3 color = Vec3{1.f, 1.f, 1.f}) {
+        if (!is_enabled()) {
+            return;
+        }
         const Vec2 half_size = size / 2.f;
 
         m_line_draw_list.insert(
@@ -59,6 +72,9 @@ public:
         Vec2 position2,
         Vec3 color = Vec3{1.f, 1.f, 1.f}
     ) {
+        if (!is_enabled()) {
+            return;
+        }
         m_line_draw_list.insert(
             m_line_draw_list.end(),
             {LineDraw{position1, color}, LineDraw{position2, color}}
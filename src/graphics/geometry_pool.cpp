@@ -0,0 +1,127 @@
+#include "geometry_pool.hpp"
+
+#include "core/assert.hpp"
+#include "core/log.hpp"
+
+#include <algorithm>
+#include <optional>
+
+namespace kzn {
+
+namespace {
+
+//! Offset of a range of \p count elements, empty ranges don't take space.
+[[nodiscard]]
+std::optional<std::size_t> allocate_range(
+    FreeListAllocator& allocator,
+    std::size_t count
+) {
+    return count == 0 ? std::optional<std::size_t>{0} : allocator.allocate(count);
+}
+
+} // namespace
+
+GeometryPool::GeometryPool(vk::Device& device, std::size_t vertex_stride)
+    : m_device_ptr{&device}
+    , m_vertex_stride{vertex_stride}
+{
+}
+
+GeometryRange GeometryPool::allocate(
+    const void* vertices,
+    std::size_t vertex_count,
+    std::span<const std::uint32_t> indices
+) {
+    // First block with room for both the vertices and the indices
+    std::optional<std::size_t> block_idx_opt;
+    std::size_t base_vertex = 0;
+    std::size_t first_index = 0;
+    for (std::size_t i = 0; i < m_blocks.size() && !block_idx_opt; ++i) {
+        auto& block = m_blocks[i];
+        const auto base_vertex_opt = allocate_range(block.vertices, vertex_count);
+        if (!base_vertex_opt.has_value()) {
+            continue;
+        }
+        const auto first_index_opt = allocate_range(block.indices, indices.size());
+        if (!first_index_opt.has_value()) {
+            block.vertices.free(*base_vertex_opt, vertex_count);
+            continue;
+        }
+        block_idx_opt = i;
+        base_vertex = *base_vertex_opt;
+        first_index = *first_index_opt;
+    }
+
+    if (!block_idx_opt.has_value()) {
+        const auto block_vertices = std::max(block_vertex_count, vertex_count);
+        const auto block_indices = std::max(block_index_count, indices.size());
+        Log::debug(
+            "Geometry pool block {} created ({} vertices, {} indices)",
+            m_blocks.size(),
+            block_vertices,
+            block_indices
+        );
+        auto& block = m_blocks.emplace_back(Block{
+            .vtx_buffer = vk::VertexBuffer(*m_device_ptr, m_vertex_stride * block_vertices),
+            .idx_buffer = vk::IndexBuffer(*m_device_ptr, sizeof(std::uint32_t) * block_indices),
+            .vertices = FreeListAllocator(block_vertices),
+            .indices = FreeListAllocator(block_indices),
+        });
+        block_idx_opt = m_blocks.size() - 1;
+        base_vertex = *allocate_range(block.vertices, vertex_count);
+        first_index = *allocate_range(block.indices, indices.size());
+    }
+
+    auto& block = m_blocks[*block_idx_opt];
+    if (vertex_count > 0) {
+        block.vtx_buffer.upload(
+            vertices,
+            base_vertex * m_vertex_stride,
+            vertex_count * m_vertex_stride
+        );
+    }
+    if (!indices.empty()) {
+        block.idx_buffer.upload(
+            indices.data(),
+            static_cast<std::uint32_t>(first_index),
+            static_cast<std::uint32_t>(indices.size())
+        );
+    }
+    return GeometryRange{
+        .block = static_cast<std::uint32_t>(*block_idx_opt),
+        .base_vertex = static_cast<std::uint32_t>(base_vertex),
+        .vertex_count = static_cast<std::uint32_t>(vertex_count),
+        .first_index = static_cast<std::uint32_t>(first_index),
+        .index_count = static_cast<std::uint32_t>(indices.size()),
+    };
+}
+
+void GeometryPool::free(const GeometryRange& range) {
+    KZN_ASSERT_MSG(range.block < m_blocks.size(), "Range isn't from this pool");
+    // The pool may be gone by the time frames in flight are done, its buffers
+    // are then freed whole
+    m_device_ptr->main_deletion_queue().enqueue(
+        [pool_weak_ptr = weak_from_this(), range]() {
+            const auto pool_ptr = pool_weak_ptr.lock();
+            if (pool_ptr == nullptr) {
+                return;
+            }
+            auto& block = pool_ptr->m_blocks[range.block];
+            block.vertices.free(range.base_vertex, range.vertex_count);
+            block.indices.free(range.first_index, range.index_count);
+        }
+    );
+}
+
+std::shared_ptr<GeometryPool> GeometryPoolCache::get(std::size_t vertex_stride) {
+    std::lock_guard lock{m_mutex};
+    auto& pool_weak_ptr = m_pools[vertex_stride];
+    if (auto pool_ptr = pool_weak_ptr.lock()) {
+        return pool_ptr;
+    }
+    auto pool_ptr = std::make_shared<GeometryPool>(*m_device_ptr, vertex_stride);
+    pool_weak_ptr = pool_ptr;
+    return pool_ptr;
+}
+
+} // namespace kzn
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "core/free_list_allocator.hpp"
+#include "vk/buffer.hpp"
+#include "vk/device.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+//! Vertices and indices of a mesh in the buffers of a geometry pool.
+struct GeometryRange {
+    //! Block whose buffers hold the mesh.
+    std::uint32_t block = 0;
+    //! Added to the indices of the mesh when drawing.
+    std::uint32_t base_vertex = 0;
+    std::uint32_t vertex_count = 0;
+    std::uint32_t first_index = 0;
+    std::uint32_t index_count = 0;
+};
+
+//! Vertex and index buffers shared by the meshes of a vertex format, so that
+//! drawing them doesn't rebind buffers between meshes. Meshes get ranges of a
+//! few large blocks, a new block is only created when a mesh doesn't fit in
+//! the free ranges of the existing ones.
+class GeometryPool : public std::enable_shared_from_this<GeometryPool> {
+public:
+    //! Buffers bound once for all the meshes they hold.
+    struct Block {
+        vk::VertexBuffer vtx_buffer;
+        vk::IndexBuffer idx_buffer;
+        FreeListAllocator vertices;
+        FreeListAllocator indices;
+    };
+
+    //! Capacity of a block, unless a mesh needs a larger one.
+    static constexpr std::size_t block_vertex_count = 1 << 20;
+    static constexpr std::size_t block_index_count = 1 << 22;
+
+public:
+    // Ctor
+    GeometryPool(vk::Device& device, std::size_t vertex_stride);
+    // Copy
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+    // Move
+    GeometryPool(GeometryPool&&) = delete;
+    GeometryPool& operator=(GeometryPool&&) = delete;
+    // Dtor
+    ~GeometryPool() = default;
+
+    //! Allocates a range for a mesh and uploads its geometry to it.
+    //! \param vertices Vertices of `vertex_stride()` bytes each.
+    [[nodiscard]]
+    GeometryRange allocate(
+        const void* vertices,
+        std::size_t vertex_count,
+        std::span<const std::uint32_t> indices
+    );
+
+    //! Gives back a range once the frames in flight that may still draw it
+    //! are done.
+    void free(const GeometryRange& range);
+
+    [[nodiscard]]
+    const Block& block(std::size_t block_idx) const {
+        return m_blocks[block_idx];
+    }
+    [[nodiscard]]
+    std::size_t block_count() const {
+        return m_blocks.size();
+    }
+
+    [[nodiscard]]
+    std::size_t vertex_stride() const {
+        return m_vertex_stride;
+    }
+
+private:
+    vk::Device* m_device_ptr;
+    std::size_t m_vertex_stride;
+    std::vector<Block> m_blocks;
+};
+
+//! Geometry pools of a device, one per vertex stride, created once and shared
+//! by every mesh of that stride while any of them is alive. Owned by the
+//! renderer, so pools aren't shared across devices.
+class GeometryPoolCache {
+public:
+    // Ctor
+    explicit GeometryPoolCache(vk::Device& device)
+        : m_device_ptr{&device}
+    {}
+    // Copy
+    GeometryPoolCache(const GeometryPoolCache&) = delete;
+    GeometryPoolCache& operator=(const GeometryPoolCache&) = delete;
+    // Move
+    GeometryPoolCache(GeometryPoolCache&&) = delete;
+    GeometryPoolCache& operator=(GeometryPoolCache&&) = delete;
+    // Dtor
+    ~GeometryPoolCache() = default;
+
+    //! Pool of vertices of \p vertex_stride bytes, created if no mesh uses it.
+    [[nodiscard]]
+    std::shared_ptr<GeometryPool> get(std::size_t vertex_stride);
+
+private:
+    vk::Device* m_device_ptr;
+    std::mutex m_mutex;
+    std::unordered_map<std::size_t, std::weak_ptr<GeometryPool>> m_pools;
+};
+
+} // namespace kzn
@@ -0,0 +1,315 @@
+#include "gltf.hpp"
+
+#include "core/log.hpp"
+
+#include <fastgltf/glm_element_traits.hpp>
+#include <fastgltf/tools.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+namespace kzn::gltf {
+
+namespace {
+
+//! Elements of an accessor read in place from its buffer.
+struct StridedBytes {
+    const std::byte* data_ptr;
+    std::size_t stride;
+};
+
+//! Elements of an accessor in its buffer, or nullopt if they can't be read
+//! in place and need fastgltf to convert them.
+[[nodiscard]]
+std::optional<StridedBytes> strided_bytes(
+    const fastgltf::Asset& asset,
+    const fastgltf::Accessor& accessor
+) {
+    if (accessor.sparse.has_value() || !accessor.bufferViewIndex.has_value()) {
+        return std::nullopt;
+    }
+    const auto& buffer_view = asset.bufferViews[*accessor.bufferViewIndex];
+    const auto view_bytes = buffer_view_bytes(asset, *accessor.bufferViewIndex);
+    const std::size_t element_size =
+        fastgltf::getElementByteSize(accessor.type, accessor.componentType);
+    const std::size_t stride = buffer_view.byteStride.has_value()
+        ? *buffer_view.byteStride
+        : element_size;
+
+    if (accessor.count == 0) {
+        return StridedBytes{view_bytes.data(), stride};
+    }
+    if (accessor.byteOffset > view_bytes.size() ||
+        (accessor.count - 1) * stride + element_size >
+            view_bytes.size() - accessor.byteOffset) {
+        return std::nullopt;
+    }
+    return StridedBytes{view_bytes.data() + accessor.byteOffset, stride};
+}
+
+//! Float elements of \p type, which can be copied as is.
+[[nodiscard]]
+std::optional<StridedBytes> float_bytes(
+    const fastgltf::Asset& asset,
+    const fastgltf::Accessor* accessor_ptr,
+    fastgltf::AccessorType type
+) {
+    if (accessor_ptr == nullptr ||
+        accessor_ptr->componentType != fastgltf::ComponentType::Float ||
+        accessor_ptr->type != type) {
+        return std::nullopt;
+    }
+    return strided_bytes(asset, *accessor_ptr);
+}
+
+//! Accessor of a primitive attribute, or nullptr if the primitive doesn't
+//! have it or it doesn't have one element per vertex.
+[[nodiscard]]
+const fastgltf::Accessor* find_attribute(
+    const fastgltf::Asset& asset,
+    const fastgltf::Primitive& primitive,
+    std::string_view name,
+    std::size_t vertex_count
+) {
+    const auto it = primitive.findAttribute(name);
+    if (it == primitive.attributes.end()) {
+        return nullptr;
+    }
+    const auto& accessor = asset.accessors[it->accessorIndex];
+    if (accessor.count != vertex_count) {
+        Log::warning("Ignored attribute '{}' with wrong element count", name);
+        return nullptr;
+    }
+    return &accessor;
+}
+
+template<typename Index>
+void widen_indices(StridedBytes src, std::span<std::uint32_t> indices) {
+    if (std::is_same_v<Index, std::uint32_t> && src.stride == sizeof(Index)) {
+        std::memcpy(indices.data(), src.data_ptr, indices.size_bytes());
+        return;
+    }
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        Index index;
+        std::memcpy(&index, src.data_ptr + i * src.stride, sizeof(Index));
+        indices[i] = index;
+    }
+}
+
+//! Triangle list with positions, the only primitives the renderer draws.
+[[nodiscard]]
+bool is_drawable(const fastgltf::Primitive& primitive) {
+    return primitive.type == fastgltf::PrimitiveType::Triangles
+        && primitive.findAttribute("POSITION") != primitive.attributes.end();
+}
+
+} // namespace
+
+std::span<const std::byte> buffer_view_bytes(
+    const fastgltf::Asset& asset,
+    std::size_t buffer_view_idx
+) {
+    const auto& buffer_view = asset.bufferViews[buffer_view_idx];
+    const auto& buffer = asset.buffers[buffer_view.bufferIndex];
+
+    std::span<const std::byte> buffer_bytes;
+    if (const auto* array_ptr = std::get_if<fastgltf::sources::Array>(&buffer.data)) {
+        buffer_bytes = {array_ptr->bytes.data(), array_ptr->bytes.size()};
+    }
+    else if (const auto* vector_ptr = std::get_if<fastgltf::sources::Vector>(&buffer.data)) {
+        buffer_bytes = {vector_ptr->bytes.data(), vector_ptr->bytes.size()};
+    }
+    else if (const auto* byte_view_ptr = std::get_if<fastgltf::sources::ByteView>(&buffer.data)) {
+        buffer_bytes = {byte_view_ptr->bytes.data(), byte_view_ptr->bytes.size()};
+    }
+
+    if (buffer_view.byteOffset > buffer_bytes.size() ||
+        buffer_view.byteLength > buffer_bytes.size() - buffer_view.byteOffset) {
+        return {};
+    }
+    return buffer_bytes.subspan(buffer_view.byteOffset, buffer_view.byteLength);
+}
+
+void read_indices(
+    const fastgltf::Asset& asset,
+    const fastgltf::Accessor& accessor,
+    std::span<std::uint32_t> indices,
+    std::uint32_t base_vertex
+) {
+    const auto src_opt = strided_bytes(asset, accessor);
+    const auto component_type = accessor.componentType;
+    if (src_opt.has_value() && component_type == fastgltf::ComponentType::UnsignedInt) {
+        widen_indices<std::uint32_t>(*src_opt, indices);
+    }
+    else if (src_opt.has_value() && component_type == fastgltf::ComponentType::UnsignedShort) {
+        widen_indices<std::uint16_t>(*src_opt, indices);
+    }
+    else if (src_opt.has_value() && component_type == fastgltf::ComponentType::UnsignedByte) {
+        widen_indices<std::uint8_t>(*src_opt, indices);
+    }
+    else {
+        fastgltf::copyFromAccessor<std::uint32_t>(asset, accessor, indices.data());
+    }
+
+    if (base_vertex != 0) {
+        for (auto& index : indices) {
+            index += base_vertex;
+        }
+    }
+}
+
+void read_vertices(
+    const fastgltf::Asset& asset,
+    const fastgltf::Primitive& primitive,
+    std::span<Vertex3D> vertices
+) {
+    const std::size_t count = vertices.size();
+    const auto* position_ptr = find_attribute(asset, primitive, "POSITION", count);
+    const auto* normal_ptr = find_attribute(asset, primitive, "NORMAL", count);
+    const auto* uv_ptr = find_attribute(asset, primitive, "TEXCOORD_0", count);
+
+    using fastgltf::AccessorType;
+    const auto positions_opt = float_bytes(asset, position_ptr, AccessorType::Vec3);
+    const auto normals_opt = float_bytes(asset, normal_ptr, AccessorType::Vec3);
+    const auto uvs_opt = float_bytes(asset, uv_ptr, AccessorType::Vec2);
+
+    // Interleave every attribute that can be copied as is in one pass
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& vertex = vertices[i];
+        if (positions_opt.has_value()) {
+            std::memcpy(
+                &vertex.position,
+                positions_opt->data_ptr + i * positions_opt->stride,
+                sizeof(Vec3)
+            );
+        }
+        if (normals_opt.has_value()) {
+            std::memcpy(
+                &vertex.normal,
+                normals_opt->data_ptr + i * normals_opt->stride,
+                sizeof(Vec3)
+            );
+        }
+        if (uvs_opt.has_value()) {
+            std::memcpy(
+                &vertex.uv,
+                uvs_opt->data_ptr + i * uvs_opt->stride,
+                sizeof(Vec2)
+            );
+        }
+    }
+
+    // Normalized, quantized or sparse attributes need conversion
+    if (position_ptr != nullptr && !positions_opt.has_value()) {
+        fastgltf::iterateAccessorWithIndex<glm::vec3>(
+            asset,
+            *position_ptr,
+            [&vertices](glm::vec3 position, std::size_t idx) {
+                vertices[idx].position = position;
+            }
+        );
+    }
+    if (normal_ptr != nullptr && !normals_opt.has_value()) {
+        fastgltf::iterateAccessorWithIndex<glm::vec3>(
+            asset,
+            *normal_ptr,
+            [&vertices](glm::vec3 normal, std::size_t idx) {
+                vertices[idx].normal = normal;
+            }
+        );
+    }
+    if (uv_ptr != nullptr && !uvs_opt.has_value()) {
+        fastgltf::iterateAccessorWithIndex<glm::vec2>(
+            asset,
+            *uv_ptr,
+            [&vertices](glm::vec2 uv, std::size_t idx) {
+                vertices[idx].uv = uv;
+            }
+        );
+    }
+}
+
+MeshData read_mesh(
+    const fastgltf::Asset& asset,
+    const fastgltf::Mesh& mesh,
+    std::span<const std::shared_ptr<const MaterialData>> materials
+) {
+    const auto primitive_vertex_count = [&asset](const fastgltf::Primitive& primitive) {
+        return asset.accessors[primitive.findAttribute("POSITION")->accessorIndex].count;
+    };
+    const auto primitive_index_count = [&](const fastgltf::Primitive& primitive) {
+        return primitive.indicesAccessor.has_value()
+            ? asset.accessors[*primitive.indicesAccessor].count
+            : primitive_vertex_count(primitive);
+    };
+
+    // Size buffers once for all primitives
+    std::size_t vertex_count = 0;
+    std::size_t index_count = 0;
+    for (const auto& primitive : mesh.primitives) {
+        if (!is_drawable(primitive)) {
+            Log::warning(
+                "Skipped primitive of mesh '{}' that isn't a triangle list",
+                mesh.name.c_str()
+            );
+            continue;
+        }
+        vertex_count += primitive_vertex_count(primitive);
+        index_count += primitive_index_count(primitive);
+    }
+
+    MeshData mesh_data;
+    mesh_data.vertices.resize(vertex_count);
+    mesh_data.indices.resize(index_count);
+
+    std::size_t base_vertex = 0;
+    std::size_t first_index = 0;
+    for (const auto& primitive : mesh.primitives) {
+        if (!is_drawable(primitive)) {
+            continue;
+        }
+        const auto primitive_vertices = std::span{mesh_data.vertices}.subspan(
+            base_vertex, primitive_vertex_count(primitive)
+        );
+        const auto primitive_indices = std::span{mesh_data.indices}.subspan(
+            first_index, primitive_index_count(primitive)
+        );
+
+        read_vertices(asset, primitive, primitive_vertices);
+        if (primitive.indicesAccessor.has_value()) {
+            read_indices(
+                asset,
+                asset.accessors[*primitive.indicesAccessor],
+                primitive_indices,
+                static_cast<std::uint32_t>(base_vertex)
+            );
+        }
+        else {
+            std::iota(
+                primitive_indices.begin(),
+                primitive_indices.end(),
+                static_cast<std::uint32_t>(base_vertex)
+            );
+        }
+
+        const auto material_idx_opt = primitive.materialIndex;
+        mesh_data.submeshes.push_back(Submesh{
+            .index_offset = static_cast<std::uint32_t>(first_index),
+            .index_count = static_cast<std::uint32_t>(primitive_indices.size()),
+            .material_ptr =
+                (material_idx_opt.has_value() && *material_idx_opt < materials.size())
+                    ? materials[*material_idx_opt]
+                    : nullptr,
+        });
+
+        base_vertex += primitive_vertices.size();
+        first_index += primitive_indices.size();
+    }
+
+    return mesh_data;
+}
+
+} // namespace kzn::gltf
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "graphics/mesh.hpp"
+
+#include <fastgltf/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+//! Bulk import of glTF geometry.
+namespace kzn::gltf {
+
+//! Bytes of a buffer view, empty if its buffer isn't loaded in memory.
+[[nodiscard]]
+std::span<const std::byte> buffer_view_bytes(
+    const fastgltf::Asset& asset,
+    std::size_t buffer_view_idx
+);
+
+//! Reads an index accessor into \p indices, adding \p base_vertex to each.
+//! Unsigned indices are copied or widened in bulk, other accessors are
+//! converted element by element.
+void read_indices(
+    const fastgltf::Asset& asset,
+    const fastgltf::Accessor& accessor,
+    std::span<std::uint32_t> indices,
+    std::uint32_t base_vertex = 0
+);
+
+//! Reads the vertex attributes of a primitive into \p vertices in a single
+//! interleaving pass. Float attributes are copied straight from their buffers,
+//! normalized or sparse ones are converted element by element.
+void read_vertices(
+    const fastgltf::Asset& asset,
+    const fastgltf::Primitive& primitive,
+    std::span<Vertex3D> vertices
+);
+
+//! Reads every triangle primitive of a mesh as a submesh of one mesh.
+//! \param materials Materials by glTF material index, primitives with a
+//! material out of range get no material.
+[[nodiscard]]
+MeshData read_mesh(
+    const fastgltf::Asset& asset,
+    const fastgltf::Mesh& mesh,
+    std::span<const std::shared_ptr<const MaterialData>> materials = {}
+);
+
+} // namespace kzn::gltf
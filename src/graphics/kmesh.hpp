@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+//! Kazan cooked mesh (.kmesh) format, the optimized meshes of a scene with
+//! their levels of detail, produced by mesh_cooker. Blobs are stored as they
+//! are in memory, loading copies them without parsing vertices.
+//!
+//! \code
+//! Header
+//! MeshEntry[mesh_count]
+//! LodEntry[lod_count]            Levels of all meshes, each mesh first
+//! SubmeshEntry[submesh_count]    Submeshes of all levels
+//! MaterialEntry[material_count]
+//! Vertex3D[vertex_count]         Vertices of all meshes
+//! std::uint32_t[index_count]     Indices of all levels
+//! char[string_size]              Texture paths, relative to the .kmesh file
+//! \endcode
+//! \note All values are little endian.
+namespace kzn::kmesh {
+
+inline constexpr std::array<char, 4> magic = {'K', 'M', 'S', 'H'};
+inline constexpr std::uint32_t version = 1;
+
+//! Material index of submeshes without material.
+inline constexpr std::uint32_t no_material = std::numeric_limits<std::uint32_t>::max();
+
+struct Header {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    //! Hash of the source scene and cook options, to skip cooking unchanged
+    //! sources.
+    std::uint64_t source_hash;
+    std::uint32_t mesh_count;
+    std::uint32_t lod_count;
+    std::uint32_t submesh_count;
+    std::uint32_t material_count;
+    std::uint64_t vertex_count;
+    std::uint64_t index_count;
+    std::uint64_t string_size;
+};
+
+struct MeshEntry {
+    std::uint32_t first_vertex;
+    std::uint32_t vertex_count;
+    //! Levels of detail, the first one being the mesh itself.
+    std::uint32_t first_lod;
+    std::uint32_t lod_count;
+    //! Submeshes of each level, 0 if the mesh is drawn whole.
+    std::uint32_t submesh_count;
+    std::array<float, 3> bounds_min;
+    std::array<float, 3> bounds_max;
+};
+
+struct LodEntry {
+    std::uint32_t first_index;
+    std::uint32_t index_count;
+    std::uint32_t first_submesh;
+    //! Largest distance the surface moved from the mesh, in mesh units.
+    float error;
+};
+
+struct SubmeshEntry {
+    //! Relative to the first index of its level.
+    std::uint32_t index_offset;
+    std::uint32_t index_count;
+    std::uint32_t material;
+};
+
+//! Range of a texture path in the string section, empty if there's no
+//! texture.
+struct TextureRef {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct MaterialEntry {
+    //! Albedo, normal, metallic roughness and occlusion textures.
+    std::array<TextureRef, 4> textures;
+};
+
+static_assert(sizeof(Header) == 56);
+static_assert(sizeof(MeshEntry) == 44);
+static_assert(sizeof(LodEntry) == 16);
+static_assert(sizeof(SubmeshEntry) == 12);
+static_assert(sizeof(MaterialEntry) == 32);
+
+} // namespace kzn::kmesh
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "graphics/texture_format.hpp"
+
+#include <array>
+#include <cstdint>
+
+//! Kazan cooked texture (.ktex) format, GPU ready texture data produced by
+//! texture_cooker.
+//!
+//! \code
+//! Header
+//! Mip levels, largest first, tightly packed
+//! \endcode
+//! \note All values are little endian.
+namespace kzn::ktex {
+
+inline constexpr std::array<char, 4> magic = {'K', 'T', 'E', 'X'};
+inline constexpr std::uint32_t version = 1;
+
+//! Pixels are sRGB encoded color.
+inline constexpr std::uint32_t flag_srgb = 1;
+
+struct Header {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    //! Hash of the source image and cook options, to skip cooking unchanged
+    //! sources.
+    std::uint64_t source_hash;
+    TextureFormat format;
+    std::uint32_t flags;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t depth;
+    std::uint32_t mip_levels;
+};
+
+static_assert(sizeof(Header) == 40);
+
+} // namespace kzn::ktex
@@ -0,0 +1,89 @@
+#include "material3d.hpp"
+
+namespace kzn {
+
+namespace {
+
+//! Image of a material texture. Decoded images are uploaded in \p format,
+//! cooked textures carry their own format and mips.
+[[nodiscard]]
+vk::Image material_image(
+    vk::Device& device,
+    const TextureData& texture,
+    VkFormat format
+) {
+    if (texture.format != TextureFormat::Rgba8 || texture.mip_levels > 1) {
+        return create_texture_image(device, texture);
+    }
+    auto image = vk::Image(device, texture.vk_extent(), format);
+    image.upload(texture.bytes);
+    return image;
+}
+
+[[nodiscard]]
+std::shared_ptr<Material3D> create_material3d(
+    vk::Device& device,
+    const MaterialData& material_data
+) {
+    auto material_ptr = std::make_shared<Material3D>(Material3D{
+        .albedo_image = material_image(
+            device,
+            *material_data.albedo_ptr,
+            VK_FORMAT_R8G8B8A8_SRGB
+        ),
+        .normal_image = material_image(
+            device,
+            *material_data.normal_ptr,
+            VK_FORMAT_R8G8B8A8_UNORM
+        ),
+        .metallic_roughness_image = material_image(
+            device,
+            *material_data.metallic_roughness_ptr,
+            VK_FORMAT_R8G8B8A8_UNORM
+        ),
+        .occlusion_image = material_image(
+            device,
+            *material_data.occlusion_ptr,
+            VK_FORMAT_R8G8B8A8_UNORM
+        ),
+        .dset = vk::DescriptorSet(
+            device.dset_allocator().allocate(
+                device.dset_layout_cache().layout({
+                    vk::sampler_binding(0),
+                    vk::sampler_binding(1),
+                    vk::sampler_binding(2),
+                    vk::sampler_binding(3),
+                })
+            )
+        ),
+    });
+    material_ptr->dset.update({
+        material_ptr->albedo_image.info(),
+        material_ptr->normal_image.info(),
+        material_ptr->metallic_roughness_image.info(),
+        material_ptr->occlusion_image.info(),
+    });
+    return material_ptr;
+}
+
+} // namespace
+
+std::shared_ptr<Material3D> Material3DCache::get(
+    const std::shared_ptr<const MaterialData>& material_data_ptr
+) {
+    std::lock_guard lock{m_mutex};
+    auto it = m_materials.find(material_data_ptr);
+    if (it != m_materials.end()) {
+        if (auto material_ptr = it->second.lock()) {
+            return material_ptr;
+        }
+    }
+    std::erase_if(m_materials, [](const auto& entry) {
+        return entry.first.expired() || entry.second.expired();
+    });
+    auto material_ptr = create_material3d(*m_device_ptr, *material_data_ptr);
+    m_materials.insert_or_assign(material_data_ptr, material_ptr);
+    return material_ptr;
+}
+
+} // namespace kzn
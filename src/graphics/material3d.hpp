@@ -4,13 +4,34 @@
 #include "vk/dset.hpp"
 #include "vk/image.hpp"
 
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace kzn {
 
+//! Textures of a material. Textures are shared, materials of the same scene
+//! using the same image point to the same texture.
 struct MaterialData {
-    std::optional<TextureData> albedo_opt;
-    std::optional<TextureData> normal_opt;
-    std::optional<TextureData> metallic_roughness_opt;
-    std::optional<TextureData> occlusion_opt;
+    std::shared_ptr<const TextureData> albedo_ptr = nullptr;
+    std::shared_ptr<const TextureData> normal_ptr = nullptr;
+    std::shared_ptr<const TextureData> metallic_roughness_ptr = nullptr;
+    std::shared_ptr<const TextureData> occlusion_ptr = nullptr;
+
+    //! Size of all decoded textures in bytes.
+    [[nodiscard]]
+    std::size_t byte_size() const {
+        std::size_t size = 0;
+        for (const auto* texture_ptr_ptr :
+             {&albedo_ptr, &normal_ptr, &metallic_roughness_ptr, &occlusion_ptr}) {
+            if (*texture_ptr_ptr != nullptr) {
+                size += (*texture_ptr_ptr)->byte_size();
+            }
+        }
+        return size;
+    }
 };
 
 struct Material3D {
@@ -21,4 +42,40 @@ struct Material3D {
     vk::DescriptorSet dset;
 };
 
+//! GPU materials of material data, created once and shared by every mesh
+//! component using the same material data while any of them is alive.
+//! Owned by the renderer, so it doesn't outlive the device.
+class Material3DCache {
+public:
+    // Ctor
+    explicit Material3DCache(vk::Device& device)
+        : m_device_ptr{&device}
+    {}
+    // Copy
+    Material3DCache(const Material3DCache&) = delete;
+    Material3DCache& operator=(const Material3DCache&) = delete;
+    // Move
+    Material3DCache(Material3DCache&&) = delete;
+    Material3DCache& operator=(Material3DCache&&) = delete;
+    // Dtor
+    ~Material3DCache() = default;
+
+    //! GPU material of \p material_data_ptr, created if no component uses it.
+    [[nodiscard]]
+    std::shared_ptr<Material3D> get(
+        const std::shared_ptr<const MaterialData>& material_data_ptr
+    );
+
+private:
+    vk::Device* m_device_ptr;
+    std::mutex m_mutex;
+    // Keyed by ownership, so material data freed and allocated again at the
+    // same address doesn't hit a stale entry
+    std::map<
+        std::weak_ptr<const MaterialData>,
+        std::weak_ptr<Material3D>,
+        std::owner_less<>
+    > m_materials;
+};
+
 } // namespace kzn
\ No newline at end of file
@@ -1,185 +1,317 @@
 #include "mesh.hpp"
 
+#include "graphics/gltf.hpp"
+#include "graphics/mesh_optimizer.hpp"
+#include "graphics/mesh_simplifier.hpp"
 #include "graphics/scene3d.hpp"
+#include "graphics/vertex_packing.hpp"
+#include "core/assert.hpp"
 #include "core/log.hpp"
 #include "resources/resources.hpp"
 
 #include <fastgltf/core.hpp>
 #include <fastgltf/types.hpp>
-#include <fastgltf/glm_element_traits.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 namespace kzn {
 
-MeshComponent::MeshComponent(vk::Device &device, const MeshData& mesh_data)
-    : m_mesh(device, mesh_data)
-    , m_material_opt{
-        [&mesh_data, &device]() -> std::optional<Material3D> {
-            if(mesh_data.material_opt.has_value()) {
-                return Material3D{
-                    .albedo_image = vk::Image(
-                        device,
-                        mesh_data.material_opt->albedo_opt->vk_extent()
-                    ),
-                    .normal_image = vk::Image(
-                        device,
-                        mesh_data.material_opt->normal_opt->vk_extent(),
-                        VK_FORMAT_R8G8B8A8_UNORM
-                    ),
-                    .metallic_roughness_image = vk::Image(
-                        device,
-                        mesh_data.material_opt->metallic_roughness_opt->vk_extent(),
-                        VK_FORMAT_R8G8B8A8_UNORM
-                    ),
-                    .occlusion_image = vk::Image(
-                        device,
-                        mesh_data.material_opt->occlusion_opt->vk_extent(),
-                        VK_FORMAT_R8G8B8A8_UNORM
-                    ),
-                    .dset = vk::DescriptorSet(
-                        device.dset_allocator().allocate(
-                            device.dset_layout_cache().layout({
-                                vk::sampler_binding(0),
-                                vk::sampler_binding(1),
-                                vk::sampler_binding(2),
-                                vk::sampler_binding(3),
-                            })
-                        )
-                    ),
-                };
-            }
-            else {
-                return std::nullopt;
-            }
-        }()
-    }
+MeshComponent::MeshComponent(
+    GeometryPoolCache& geometry_pools,
+    Material3DCache& material_cache,
+    const MeshData& mesh_data
+)
+    : m_mesh(
+        geometry_pools,
+        mesh_data,
+        cvar_r_packed_vertices.get() ? VertexFormat::Packed : VertexFormat::Float
+    )
 {
-    if(m_material_opt.has_value()) {
-        m_material_opt->albedo_image.upload(mesh_data.material_opt->albedo_opt->bytes);
-        m_material_opt->normal_image.upload(mesh_data.material_opt->normal_opt->bytes);
-        m_material_opt->metallic_roughness_image.upload(mesh_data.material_opt->metallic_roughness_opt->bytes);
-        m_material_opt->occlusion_image.upload(mesh_data.material_opt->occlusion_opt->bytes);
-        m_material_opt->dset.update({
-            m_material_opt->albedo_image.info(),
-            m_material_opt->normal_image.info(),
-            m_material_opt->metallic_roughness_image.info(),
-            m_material_opt->occlusion_image.info(),
+    // Levels of detail follow the mesh indices in the index buffer
+    const auto add_lod = [&](
+        std::span<const Submesh> submeshes,
+        std::size_t index_offset,
+        std::size_t index_count,
+        float error
+    ) {
+        auto& lod = m_lods.emplace_back(Lod{
+            .submeshes = std::vector<Submesh>(submeshes.begin(), submeshes.end()),
+            .error = error,
         });
+        // Meshes without submeshes are drawn whole without material
+        if (lod.submeshes.empty()) {
+            lod.submeshes.push_back(Submesh{
+                .index_offset = 0,
+                .index_count = static_cast<std::uint32_t>(index_count),
+            });
+        }
+        for (auto& submesh : lod.submeshes) {
+            submesh.index_offset += static_cast<std::uint32_t>(index_offset);
+        }
+    };
+    add_lod(mesh_data.submeshes, 0, mesh_data.indices.size(), 0.f);
+    std::size_t index_offset = mesh_data.indices.size();
+    for (const auto& lod : mesh_data.lods) {
+        add_lod(lod.submeshes, index_offset, lod.indices.size(), lod.error);
+        index_offset += lod.indices.size();
+    }
+
+    const auto& submeshes = m_lods.front().submeshes;
+    m_materials.reserve(submeshes.size());
+    for (const auto& submesh : submeshes) {
+        m_materials.push_back(
+            submesh.material_ptr != nullptr
+                ? material_cache.get(submesh.material_ptr)
+                : nullptr
+        );
     }
+
+    m_bounds_center = (mesh_data.bounds_min + mesh_data.bounds_max) * 0.5f;
+    m_bounds_radius = glm::length(mesh_data.bounds_max - mesh_data.bounds_min) * 0.5f;
 }
 
-MeshComponent::MeshComponent(vk::Device &device, const std::string_view mesh_path)
-    // : MeshComponent(device, *g_resources.load<MeshData>(mesh_path))
-    : MeshComponent(device, g_resources.load<Scene3DData>(mesh_path)->meshes[0])
+MeshComponent::MeshComponent(
+    GeometryPoolCache& geometry_pools,
+    Material3DCache& material_cache,
+    const std::string_view mesh_path
+)
+    // : MeshComponent(geometry_pools, material_cache, *g_resources.load<MeshData>(mesh_path))
+    : MeshComponent(
+        geometry_pools,
+        material_cache,
+        g_resources.load<Scene3DData>(mesh_path)
+    )
 {
 
 }
 
-std::shared_ptr<MeshData> MeshData::load(const std::filesystem::path& path) {
-    auto& path_str = path.native();
-    if(path_str.ends_with(".gltf") || path_str.ends_with(".glb")) {
-        
-        // Map gltf file
-        auto gltf_file_res = fastgltf::MappedGltfFile::FromPath(path);
-        if (gltf_file_res.error() != fastgltf::Error::None) {
-            throw LoadingError{
-                .message = fastgltf::getErrorMessage(gltf_file_res.error()).data(),
-            };
-		}
-        
-        // Load gltf model
-        fastgltf::Parser parser;
-        constexpr auto gltf_options = fastgltf::Options::LoadExternalBuffers;
-        auto asset_res = parser.loadGltf(gltf_file_res.get(), path.parent_path(), gltf_options);
-        if (asset_res.error() != fastgltf::Error::None) {
-            throw LoadingError{
-                .message = fastgltf::getErrorMessage(asset_res.error()).data(),
-            };
-        }
+MeshComponent::MeshComponent(
+    GeometryPoolCache& geometry_pools,
+    Material3DCache& material_cache,
+    std::shared_ptr<Scene3DData> scene3d_ptr
+)
+    : MeshComponent(g_resources.profile_upload(scene3d_ptr.get(), [&] {
+        return MeshComponent(geometry_pools, material_cache, scene3d_ptr->meshes[0]);
+    }))
+{
+    m_source_ptr = std::move(scene3d_ptr);
+}
 
-        auto& gltf = asset_res.get();
-        
-        std::vector<Vertex3D> vertices;
-        std::vector<std::uint32_t> indices;
-        for (fastgltf::Mesh& mesh : gltf.meshes) {
-            for(auto& primitive : mesh.primitives) {
-                // TODO: Load all meshes instead of just the first
-                // TODO: Load indices
-                // TODO: Load tex_coords
-                // TODO: Store primitive.type
-                
-                // Load indices
-                if (primitive.indicesAccessor.has_value()) {
-                    auto& accessor = gltf.accessors[primitive.indicesAccessor.value()];
-                    indices.resize(accessor.count);
-                    fastgltf::iterateAccessorWithIndex<uint32_t>(
-                        gltf,
-                        accessor,
-                        [&indices](uint32_t i, size_t idx) {
-                            indices[idx] = i;
-                        }
-                    );
-                }
-
-                // Load vertex positions
-                const auto& pos_accessor = gltf.accessors[primitive.findAttribute("POSITION")->accessorIndex];
-                vertices.resize(pos_accessor.count);
-                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                    gltf,
-                    pos_accessor,
-                    [&vertices](glm::vec3 pos, size_t idx) {
-                        vertices[idx].position = pos;
-                    }
-                );
-
-                // Load vertex normals
-                auto normals = primitive.findAttribute("NORMAL");
-                if (normals != primitive.attributes.end()) {
-                    fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                        gltf,
-                        gltf.accessors[normals->accessorIndex],
-                        [&vertices](glm::vec3 normal, size_t idx) {
-                            vertices[idx].normal = normal;
-                        }
-                    );
-                }
-
-                // Load vertex texture coordinates
-                auto tex_coords = primitive.findAttribute("TEXCOORD_0");
-                if (tex_coords != primitive.attributes.end()) {
-                    fastgltf::iterateAccessorWithIndex<glm::vec2>(
-                        gltf,
-                        gltf.accessors[tex_coords->accessorIndex],
-                        [&vertices](glm::vec2 uv, size_t idx) {
-                            vertices[idx].uv = uv;
-                        }
-                    );
-                }
-
-                return std::make_shared<MeshData>(std::move(vertices), std::move(indices));
-            }
+void MeshComponent::select_lod(
+    float pixels_per_unit,
+    float max_error_pixels,
+    float hysteresis
+) {
+    const auto coarsest_lod = [&](float max_error) {
+        std::size_t lod = 0;
+        while (lod + 1 < m_lods.size() &&
+               m_lods[lod + 1].error * pixels_per_unit <= max_error) {
+            ++lod;
         }
+        return lod;
+    };
+    // Finer levels are picked right away, coarser ones only once they're
+    // clearly under the threshold
+    const std::size_t lod = coarsest_lod(max_error_pixels);
+    if (lod <= m_lod) {
+        m_lod = lod;
     }
     else {
-        Log::error("Unsupported mesh format");
+        m_lod = std::max(m_lod, coarsest_lod(max_error_pixels * (1.f - hysteresis)));
+    }
+}
+
+void MeshComponent::reload(
+    GeometryPoolCache& geometry_pools,
+    Material3DCache& material_cache
+) {
+    KZN_ASSERT_MSG(m_source_ptr != nullptr, "Mesh wasn't loaded from a scene");
+    *this = MeshComponent(geometry_pools, material_cache, std::move(m_source_ptr));
+}
+
+std::size_t MeshData::byte_size() const {
+    std::size_t size = vertices.size() * sizeof(Vertex3D)
+        + indices.size() * sizeof(std::uint32_t);
+    for (const auto& lod : lods) {
+        size += lod.indices.size() * sizeof(std::uint32_t);
+    }
+    // Count materials shared by submeshes once
+    std::vector<const MaterialData*> counted_materials;
+    for (const auto& submesh : submeshes) {
+        const auto* material_ptr = submesh.material_ptr.get();
+        if (material_ptr != nullptr &&
+            std::ranges::find(counted_materials, material_ptr) == counted_materials.end()) {
+            counted_materials.push_back(material_ptr);
+            size += material_ptr->byte_size();
+        }
+    }
+    return size;
+}
+
+void MeshData::compute_bounds() {
+    if (vertices.empty()) {
+        bounds_min = bounds_max = Vec3{0.f};
+        return;
+    }
+    bounds_min = bounds_max = vertices.front().position;
+    for (const auto& vertex : vertices) {
+        bounds_min = glm::min(bounds_min, vertex.position);
+        bounds_max = glm::max(bounds_max, vertex.position);
+    }
+}
+
+bool MeshData::has_valid_indices() const {
+    const auto is_valid_index = [this](std::uint32_t index) {
+        return index < vertices.size();
+    };
+    const auto are_valid_submeshes = [](
+        std::span<const Submesh> submeshes,
+        std::size_t index_count
+    ) {
+        return std::ranges::all_of(submeshes, [&](const Submesh& submesh) {
+            return std::size_t{submesh.index_offset} + submesh.index_count
+                <= index_count;
+        });
+    };
+    return std::ranges::all_of(indices, is_valid_index)
+        && are_valid_submeshes(submeshes, indices.size())
+        && std::ranges::all_of(lods, [&](const MeshLod& lod) {
+            return std::ranges::all_of(lod.indices, is_valid_index)
+                && are_valid_submeshes(lod.submeshes, lod.indices.size());
+        });
+}
+
+std::shared_ptr<MeshData> MeshData::load(const std::filesystem::path& path) {
+    auto& path_str = path.native();
+    if(!path_str.ends_with(".gltf") && !path_str.ends_with(".glb")) {
+        throw LoadingError{
+            fmt::format("Unsupported mesh format '{}'", path.extension().native())
+        };
+    }
+
+    // Map gltf file
+    auto gltf_file_res = fastgltf::MappedGltfFile::FromPath(path);
+    if (gltf_file_res.error() != fastgltf::Error::None) {
+        throw LoadingError{
+            .message = fastgltf::getErrorMessage(gltf_file_res.error()).data(),
+        };
     }
 
-    return nullptr;
+    // Load gltf model
+    fastgltf::Parser parser;
+    constexpr auto gltf_options = fastgltf::Options::LoadExternalBuffers;
+    auto asset_res = parser.loadGltf(gltf_file_res.get(), path.parent_path(), gltf_options);
+    if (asset_res.error() != fastgltf::Error::None) {
+        throw LoadingError{
+            .message = fastgltf::getErrorMessage(asset_res.error()).data(),
+        };
+    }
+
+    auto& gltf_asset = asset_res.get();
+    if (gltf_asset.meshes.empty()) {
+        throw LoadingError{"Model has no meshes"};
+    }
+
+    // Only the first mesh, Scene3DData loads all of them
+    auto mesh_data_ptr = std::make_shared<MeshData>(
+        gltf::read_mesh(gltf_asset, gltf_asset.meshes[0])
+    );
+    if (cvar_res_optimize_meshes.get()) {
+        optimize_mesh(*mesh_data_ptr);
+    }
+    mesh_data_ptr->compute_bounds();
+    generate_lods(*mesh_data_ptr, std::max(cvar_res_mesh_lods.get(), 0));
+    return mesh_data_ptr;
+}
+
+const vk::VertexLayout& vertex_layout(VertexFormat format) {
+    static const auto float_layout =
+        vk::VertexLayout::of<Vec3, Vec3, Vec2, Vec3>();
+    static const auto packed_layout = vk::VertexLayout{
+        .stride = sizeof(PackedVertex3D),
+        .attributes = {
+            {VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex3D, position)},
+            {VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex3D, normal)},
+            {VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex3D, uv)},
+            {VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex3D, color)},
+        },
+    };
+    return format == VertexFormat::Packed ? packed_layout : float_layout;
 }
 
 Mesh::Mesh(
-    vk::Device& device,
-    const MeshData& mesh_data
+    GeometryPoolCache& geometry_pools,
+    const MeshData& mesh_data,
+    VertexFormat format
 )
-    : m_vtx_count{mesh_data.vertices.size()}
-    , m_idx_count{mesh_data.indices.size()}
-    , m_vtx_buffer(device, sizeof(Vertex3D) * m_vtx_count)
-    , m_idx_buffer(device, sizeof(std::uint32_t) * m_idx_count)
+    : m_vtx_format{format}
+    , m_pool_ptr{geometry_pools.get(vertex_layout(format).stride)}
 {
-    m_vtx_buffer.upload(static_cast<const void*>(mesh_data.vertices.data()));
-    m_idx_buffer.upload(mesh_data.indices.data());
+    // Levels of detail follow the mesh indices
+    std::vector<std::uint32_t> lod_indices;
+    if (!mesh_data.lods.empty()) {
+        lod_indices.reserve(std::transform_reduce(
+            mesh_data.lods.begin(),
+            mesh_data.lods.end(),
+            mesh_data.indices.size(),
+            std::plus{},
+            [](const MeshLod& lod) { return lod.indices.size(); }
+        ));
+        lod_indices.insert(lod_indices.end(), mesh_data.indices.begin(), mesh_data.indices.end());
+        for (const auto& lod : mesh_data.lods) {
+            lod_indices.insert(lod_indices.end(), lod.indices.begin(), lod.indices.end());
+        }
+    }
+    const std::span<const std::uint32_t> indices = mesh_data.lods.empty()
+        ? std::span<const std::uint32_t>{mesh_data.indices}
+        : std::span<const std::uint32_t>{lod_indices};
+
+    if (format == VertexFormat::Packed) {
+        const auto packed = pack_vertices(mesh_data.vertices);
+        m_dequantize_matrix = Mat4{
+            Vec4{packed.position_extent.x, 0.f, 0.f, 0.f},
+            Vec4{0.f, packed.position_extent.y, 0.f, 0.f},
+            Vec4{0.f, 0.f, packed.position_extent.z, 0.f},
+            Vec4{packed.position_min, 1.f},
+        };
+        m_range = m_pool_ptr->allocate(
+            packed.vertices.data(),
+            packed.vertices.size(),
+            indices
+        );
+    }
+    else {
+        m_range = m_pool_ptr->allocate(
+            mesh_data.vertices.data(),
+            mesh_data.vertices.size(),
+            indices
+        );
+    }
+}
+
+Mesh& Mesh::operator=(Mesh&& other) {
+    if (this != &other) {
+        if (m_pool_ptr != nullptr) {
+            m_pool_ptr->free(m_range);
+        }
+        m_vtx_format = other.m_vtx_format;
+        m_dequantize_matrix = other.m_dequantize_matrix;
+        // Moved from meshes have no pool and don't free their range
+        m_pool_ptr = std::move(other.m_pool_ptr);
+        m_range = other.m_range;
+    }
+    return *this;
+}
+
+Mesh::~Mesh() {
+    if (m_pool_ptr != nullptr) {
+        m_pool_ptr->free(m_range);
+    }
 }
 
 } // namespace kzn
\ No newline at end of file
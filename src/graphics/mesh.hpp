@@ -1,5 +1,7 @@
 #pragma once
 
+#include "core/cvar.hpp"
+#include "graphics/geometry_pool.hpp"
 #include "graphics/material3d.hpp"
 #include "graphics/texture.hpp"
 #include "math/types.hpp"
@@ -9,16 +11,23 @@
 #include "vk/dset.hpp"
 #include "vk/dset_layout.hpp"
 #include "vk/image.hpp"
+#include "vk/vertex_layout.hpp"
 
 #include <vulkan/vulkan_core.h>
 
 #include <filesystem>
 #include <memory>
-#include <optional>
+#include <span>
 #include <vector>
 
 namespace kzn {
 
+inline CVar<bool> cvar_r_packed_vertices{
+    "r_packed_vertices",
+    false,
+    "Upload meshes as 20 byte quantized vertices instead of 44 byte vertices"
+};
+
 struct Vertex3D {
     Vec3 position;
     Vec3 normal;
@@ -26,59 +35,156 @@ struct Vertex3D {
     Vec3 color = Vec3{1,1,1};
 };
 
+//! Range of a mesh's indices drawn with one material, a glTF primitive.
+struct Submesh {
+    std::uint32_t index_offset;
+    std::uint32_t index_count;
+    //! Material shared with the other submeshes of the scene that use it.
+    std::shared_ptr<const MaterialData> material_ptr = nullptr;
+};
+
+//! Simplified level of detail of a mesh, drawing the same vertices with
+//! fewer triangles.
+struct MeshLod {
+    //! Indices of all submeshes, into the vertices of the mesh.
+    std::vector<std::uint32_t> indices;
+    //! Same submeshes as the mesh, in the same order, with ranges into the
+    //! indices of the level.
+    std::vector<Submesh> submeshes;
+    //! Largest distance the surface moved from the mesh, in mesh units.
+    float error = 0.f;
+};
+
 struct MeshData {
     std::vector<Vertex3D> vertices;
+    //! Indices of all submeshes, relative to the first vertex of the mesh.
     std::vector<std::uint32_t> indices;
-    std::optional<MaterialData> material_opt;
+    std::vector<Submesh> submeshes;
+    //! Levels of detail, each coarser than the previous one.
+    std::vector<MeshLod> lods;
+    //! Axis aligned bounds of the vertices, set by `compute_bounds()`.
+    Vec3 bounds_min{0.f};
+    Vec3 bounds_max{0.f};
     // TODO: VertexLayout layout;
 
+    //! Sets the bounds to those of the vertices.
+    void compute_bounds();
+
+    //! Size of vertex, index and material data in bytes.
+    [[nodiscard]]
+    std::size_t byte_size() const;
+
+    //! Whether every index refers to a vertex and every submesh to indices.
+    [[nodiscard]]
+    bool has_valid_indices() const;
+
     [[nodiscard]]
     static std::shared_ptr<MeshData> load(const std::filesystem::path& path);
 };
 
+//! Formats of the vertices of a mesh on the GPU.
+enum class VertexFormat {
+    //! Vertex3D as is.
+    Float,
+    //! PackedVertex3D, needs the packed shader variant.
+    Packed,
+};
+
+//! Vertex input layout of a vertex format.
+[[nodiscard]]
+const vk::VertexLayout& vertex_layout(VertexFormat format);
+
 class Mesh {
 public:
     // Ctor
-    Mesh(vk::Device& device, const MeshData& mesh_data);
+    Mesh(
+        GeometryPoolCache& geometry_pools,
+        const MeshData& mesh_data,
+        VertexFormat format = VertexFormat::Float
+    );
     // Copy
     Mesh(const Mesh&) = delete;
     Mesh& operator=(const Mesh&) = delete;
     // Move
     Mesh(Mesh&&) = default;
-    Mesh& operator=(Mesh&&) = default;
+    Mesh& operator=(Mesh&&);
     // Dtor
-    ~Mesh() = default;
+    ~Mesh();
 
+    //! Vertex buffer shared with the meshes of the same pool block.
     [[nodiscard]]
     const vk::VertexBuffer& vtx_buffer() const {
-        return m_vtx_buffer;
+        return m_pool_ptr->block(m_range.block).vtx_buffer;
     }
+    //! Index buffer shared with the meshes of the same pool block.
     [[nodiscard]]
     const vk::IndexBuffer& idx_buffer() const {
-        return m_idx_buffer;
+        return m_pool_ptr->block(m_range.block).idx_buffer;
+    }
+
+    //! Offset of the first vertex of the mesh in the vertex buffer, added to
+    //! its indices when drawing.
+    [[nodiscard]]
+    std::int32_t base_vertex() const {
+        return static_cast<std::int32_t>(m_range.base_vertex);
     }
-    
+    //! Offset of the first index of the mesh in the index buffer.
+    [[nodiscard]]
+    std::uint32_t first_index() const {
+        return m_range.first_index;
+    }
+
     [[nodiscard]]
     std::size_t vtx_count() const {
-        return m_vtx_count;
+        return m_range.vertex_count;
     }
+    //! Indices of the mesh followed by those of its levels of detail.
     [[nodiscard]]
     std::size_t idx_count() const {
-        return m_idx_count;
+        return m_range.index_count;
+    }
+
+    [[nodiscard]]
+    VertexFormat vtx_format() const {
+        return m_vtx_format;
+    }
+
+    //! Transform from vertex positions to mesh space. Scales and offsets the
+    //! unorm positions of packed vertices by the mesh bounds, identity
+    //! otherwise.
+    [[nodiscard]]
+    const Mat4& dequantize_matrix() const {
+        return m_dequantize_matrix;
     }
 
 private:
-    std::size_t m_vtx_count;
-    std::size_t m_idx_count;
-    vk::VertexBuffer m_vtx_buffer;
-    vk::IndexBuffer m_idx_buffer;
+    VertexFormat m_vtx_format;
+    Mat4 m_dequantize_matrix{1.f};
+    //! Pool of the vertex format, kept alive by the meshes in it.
+    std::shared_ptr<GeometryPool> m_pool_ptr;
+    GeometryRange m_range;
 };
 
+struct Scene3DData;
+
 class MeshComponent {
 public:
     // Ctor
-    MeshComponent(vk::Device &device, const MeshData& mesh_data);
-    MeshComponent(vk::Device &device, const std::string_view mesh_path);
+    MeshComponent(
+        GeometryPoolCache& geometry_pools,
+        Material3DCache& material_cache,
+        const MeshData& mesh_data
+    );
+    MeshComponent(
+        GeometryPoolCache& geometry_pools,
+        Material3DCache& material_cache,
+        const std::string_view mesh_path
+    );
+    MeshComponent(
+        GeometryPoolCache& geometry_pools,
+        Material3DCache& material_cache,
+        std::shared_ptr<Scene3DData> scene3d_ptr
+    );
     // Copy
     MeshComponent(const MeshComponent&) = delete;
     MeshComponent& operator=(const MeshComponent&) = delete;
@@ -92,14 +198,79 @@ public:
     const Mesh& mesh() const {
         return m_mesh;
     }
+    //! Index ranges drawn with each material, at the current level of detail.
+    [[nodiscard]]
+    std::span<const Submesh> submeshes() const {
+        return m_lods[m_lod].submeshes;
+    }
+    //! GPU material of a submesh, shared by the mesh components with the same
+    //! material data, or nullptr if the submesh has no material.
     [[nodiscard]]
-    std::optional<Material3D>& material() {
-        return m_material_opt;
+    Material3D* material(std::size_t submesh_idx) {
+        return m_materials[submesh_idx].get();
     }
 
+    //! Current level of detail, 0 being the full mesh.
+    [[nodiscard]]
+    std::size_t lod() const {
+        return m_lod;
+    }
+    [[nodiscard]]
+    std::size_t lod_count() const {
+        return m_lods.size();
+    }
+
+    //! Center of the bounding sphere of the mesh, in mesh space.
+    [[nodiscard]]
+    Vec3 bounds_center() const {
+        return m_bounds_center;
+    }
+    [[nodiscard]]
+    float bounds_radius() const {
+        return m_bounds_radius;
+    }
+
+    //! Switches to the coarsest level of detail whose error projects to at
+    //! most \p max_error_pixels on screen.
+    //! \param pixels_per_unit Projected size in pixels of one mesh unit.
+    //! \param hysteresis Fraction the error threshold is lowered by to switch
+    //! to a coarser level, so meshes near a threshold don't alternate between
+    //! levels every frame.
+    void select_lod(
+        float pixels_per_unit,
+        float max_error_pixels,
+        float hysteresis
+    );
+
+    //! Scene the mesh was loaded from, or nullptr if created from mesh data.
+    [[nodiscard]]
+    const Scene3DData* source() const {
+        return m_source_ptr.get();
+    }
+
+    //! Creates mesh and material GPU data again from the source scene, used
+    //! when the scene was reloaded.
+    void reload(
+        GeometryPoolCache& geometry_pools,
+        Material3DCache& material_cache
+    );
+
+private:
+    struct Lod {
+        //! Ranges into the index buffer of the mesh. Submeshes of the first
+        //! level also keep the material data of each GPU material alive.
+        std::vector<Submesh> submeshes;
+        float error;
+    };
+
 private:
     Mesh m_mesh;
-    std::optional<Material3D> m_material_opt;
+    std::vector<Lod> m_lods;
+    std::size_t m_lod = 0;
+    std::vector<std::shared_ptr<Material3D>> m_materials;
+    Vec3 m_bounds_center{0.f};
+    float m_bounds_radius = 0.f;
+    std::shared_ptr<Scene3DData> m_source_ptr = nullptr;
 };
 
 } // namespace kzn
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "mesh_cooker.hpp"
+
+#include "core/assert.hpp"
+#include "graphics/kmesh.hpp"
+
+#include <array>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace kzn {
+
+namespace {
+
+template<typename T>
+void append(std::vector<std::byte>& dst, std::span<const T> values) {
+    const auto bytes = std::as_bytes(values);
+    dst.insert(dst.end(), bytes.begin(), bytes.end());
+}
+
+} // namespace
+
+std::vector<std::byte> cook_mesh(
+    const Scene3DData& scene,
+    std::span<const std::string> image_paths,
+    std::uint64_t source_hash
+) {
+    KZN_ASSERT_MSG(
+        image_paths.size() == scene.images.size(),
+        "Every image of the scene must have a path"
+    );
+
+    // Materials and images are referenced by pointer, stored by index
+    std::unordered_map<const MaterialData*, std::uint32_t> material_indices;
+    for (std::size_t i = 0; i < scene.materials.size(); ++i) {
+        material_indices.emplace(scene.materials[i].get(), std::uint32_t(i));
+    }
+    std::unordered_map<const TextureData*, std::size_t> image_indices;
+    for (std::size_t i = 0; i < scene.images.size(); ++i) {
+        image_indices.emplace(scene.images[i].get(), i);
+    }
+
+    std::vector<kmesh::MeshEntry> meshes;
+    std::vector<kmesh::LodEntry> lods;
+    std::vector<kmesh::SubmeshEntry> submeshes;
+    std::uint64_t vertex_count = 0;
+    std::uint64_t index_count = 0;
+    const auto add_lod = [&](
+        std::span<const std::uint32_t> indices,
+        std::span<const Submesh> lod_submeshes,
+        float error
+    ) {
+        lods.push_back(kmesh::LodEntry{
+            .first_index = std::uint32_t(index_count),
+            .index_count = std::uint32_t(indices.size()),
+            .first_submesh = std::uint32_t(submeshes.size()),
+            .error = error,
+        });
+        for (const auto& submesh : lod_submeshes) {
+            const auto it = material_indices.find(submesh.material_ptr.get());
+            submeshes.push_back(kmesh::SubmeshEntry{
+                .index_offset = submesh.index_offset,
+                .index_count = submesh.index_count,
+                .material = (submesh.material_ptr != nullptr && it != material_indices.end())
+                    ? it->second
+                    : kmesh::no_material,
+            });
+        }
+        index_count += indices.size();
+    };
+    for (const auto& mesh : scene.meshes) {
+        meshes.push_back(kmesh::MeshEntry{
+            .first_vertex = std::uint32_t(vertex_count),
+            .vertex_count = std::uint32_t(mesh.vertices.size()),
+            .first_lod = std::uint32_t(lods.size()),
+            .lod_count = std::uint32_t(mesh.lods.size() + 1),
+            .submesh_count = std::uint32_t(mesh.submeshes.size()),
+            .bounds_min = {mesh.bounds_min.x, mesh.bounds_min.y, mesh.bounds_min.z},
+            .bounds_max = {mesh.bounds_max.x, mesh.bounds_max.y, mesh.bounds_max.z},
+        });
+        add_lod(mesh.indices, mesh.submeshes, 0.f);
+        for (const auto& lod : mesh.lods) {
+            add_lod(lod.indices, lod.submeshes, lod.error);
+        }
+        vertex_count += mesh.vertices.size();
+    }
+
+    // Texture paths of each material slot, stored once per image
+    std::vector<kmesh::MaterialEntry> materials(scene.materials.size());
+    std::string strings;
+    std::unordered_map<std::size_t, kmesh::TextureRef> image_refs;
+    for (std::size_t i = 0; i < scene.materials.size(); ++i) {
+        const auto* material_ptr = scene.materials[i].get();
+        if (material_ptr == nullptr) {
+            continue;
+        }
+        const std::array textures{
+            material_ptr->albedo_ptr.get(),
+            material_ptr->normal_ptr.get(),
+            material_ptr->metallic_roughness_ptr.get(),
+            material_ptr->occlusion_ptr.get(),
+        };
+        for (std::size_t slot = 0; slot < textures.size(); ++slot) {
+            const auto it = image_indices.find(textures[slot]);
+            if (textures[slot] == nullptr || it == image_indices.end()) {
+                continue;
+            }
+            const auto& path = image_paths[it->second];
+            const auto [ref_it, inserted] = image_refs.try_emplace(
+                it->second,
+                kmesh::TextureRef{
+                    .offset = std::uint32_t(strings.size()),
+                    .size = std::uint32_t(path.size()),
+                }
+            );
+            if (inserted) {
+                strings += path;
+            }
+            materials[i].textures[slot] = ref_it->second;
+        }
+    }
+
+    const kmesh::Header header{
+        .magic = kmesh::magic,
+        .version = kmesh::version,
+        .source_hash = source_hash,
+        .mesh_count = std::uint32_t(meshes.size()),
+        .lod_count = std::uint32_t(lods.size()),
+        .submesh_count = std::uint32_t(submeshes.size()),
+        .material_count = std::uint32_t(materials.size()),
+        .vertex_count = vertex_count,
+        .index_count = index_count,
+        .string_size = strings.size(),
+    };
+
+    std::vector<std::byte> kmesh_bytes;
+    append<kmesh::Header>(kmesh_bytes, std::span{&header, 1});
+    append<kmesh::MeshEntry>(kmesh_bytes, meshes);
+    append<kmesh::LodEntry>(kmesh_bytes, lods);
+    append<kmesh::SubmeshEntry>(kmesh_bytes, submeshes);
+    append<kmesh::MaterialEntry>(kmesh_bytes, materials);
+    for (const auto& mesh : scene.meshes) {
+        append<Vertex3D>(kmesh_bytes, mesh.vertices);
+    }
+    for (const auto& mesh : scene.meshes) {
+        append<std::uint32_t>(kmesh_bytes, mesh.indices);
+        for (const auto& lod : mesh.lods) {
+            append<std::uint32_t>(kmesh_bytes, lod.indices);
+        }
+    }
+    append<char>(kmesh_bytes, strings);
+    return kmesh_bytes;
+}
+
+} // namespace kzn
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "graphics/scene3d.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace kzn {
+
+//! Encodes the meshes of a scene as a .kmesh file, with the levels of detail
+//! they have. Materials reference their textures by path.
+//! \param image_paths Path of each image of the scene, by image index,
+//! relative to the .kmesh file. Textures with an empty path are left out.
+//! \param source_hash Stored in the header to detect unchanged sources.
+[[nodiscard]]
+std::vector<std::byte> cook_mesh(
+    const Scene3DData& scene,
+    std::span<const std::string> image_paths,
+    std::uint64_t source_hash
+);
+
+} // namespace kzn
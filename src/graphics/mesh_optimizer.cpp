@@ -0,0 +1,366 @@
+#include "mesh_optimizer.hpp"
+
+#include "core/log.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+namespace {
+
+//! Index ranges of the submeshes of a mesh, or all indices if it has none.
+//! Ranges are truncated to whole triangles.
+[[nodiscard]]
+std::vector<std::span<std::uint32_t>> triangle_ranges(MeshData& mesh) {
+    std::vector<std::span<std::uint32_t>> ranges;
+    if (mesh.submeshes.empty()) {
+        ranges.push_back(std::span{mesh.indices});
+    }
+    for (const auto& submesh : mesh.submeshes) {
+        ranges.push_back(std::span{mesh.indices}.subspan(
+            submesh.index_offset, submesh.index_count
+        ));
+    }
+    for (auto& range : ranges) {
+        range = range.first(range.size() - range.size() % 3);
+    }
+    return ranges;
+}
+
+//! FIFO cache emulation using timestamps, a vertex is in the cache if fewer
+//! than cache size vertices were added since it was.
+class VertexCache {
+public:
+    VertexCache(std::size_t vertex_count, std::uint32_t cache_size)
+        : m_timestamps(vertex_count, 0)
+        , m_cache_size{cache_size}
+        , m_timestamp{cache_size + 1} {}
+
+    [[nodiscard]]
+    bool contains(std::uint32_t vertex) const {
+        return m_timestamp - m_timestamps[vertex] <= m_cache_size;
+    }
+
+    //! Time since the vertex was added, larger than cache size if it isn't
+    //! in the cache.
+    [[nodiscard]]
+    std::uint32_t age(std::uint32_t vertex) const {
+        return m_timestamp - m_timestamps[vertex];
+    }
+
+    //! Adds the vertex if it isn't in the cache.
+    //! \return true on a cache miss.
+    bool access(std::uint32_t vertex) {
+        if (contains(vertex)) {
+            return false;
+        }
+        m_timestamps[vertex] = m_timestamp++;
+        return true;
+    }
+
+private:
+    std::vector<std::uint32_t> m_timestamps;
+    std::uint32_t m_cache_size;
+    std::uint32_t m_timestamp;
+};
+
+//! Tipsify: fans around a vertex still in the cache, emitting all of its
+//! remaining triangles, and jumps to a recently used vertex at dead ends.
+void tipsify(
+    std::span<std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::uint32_t cache_size
+) {
+    if (indices.empty()) {
+        return;
+    }
+    const std::size_t triangle_count = indices.size() / 3;
+
+    // Triangles using each vertex, in compressed rows
+    std::vector<std::uint32_t> live_counts(vertex_count, 0);
+    for (const auto index : indices) {
+        ++live_counts[index];
+    }
+    std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+    std::inclusive_scan(live_counts.begin(), live_counts.end(), offsets.begin() + 1);
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> fill_offsets(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            adjacency[fill_offsets[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+    }
+
+    VertexCache cache{vertex_count, cache_size};
+    std::vector<bool> is_emitted(triangle_count, false);
+    std::vector<std::uint32_t> dead_ends;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+    // Next vertex to check when there are no dead ends left
+    std::size_t cursor = 0;
+
+    constexpr auto none = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t fanning = indices[0];
+    while (fanning != none) {
+        candidates.clear();
+        for (auto a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+            const auto triangle = adjacency[a];
+            if (is_emitted[triangle]) {
+                continue;
+            }
+            for (std::size_t k = 0; k < 3; ++k) {
+                const auto vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                dead_ends.push_back(vertex);
+                candidates.push_back(vertex);
+                --live_counts[vertex];
+                cache.access(vertex);
+            }
+            is_emitted[triangle] = true;
+        }
+
+        // Oldest candidate that stays in the cache while fanning around it
+        fanning = none;
+        std::int64_t best_priority = -1;
+        for (const auto vertex : candidates) {
+            if (live_counts[vertex] == 0) {
+                continue;
+            }
+            std::int64_t priority = 0;
+            if (cache.age(vertex) + 2 * live_counts[vertex] <= cache_size) {
+                priority = cache.age(vertex);
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                fanning = vertex;
+            }
+        }
+
+        // Dead end, prefer recently used vertices
+        while (fanning == none && !dead_ends.empty()) {
+            const auto vertex = dead_ends.back();
+            dead_ends.pop_back();
+            if (live_counts[vertex] > 0) {
+                fanning = vertex;
+            }
+        }
+        for (; fanning == none && cursor < vertex_count; ++cursor) {
+            if (live_counts[cursor] > 0) {
+                fanning = static_cast<std::uint32_t>(cursor);
+            }
+        }
+    }
+
+    std::ranges::copy(result, indices.begin());
+}
+
+//! Splits triangles into clusters starting where all three vertices miss the
+//! cache, then draws clusters facing away from the mesh center first.
+void reorder_clusters(
+    std::span<std::uint32_t> indices,
+    const std::vector<Vertex3D>& vertices,
+    std::uint32_t cache_size
+) {
+    const std::size_t triangle_count = indices.size() / 3;
+    if (triangle_count < 2) {
+        return;
+    }
+
+    std::vector<std::size_t> cluster_starts;
+    VertexCache cache{vertices.size(), cache_size};
+    for (std::size_t t = 0; t < triangle_count; ++t) {
+        std::size_t misses = 0;
+        for (std::size_t k = 0; k < 3; ++k) {
+            misses += cache.access(indices[t * 3 + k]);
+        }
+        if (t == 0 || misses == 3) {
+            cluster_starts.push_back(t);
+        }
+    }
+    cluster_starts.push_back(triangle_count);
+    const std::size_t cluster_count = cluster_starts.size() - 1;
+    if (cluster_count < 2) {
+        return;
+    }
+
+    struct Cluster {
+        Vec3 centroid{0.f};
+        Vec3 normal{0.f};
+        float area = 0.f;
+    };
+    std::vector<Cluster> clusters(cluster_count);
+    Vec3 mesh_centroid{0.f};
+    float mesh_area = 0.f;
+    for (std::size_t c = 0; c < cluster_count; ++c) {
+        auto& cluster = clusters[c];
+        for (std::size_t t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t) {
+            const Vec3 p0 = vertices[indices[t * 3 + 0]].position;
+            const Vec3 p1 = vertices[indices[t * 3 + 1]].position;
+            const Vec3 p2 = vertices[indices[t * 3 + 2]].position;
+            // Twice the area, so sums of normals are area weighted
+            const Vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float area = glm::length(normal) * 0.5f;
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        mesh_centroid += cluster.centroid;
+        mesh_area += cluster.area;
+        if (cluster.area > 0.f) {
+            cluster.centroid /= cluster.area;
+        }
+    }
+    if (mesh_area <= 0.f) {
+        return;
+    }
+    mesh_centroid /= mesh_area;
+
+    std::vector<float> sort_keys(cluster_count, 0.f);
+    for (std::size_t c = 0; c < cluster_count; ++c) {
+        const float normal_length = glm::length(clusters[c].normal);
+        if (normal_length > 0.f) {
+            sort_keys[c] = glm::dot(
+                clusters[c].centroid - mesh_centroid,
+                clusters[c].normal / normal_length
+            );
+        }
+    }
+    std::vector<std::size_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(order, [&](std::size_t a, std::size_t b) {
+        return sort_keys[a] > sort_keys[b];
+    });
+
+    std::vector<std::uint32_t> result;
+    result.reserve(indices.size());
+    for (const auto c : order) {
+        result.insert(
+            result.end(),
+            indices.begin() + cluster_starts[c] * 3,
+            indices.begin() + cluster_starts[c + 1] * 3
+        );
+    }
+    std::ranges::copy(result, indices.begin());
+}
+
+} // namespace
+
+VertexCacheStats analyze_vertex_cache(
+    std::span<const std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::uint32_t cache_size
+) {
+    VertexCache cache{vertex_count, cache_size};
+    std::size_t misses = 0;
+    for (const auto index : indices) {
+        misses += cache.access(index);
+    }
+    const std::size_t triangle_count = indices.size() / 3;
+    return VertexCacheStats{
+        .acmr = triangle_count > 0 ? float(misses) / float(triangle_count) : 0.f,
+        .atvr = vertex_count > 0 ? float(misses) / float(vertex_count) : 0.f,
+    };
+}
+
+void weld_vertices(MeshData& mesh) {
+    static_assert(
+        sizeof(Vertex3D) == 11 * sizeof(float),
+        "Vertices are compared bitwise, they can't have padding"
+    );
+    const auto vertex_bytes = [](const Vertex3D& vertex) {
+        return std::string_view{
+            reinterpret_cast<const char*>(&vertex), sizeof(Vertex3D)
+        };
+    };
+
+    std::vector<Vertex3D> vertices;
+    vertices.reserve(mesh.vertices.size());
+    std::vector<std::uint32_t> remap(mesh.vertices.size());
+    // Keys view the old vertices, which outlive the map
+    std::unordered_map<std::string_view, std::uint32_t> unique_vertices;
+    unique_vertices.reserve(mesh.vertices.size());
+    for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+        const auto [it, inserted] = unique_vertices.try_emplace(
+            vertex_bytes(mesh.vertices[i]),
+            static_cast<std::uint32_t>(vertices.size())
+        );
+        if (inserted) {
+            vertices.push_back(mesh.vertices[i]);
+        }
+        remap[i] = it->second;
+    }
+
+    for (auto& index : mesh.indices) {
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+void optimize_vertex_cache(
+    std::span<std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::uint32_t cache_size
+) {
+    tipsify(indices.first(indices.size() - indices.size() % 3), vertex_count, cache_size);
+}
+
+void optimize_vertex_cache(MeshData& mesh, std::uint32_t cache_size) {
+    for (auto range : triangle_ranges(mesh)) {
+        tipsify(range, mesh.vertices.size(), cache_size);
+    }
+}
+
+void optimize_overdraw(MeshData& mesh, std::uint32_t cache_size) {
+    for (auto range : triangle_ranges(mesh)) {
+        reorder_clusters(range, mesh.vertices, cache_size);
+    }
+}
+
+void optimize_vertex_fetch(MeshData& mesh) {
+    constexpr auto unused = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> remap(mesh.vertices.size(), unused);
+    std::vector<Vertex3D> vertices;
+    vertices.reserve(mesh.vertices.size());
+    for (auto& index : mesh.indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<std::uint32_t>(vertices.size());
+            vertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+    mesh.vertices = std::move(vertices);
+}
+
+void optimize_mesh(MeshData& mesh) {
+    if (mesh.indices.empty()) {
+        return;
+    }
+    if (!mesh.has_valid_indices()) {
+        Log::warning("Skipped optimizing mesh with out of range indices");
+        return;
+    }
+
+    const auto before = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+    weld_vertices(mesh);
+    optimize_vertex_cache(mesh);
+    optimize_overdraw(mesh);
+    optimize_vertex_fetch(mesh);
+    const auto after = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+    Log::debug(
+        "Optimized mesh: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+        before.acmr,
+        after.acmr,
+        before.atvr,
+        after.atvr
+    );
+}
+
+} // namespace kzn
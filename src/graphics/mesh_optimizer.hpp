@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/cvar.hpp"
+#include "graphics/mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace kzn {
+
+inline CVar<bool> cvar_res_optimize_meshes{
+    "res_optimize_meshes",
+    true,
+    "Reorder loaded meshes for the GPU vertex cache, overdraw and fetch"
+};
+
+//! Size of the FIFO vertex cache the optimizer targets. Small enough that
+//! orders optimized for it also do well on larger caches.
+inline constexpr std::uint32_t vertex_cache_size = 16;
+
+//! Post-transform vertex cache efficiency of a triangle list.
+struct VertexCacheStats {
+    //! Average cache miss ratio, vertices transformed per triangle. 3 is the
+    //! worst, 0.5 is the best possible for large regular meshes.
+    float acmr = 0.f;
+    //! Average transform to vertex ratio, 1 means each vertex is transformed
+    //! once.
+    float atvr = 0.f;
+};
+
+//! Simulates a FIFO vertex cache of \p cache_size entries drawing \p indices.
+[[nodiscard]]
+VertexCacheStats analyze_vertex_cache(
+    std::span<const std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::uint32_t cache_size = vertex_cache_size
+);
+
+//! Merges vertices whose attributes are bitwise equal.
+void weld_vertices(MeshData& mesh);
+
+//! Reorders triangles for vertex cache locality using Tipsify (Sander et al.
+//! 2007).
+void optimize_vertex_cache(
+    std::span<std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::uint32_t cache_size = vertex_cache_size
+);
+
+//! Reorders the triangles of each submesh for vertex cache locality.
+void optimize_vertex_cache(
+    MeshData& mesh,
+    std::uint32_t cache_size = vertex_cache_size
+);
+
+//! Reorders clusters of triangles of each submesh so outward facing clusters
+//! are drawn first, to reduce overdraw. Clusters start where the vertex cache
+//! is cold, so it keeps the vertex cache order and should run after
+//! `optimize_vertex_cache()`.
+void optimize_overdraw(
+    MeshData& mesh,
+    std::uint32_t cache_size = vertex_cache_size
+);
+
+//! Reorders vertices in the order indices first use them, for vertex fetch
+//! locality, and drops vertices no index uses. Should run last.
+void optimize_vertex_fetch(MeshData& mesh);
+
+//! Runs every optimization above in order and logs the vertex cache stats
+//! before and after.
+void optimize_mesh(MeshData& mesh);
+
+} // namespace kzn
@@ -0,0 +1,600 @@
+#include "mesh_simplifier.hpp"
+
+#include "core/log.hpp"
+#include "graphics/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace kzn {
+
+namespace {
+
+constexpr auto none = std::numeric_limits<std::uint32_t>::max();
+// Vertex has more than one open edge in the same direction
+constexpr auto many = none - 1;
+
+//! Weights of the planes keeping open edges in place, relative to the
+//! triangle planes. Borders are kept more than seams, whose surface
+//! continues on the other side.
+constexpr double border_weight = 10.0;
+constexpr double seam_weight = 1.0;
+
+//! Bytes of the position of \p vertex, equal for vertices at the same position.
+[[nodiscard]]
+std::string_view position_bytes(const Vertex3D& vertex) {
+    return std::string_view{
+        reinterpret_cast<const char*>(&vertex.position),
+        sizeof(Vec3)
+    };
+}
+
+//! Sum of weighted squared distances to planes, as a symmetric 4x4 matrix.
+struct Quadric {
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0;
+    double a01 = 0.0, a02 = 0.0, a12 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    //! Adds the plane of points p where dot(normal, p) + distance is 0.
+    void add_plane(Vec3 normal, float distance, double plane_weight) {
+        const double x = normal.x;
+        const double y = normal.y;
+        const double z = normal.z;
+        const double d = distance;
+        a00 += plane_weight * x * x;
+        a11 += plane_weight * y * y;
+        a22 += plane_weight * z * z;
+        a01 += plane_weight * x * y;
+        a02 += plane_weight * x * z;
+        a12 += plane_weight * y * z;
+        b0 += plane_weight * x * d;
+        b1 += plane_weight * y * d;
+        b2 += plane_weight * z * d;
+        c += plane_weight * d * d;
+        weight += plane_weight;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        a00 += other.a00;
+        a11 += other.a11;
+        a22 += other.a22;
+        a01 += other.a01;
+        a02 += other.a02;
+        a12 += other.a12;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    //! Mean squared distance of a point to the planes.
+    [[nodiscard]]
+    double error(Vec3 point) const {
+        if (weight <= 0.0) {
+            return 0.0;
+        }
+        const double x = point.x;
+        const double y = point.y;
+        const double z = point.z;
+        const double error = a00 * x * x + a11 * y * y + a22 * z * z
+            + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+            + 2.0 * (b0 * x + b1 * y + b2 * z)
+            + c;
+        return std::max(error, 0.0) / weight;
+    }
+};
+
+enum class VertexKind : std::uint8_t {
+    //! Inside the surface, can collapse to any neighbor.
+    Manifold,
+    //! On an open border, can only collapse along it.
+    Border,
+    //! One of two vertices at a position splitting attributes, collapses
+    //! along the seam together with the other one.
+    Seam,
+    //! Can't collapse.
+    Locked,
+};
+
+//! Connectivity of the vertices used by a triangle list.
+struct Topology {
+    //! Next vertex at the same position, in a cycle.
+    std::vector<std::uint32_t> wedges;
+    //! Vertex after and before each vertex along open edges, which have no
+    //! opposite edge using the same vertices.
+    std::vector<std::uint32_t> open_next;
+    std::vector<std::uint32_t> open_prev;
+    std::vector<VertexKind> kinds;
+    //! Triangles using each vertex, in compressed rows.
+    std::vector<std::uint32_t> triangle_offsets;
+    std::vector<std::uint32_t> triangles;
+};
+
+[[nodiscard]]
+constexpr bool is_single(std::uint32_t vertex) {
+    return vertex != none && vertex != many;
+}
+
+[[nodiscard]]
+Topology build_topology(
+    std::span<const std::uint32_t> indices,
+    std::size_t vertex_count,
+    std::span<const std::uint32_t> position_ids,
+    std::size_t position_count,
+    const std::vector<bool>& locked
+) {
+    Topology topology;
+    topology.wedges.assign(vertex_count, none);
+    topology.open_next.assign(vertex_count, none);
+    topology.open_prev.assign(vertex_count, none);
+    topology.kinds.assign(vertex_count, VertexKind::Locked);
+
+    // Link vertices at the same position
+    std::vector<std::uint32_t> first_wedges(position_count, none);
+    for (const auto vertex : indices) {
+        if (topology.wedges[vertex] != none) {
+            continue;
+        }
+        auto& first = first_wedges[position_ids[vertex]];
+        if (first == none) {
+            first = vertex;
+            topology.wedges[vertex] = vertex;
+        }
+        else {
+            topology.wedges[vertex] = topology.wedges[first];
+            topology.wedges[first] = vertex;
+        }
+    }
+
+    // Open edges
+    const auto edge_key = [](std::uint32_t a, std::uint32_t b) {
+        return (std::uint64_t{a} << 32) | b;
+    };
+    std::unordered_set<std::uint64_t> edges;
+    edges.reserve(indices.size());
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            edges.insert(edge_key(indices[i + k], indices[i + (k + 1) % 3]));
+        }
+    }
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            const auto a = indices[i + k];
+            const auto b = indices[i + (k + 1) % 3];
+            if (edges.contains(edge_key(b, a))) {
+                continue;
+            }
+            auto& next = topology.open_next[a];
+            next = (next == none) ? b : many;
+            auto& prev = topology.open_prev[b];
+            prev = (prev == none) ? a : many;
+        }
+    }
+
+    const auto same_position = [&](std::uint32_t a, std::uint32_t b) {
+        return is_single(a) && is_single(b) && position_ids[a] == position_ids[b];
+    };
+    for (const auto vertex : indices) {
+        const auto wedge = topology.wedges[vertex];
+        const auto next = topology.open_next[vertex];
+        const auto prev = topology.open_prev[vertex];
+        auto& kind = topology.kinds[vertex];
+        if ((!locked.empty() && (locked[vertex] || locked[wedge]))) {
+            kind = VertexKind::Locked;
+        }
+        else if (wedge == vertex) {
+            if (next == none && prev == none) {
+                kind = VertexKind::Manifold;
+            }
+            else if (is_single(next) && is_single(prev)) {
+                kind = VertexKind::Border;
+            }
+        }
+        // Seams have their open edges in opposite directions
+        else if (topology.wedges[wedge] == vertex
+                 && same_position(next, topology.open_prev[wedge])
+                 && same_position(prev, topology.open_next[wedge])) {
+            kind = VertexKind::Seam;
+        }
+    }
+
+    topology.triangle_offsets.assign(vertex_count + 1, 0);
+    for (const auto vertex : indices) {
+        ++topology.triangle_offsets[vertex + 1];
+    }
+    std::inclusive_scan(
+        topology.triangle_offsets.begin(),
+        topology.triangle_offsets.end(),
+        topology.triangle_offsets.begin()
+    );
+    topology.triangles.resize(indices.size());
+    std::vector<std::uint32_t> fill_offsets(
+        topology.triangle_offsets.begin(), topology.triangle_offsets.end() - 1
+    );
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        topology.triangles[fill_offsets[indices[i]]++] =
+            static_cast<std::uint32_t>(i / 3);
+    }
+    return topology;
+}
+
+//! Triangle planes and planes keeping open edges in place, per position.
+[[nodiscard]]
+std::vector<Quadric> build_quadrics(
+    std::span<const std::uint32_t> indices,
+    std::span<const Vec3> positions,
+    std::span<const std::uint32_t> position_ids,
+    std::size_t position_count,
+    const Topology& topology
+) {
+    std::vector<Quadric> quadrics(position_count);
+    for (std::size_t i = 0; i < indices.size(); i += 3) {
+        const Vec3 p0 = positions[indices[i + 0]];
+        const Vec3 p1 = positions[indices[i + 1]];
+        const Vec3 p2 = positions[indices[i + 2]];
+        const Vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const float length = glm::length(normal);
+        if (length <= 0.f) {
+            continue;
+        }
+        const Vec3 unit_normal = normal / length;
+
+        Quadric quadric;
+        quadric.add_plane(unit_normal, -glm::dot(unit_normal, p0), length * 0.5);
+        for (std::size_t k = 0; k < 3; ++k) {
+            quadrics[position_ids[indices[i + k]]] += quadric;
+        }
+
+        for (std::size_t k = 0; k < 3; ++k) {
+            const auto a = indices[i + k];
+            const auto b = indices[i + (k + 1) % 3];
+            if (topology.open_next[a] != b) {
+                continue;
+            }
+            const Vec3 edge = positions[b] - positions[a];
+            const Vec3 edge_normal = glm::cross(edge, unit_normal);
+            const float edge_length = glm::length(edge_normal);
+            if (edge_length <= 0.f) {
+                continue;
+            }
+            const double weight = (topology.kinds[a] == VertexKind::Seam)
+                ? seam_weight
+                : border_weight;
+            Quadric edge_quadric;
+            edge_quadric.add_plane(
+                edge_normal / edge_length,
+                -glm::dot(edge_normal / edge_length, positions[a]),
+                weight * glm::dot(edge, edge)
+            );
+            quadrics[position_ids[a]] += edge_quadric;
+            quadrics[position_ids[b]] += edge_quadric;
+        }
+    }
+    return quadrics;
+}
+
+} // namespace
+
+float simplify(
+    std::vector<std::uint32_t>& indices,
+    std::span<const Vertex3D> vertices,
+    const std::vector<bool>& locked,
+    std::size_t target_index_count,
+    float max_error
+) {
+    indices.resize(indices.size() - indices.size() % 3);
+    if (indices.size() <= target_index_count) {
+        return 0.f;
+    }
+
+    // Vertices at the same position share a position id
+    std::vector<std::uint32_t> position_ids(vertices.size(), none);
+    std::unordered_map<std::string_view, std::uint32_t> unique_positions;
+    for (const auto vertex : indices) {
+        if (position_ids[vertex] == none) {
+            const auto [it, inserted] = unique_positions.try_emplace(
+                position_bytes(vertices[vertex]),
+                static_cast<std::uint32_t>(unique_positions.size())
+            );
+            position_ids[vertex] = it->second;
+        }
+    }
+    const std::size_t position_count = unique_positions.size();
+
+    // Errors are computed in the unit cube for precision
+    Vec3 min = vertices[indices.front()].position;
+    Vec3 max = min;
+    for (const auto vertex : indices) {
+        min = glm::min(min, vertices[vertex].position);
+        max = glm::max(max, vertices[vertex].position);
+    }
+    const Vec3 extent = max - min;
+    const float scale = std::max({extent.x, extent.y, extent.z});
+    if (scale <= 0.f) {
+        return 0.f;
+    }
+    std::vector<Vec3> positions(vertices.size(), Vec3{0.f});
+    for (const auto vertex : indices) {
+        positions[vertex] = (vertices[vertex].position - min) / scale;
+    }
+    const float max_scaled_error = max_error / scale;
+
+    struct Collapse {
+        std::uint32_t from;
+        std::uint32_t to;
+        float error;
+    };
+    std::vector<Quadric> quadrics;
+    std::vector<Collapse> collapses;
+    std::vector<std::uint32_t> collapse_remap(vertices.size());
+    std::vector<bool> is_collapsed;
+    float result_error = 0.f;
+
+    while (indices.size() > target_index_count) {
+        const auto topology = build_topology(
+            indices, vertices.size(), position_ids, position_count, locked
+        );
+        if (quadrics.empty()) {
+            quadrics = build_quadrics(
+                indices, positions, position_ids, position_count, topology
+            );
+        }
+
+        // Vertex at the target position the other vertex of a seam collapses to
+        const auto seam_target = [&](std::uint32_t from, std::uint32_t to) {
+            const auto wedge = topology.wedges[from];
+            for (const auto vertex : {topology.open_next[wedge], topology.open_prev[wedge]}) {
+                if (is_single(vertex) && position_ids[vertex] == position_ids[to]) {
+                    return vertex;
+                }
+            }
+            return none;
+        };
+        const auto can_collapse = [&](std::uint32_t from, std::uint32_t to) {
+            if (position_ids[from] == position_ids[to]) {
+                return false;
+            }
+            const bool is_open_edge =
+                topology.open_next[from] == to || topology.open_prev[from] == to;
+            switch (topology.kinds[from]) {
+                case VertexKind::Manifold: return true;
+                case VertexKind::Border: return is_open_edge;
+                case VertexKind::Seam:
+                    return is_open_edge && seam_target(from, to) != none;
+                case VertexKind::Locked: return false;
+            }
+            return false;
+        };
+
+        collapses.clear();
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            for (std::size_t k = 0; k < 3; ++k) {
+                const auto a = indices[i + k];
+                const auto b = indices[i + (k + 1) % 3];
+                for (const auto& [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+                    if (!can_collapse(from, to)) {
+                        continue;
+                    }
+                    const double error =
+                        quadrics[position_ids[from]].error(positions[to]);
+                    collapses.push_back({from, to, float(std::sqrt(error))});
+                }
+            }
+        }
+        std::ranges::sort(collapses, {}, &Collapse::error);
+
+        // Whether moving a position to another flips any of its triangles,
+        // with this pass' collapses applied
+        const auto flips_triangles = [&](std::uint32_t from, std::uint32_t to) {
+            const auto from_id = position_ids[from];
+            const auto to_id = position_ids[to];
+            auto wedge = from;
+            do {
+                for (auto t = topology.triangle_offsets[wedge];
+                     t < topology.triangle_offsets[wedge + 1];
+                     ++t) {
+                    const std::size_t triangle = topology.triangles[t];
+                    std::array<std::uint32_t, 3> corners;
+                    for (std::size_t k = 0; k < 3; ++k) {
+                        corners[k] = collapse_remap[indices[triangle * 3 + k]];
+                    }
+                    const auto id0 = position_ids[corners[0]];
+                    const auto id1 = position_ids[corners[1]];
+                    const auto id2 = position_ids[corners[2]];
+                    // Removed by the collapse or already degenerate
+                    if (id0 == to_id || id1 == to_id || id2 == to_id ||
+                        id0 == id1 || id0 == id2 || id1 == id2) {
+                        continue;
+                    }
+                    std::array<Vec3, 3> before;
+                    std::array<Vec3, 3> after;
+                    for (std::size_t k = 0; k < 3; ++k) {
+                        before[k] = positions[corners[k]];
+                        after[k] = (position_ids[corners[k]] == from_id)
+                            ? positions[to]
+                            : before[k];
+                    }
+                    const Vec3 normal_before =
+                        glm::cross(before[1] - before[0], before[2] - before[0]);
+                    const Vec3 normal_after =
+                        glm::cross(after[1] - after[0], after[2] - after[0]);
+                    if (glm::dot(normal_before, normal_after) <= 0.f) {
+                        return true;
+                    }
+                }
+                wedge = topology.wedges[wedge];
+            } while (wedge != from);
+            return false;
+        };
+
+        // Collapse the cheapest edges, each position at most once per pass
+        std::iota(collapse_remap.begin(), collapse_remap.end(), std::uint32_t{0});
+        is_collapsed.assign(position_count, false);
+        const std::size_t triangles_to_remove =
+            (indices.size() - target_index_count + 2) / 3;
+        std::size_t removed_triangles = 0;
+        std::size_t collapse_count = 0;
+        for (const auto& collapse : collapses) {
+            if (collapse.error > max_scaled_error ||
+                removed_triangles >= triangles_to_remove) {
+                break;
+            }
+            const auto from_id = position_ids[collapse.from];
+            const auto to_id = position_ids[collapse.to];
+            if (is_collapsed[from_id] || is_collapsed[to_id] ||
+                flips_triangles(collapse.from, collapse.to)) {
+                continue;
+            }
+
+            const auto kind = topology.kinds[collapse.from];
+            collapse_remap[collapse.from] = collapse.to;
+            if (kind == VertexKind::Seam) {
+                collapse_remap[topology.wedges[collapse.from]] =
+                    seam_target(collapse.from, collapse.to);
+            }
+            quadrics[to_id] += quadrics[from_id];
+            is_collapsed[from_id] = true;
+            is_collapsed[to_id] = true;
+            removed_triangles += (kind == VertexKind::Manifold) ? 2 : 1;
+            result_error = std::max(result_error, collapse.error);
+            ++collapse_count;
+        }
+        if (collapse_count == 0) {
+            break;
+        }
+
+        // Drop triangles left without area
+        std::size_t index_count = 0;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            const auto a = collapse_remap[indices[i + 0]];
+            const auto b = collapse_remap[indices[i + 1]];
+            const auto c = collapse_remap[indices[i + 2]];
+            if (position_ids[a] == position_ids[b] ||
+                position_ids[a] == position_ids[c] ||
+                position_ids[b] == position_ids[c]) {
+                continue;
+            }
+            indices[index_count++] = a;
+            indices[index_count++] = b;
+            indices[index_count++] = c;
+        }
+        indices.resize(index_count);
+    }
+
+    return result_error * scale;
+}
+
+void generate_lods(MeshData& mesh, std::size_t lod_count) {
+    mesh.lods.clear();
+    if (lod_count == 0 || mesh.indices.empty()) {
+        return;
+    }
+    if (!mesh.has_valid_indices()) {
+        Log::warning("Skipped generating LODs for mesh with out of range indices");
+        return;
+    }
+
+    // Each submesh is simplified on its own, or the whole mesh if it has none
+    std::vector<std::vector<std::uint32_t>> levels;
+    if (mesh.submeshes.empty()) {
+        levels.push_back(mesh.indices);
+    }
+    for (const auto& submesh : mesh.submeshes) {
+        const auto first = mesh.indices.begin() + submesh.index_offset;
+        levels.emplace_back(first, first + submesh.index_count);
+    }
+
+    // Lock vertices at positions used by more than one submesh. Submeshes
+    // have vertices of their own, so their shared edges only meet by position
+    std::unordered_map<std::string_view, std::uint32_t> position_levels;
+    for (std::uint32_t level = 0; level < levels.size(); ++level) {
+        for (const auto vertex : levels[level]) {
+            const auto [it, inserted] = position_levels.try_emplace(
+                position_bytes(mesh.vertices[vertex]),
+                level
+            );
+            if (!inserted && it->second != level) {
+                it->second = many;
+            }
+        }
+    }
+    std::vector<bool> locked(mesh.vertices.size(), false);
+    for (std::uint32_t vertex = 0; vertex < mesh.vertices.size(); ++vertex) {
+        const auto it = position_levels.find(position_bytes(mesh.vertices[vertex]));
+        locked[vertex] = it != position_levels.end() && it->second == many;
+    }
+
+    Vec3 min = mesh.vertices.front().position;
+    Vec3 max = min;
+    for (const auto& vertex : mesh.vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    const float max_error = max_lod_error * glm::length(max - min) * 0.5f;
+
+    std::size_t previous_count = mesh.indices.size();
+    float error = 0.f;
+    while (mesh.lods.size() < lod_count) {
+        float level_error = 0.f;
+        std::size_t index_count = 0;
+        for (auto& indices : levels) {
+            level_error = std::max(level_error, simplify(
+                indices,
+                mesh.vertices,
+                locked,
+                indices.size() / 6 * 3,
+                max_error - error
+            ));
+            index_count += indices.size();
+        }
+        // Not worth drawing if it barely has fewer triangles
+        if (index_count == 0 || index_count * 4 > previous_count * 3) {
+            break;
+        }
+        // Errors of levels simplified from each other add up
+        error += level_error;
+
+        MeshLod lod{
+            .indices = {},
+            .submeshes = {},
+            .error = error,
+        };
+        lod.indices.reserve(index_count);
+        for (std::size_t level = 0; level < levels.size(); ++level) {
+            auto& indices = levels[level];
+            optimize_vertex_cache(indices, mesh.vertices.size());
+            if (!mesh.submeshes.empty()) {
+                lod.submeshes.push_back(Submesh{
+                    .index_offset = static_cast<std::uint32_t>(lod.indices.size()),
+                    .index_count = static_cast<std::uint32_t>(indices.size()),
+                    .material_ptr = mesh.submeshes[level].material_ptr,
+                });
+            }
+            lod.indices.insert(lod.indices.end(), indices.begin(), indices.end());
+        }
+        mesh.lods.push_back(std::move(lod));
+        previous_count = index_count;
+    }
+
+    Log::debug(
+        "Generated {} mesh LODs, {} to {} triangles",
+        mesh.lods.size(),
+        mesh.indices.size() / 3,
+        previous_count / 3
+    );
+}
+
+} // namespace kzn
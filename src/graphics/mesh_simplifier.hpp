@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/cvar.hpp"
+#include "graphics/mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace kzn {
+
+inline CVar<int> cvar_res_mesh_lods{
+    "res_mesh_lods",
+    3,
+    "Levels of detail generated for loaded meshes, each with about half the "
+    "triangles of the previous one"
+};
+
+//! Largest error of a generated level of detail, relative to the radius of
+//! the mesh. Levels stop being generated once it's reached.
+inline constexpr float max_lod_error = 0.1f;
+
+//! Simplifies a triangle list by collapsing edges in order of their quadric
+//! error (Garland and Heckbert 1997), until at most \p target_index_count
+//! indices are left or the next collapse would be over \p max_error.
+//! Open borders and attribute seams are only collapsed along themselves, and
+//! vertices in \p locked don't move.
+//! \param locked Vertices that can't be collapsed, empty or one per vertex.
+//! \return Largest error of the collapses, in position units.
+float simplify(
+    std::vector<std::uint32_t>& indices,
+    std::span<const Vertex3D> vertices,
+    const std::vector<bool>& locked,
+    std::size_t target_index_count,
+    float max_error
+);
+
+//! Replaces the levels of detail of a mesh by up to \p lod_count levels, each
+//! simplified from the previous one to half of its triangles. Vertices at
+//! positions shared by submeshes are locked so submeshes don't crack apart.
+void generate_lods(MeshData& mesh, std::size_t lod_count);
+
+} // namespace kzn
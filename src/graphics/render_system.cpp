@@ -103,6 +103,7 @@ RenderSystem::RenderSystem()
     // Listen to renderer swapchain resize event
     listen(&RenderSystem::on_swapchain_resize);
     listen(&RenderSystem::on_editor_init);
+    listen(&RenderSystem::on_resource_reloaded);
 }
 
 RenderSystem::~RenderSystem() {
@@ -113,8 +114,30 @@ RenderSystem::~RenderSystem() {
 
 void RenderSystem::update(Scene& scene, float delta_time) {
     auto& renderer = context<Renderer>();
-    // Pre-render
+
+    // Let stages recreate GPU objects made from reloaded resources, disabled
+    // stages too so they're up to date when enabled
+    if (!m_reloaded_resources.empty()) {
+        renderer.device().wait_idle();
+        for (const auto& event : m_reloaded_resources) {
+            for (auto& render_stage_ptr : m_render_stages) {
+                render_stage_ptr->on_resource_reloaded(scene, event);
+            }
+        }
+        m_reloaded_resources.clear();
+    }
+
+    // Gather enabled stages once so a stage toggled mid frame is either fully
+    // processed or skipped
+    m_enabled_stages.clear();
     for(auto& render_stage_ptr : m_render_stages) {
+        if (render_stage_ptr->is_enabled()) {
+            m_enabled_stages.push_back(render_stage_ptr.get());
+        }
+    }
+
+    // Pre-render
+    for(auto render_stage_ptr : m_enabled_stages) {
         render_stage_ptr->pre_render(scene);
     }
 
@@ -135,7 +158,7 @@ void RenderSystem::update(Scene& scene, float delta_time) {
             {clear_color, clear_depth}
         );
 
-        for(auto& render_stage_ptr : m_render_stages) {
+        for(auto render_stage_ptr : m_enabled_stages) {
             render_stage_ptr->render(scene, cmd_buffer);
         }
 
@@ -143,7 +166,7 @@ void RenderSystem::update(Scene& scene, float delta_time) {
     });
 
     // Post-render
-    for(auto& render_stage_ptr : m_render_stages) {
+    for(auto render_stage_ptr : m_enabled_stages) {
         render_stage_ptr->post_render(scene);
     }
 }
@@ -274,4 +297,9 @@ void RenderSystem::on_editor_init(const EditorInitEvent&) {
 
 }
 
+void RenderSystem::on_resource_reloaded(const ResourceReloadedEvent& event) {
+    // Handled at the start of the next frame
+    m_reloaded_resources.push_back(event);
+}
+
 } // namespace kzn
\ No newline at end of file
@@ -96,10 +96,15 @@ private:
 
     // Stages
     std::vector<std::unique_ptr<RenderStage>> m_render_stages;
+    // Stages enabled for the current frame
+    std::vector<RenderStage*> m_enabled_stages;
+    // Resources reloaded since the last frame
+    std::vector<ResourceReloadedEvent> m_reloaded_resources;
 
 private:
     void on_swapchain_resize(const SwapchainResizeEvent&);
     void on_editor_init(const EditorInitEvent&);
+    void on_resource_reloaded(const ResourceReloadedEvent&);
 };
 
 } // namespace kzn
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "renderer.hpp"
 
+#include "core/log.hpp"
 #include "events/events.hpp"
 #include "vk/utils.hpp"
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+
 namespace kzn {
 
 PerFrameData::PerFrameData(vk::Device& device, vk::CommandPool& cmd_pool)
@@ -44,14 +47,33 @@ Renderer::Renderer(Window& window)
           {
               .extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME},
               .features = {.wideLines = VK_TRUE, .samplerAnisotropy = VK_TRUE},
+              // Cooked textures
+              .optional_features = {.textureCompressionBC = VK_TRUE},
               .surface = m_surface,
           }
       )
-    , m_swapchain(m_device, m_surface, window.extent())
-    , m_cmd_pool(m_device) {
+    , m_geometry_pools(m_device)
+    , m_material_cache(m_device)
+    , m_swapchain(
+          m_device,
+          m_surface,
+          window.extent(),
+          VkPresentModeKHR(cvar_present_mode.get())
+      )
+    , m_cmd_pool(m_device)
+    , m_frames_in_flight{size_t(std::clamp(
+          cvar_frames_in_flight.get(), 1, int(MAX_FRAMES_IN_FLIGHT)
+      ))} {
+    if (cvar_frames_in_flight.get() > int(m_frames_in_flight)) {
+        Log::warning(
+            "r_frames_in_flight clamped to {}, uniform buffers are shared by "
+            "all frames",
+            m_frames_in_flight
+        );
+    }
     // Initialize Per frame data
-    m_frame_data.reserve(MAX_FRAMES_IN_FLIGHT);
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    m_frame_data.reserve(m_frames_in_flight);
+    for (size_t i = 0; i < m_frames_in_flight; ++i) {
         m_frame_data.emplace_back(device(), m_cmd_pool);
     }
     // Initialize render finished semaphores per swapchain image
@@ -61,7 +83,7 @@ Renderer::Renderer(Window& window)
         m_render_finished.push_back(vk::create_semaphore(m_device));
     }
     // Set deleter queue expiration
-    m_device.main_deletion_queue().set_expiration(MAX_FRAMES_IN_FLIGHT);
+    m_device.main_deletion_queue().set_expiration(m_frames_in_flight);
 }
 
 Renderer::~Renderer() {
@@ -77,6 +99,14 @@ void Renderer::render_frame(const RenderFrameFn& render_func) {
     // Begin Frame
     ///////////////////////////////////////////////////////////////////////////
 
+    // Apply present mode changes
+    const auto present_mode = VkPresentModeKHR(cvar_present_mode.get());
+    if (present_mode != swapchain().preferred_present_mode()) {
+        swapchain().set_preferred_present_mode(present_mode);
+        swapchain().recreate(m_window.extent());
+        EventManager::send(SwapchainResizeEvent{});
+    }
+
     auto& frame_data = m_frame_data[m_frame_idx];
 
     // Wait for previous frame
@@ -155,7 +185,7 @@ void Renderer::render_frame(const RenderFrameFn& render_func) {
     }
 
     // Increment frame in flight index
-    m_frame_idx = (m_frame_idx + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_frame_idx = (m_frame_idx + 1) % m_frames_in_flight;
     // Device deletion queue is basically a frame counter
     m_device.main_deletion_queue().increment_timer();
 }
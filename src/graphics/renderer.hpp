@@ -1,5 +1,8 @@
 #pragma once
 
+#include "core/cvar.hpp"
+#include "graphics/geometry_pool.hpp"
+#include "graphics/material3d.hpp"
 #include "vk/dset.hpp"
 #include "vk/dset_layout.hpp"
 #include <core/window.hpp>
@@ -12,6 +15,23 @@
 
 namespace kzn {
 
+//! Number of frames the CPU may record ahead of the GPU, clamped to
+//! [1, Renderer::MAX_FRAMES_IN_FLIGHT]. Only read when the renderer is
+//! created, so it must be set from the startup config file.
+//! \note Uniform buffers and their descriptor sets are shared by all frames,
+//! so the limit stays at 1 until they are duplicated per frame.
+inline CVar<int> cvar_frames_in_flight{
+    "r_frames_in_flight", 1, "Frames recorded ahead of the GPU (max 1 for now)"
+};
+
+//! Preferred swapchain present mode, as a VkPresentModeKHR value. Falls back
+//! to FIFO if not supported. Changes recreate the swapchain on the next frame.
+inline CVar<int> cvar_present_mode{
+    "r_present_mode",
+    VK_PRESENT_MODE_MAILBOX_KHR,
+    "Present mode (0: immediate, 1: mailbox, 2: fifo, 3: fifo relaxed)"
+};
+
 struct PerFrameData {
 public:
     vk::CommandBuffer cmd_buffer;
@@ -62,6 +82,14 @@ public:
     vk::Swapchain& swapchain() {
         return m_swapchain;
     }
+    [[nodiscard]]
+    GeometryPoolCache& geometry_pools() {
+        return m_geometry_pools;
+    }
+    [[nodiscard]]
+    Material3DCache& material_cache() {
+        return m_material_cache;
+    }
 
 private:
     // Members
@@ -69,13 +97,17 @@ private:
     vk::Instance m_instance;
     vk::Surface m_surface;
     vk::Device m_device;
+    GeometryPoolCache m_geometry_pools;
+    Material3DCache m_material_cache;
     vk::Swapchain m_swapchain;
     vk::CommandPool m_cmd_pool;
 
     // Synchronization data
+    // Raise once uniform buffers are duplicated per frame
     static constexpr size_t MAX_FRAMES_IN_FLIGHT = 1;
+    size_t m_frames_in_flight;
     size_t m_frame_idx = 0;
-    // Size: MAX_FRAMES_IN_FLIGHT
+    // Size: m_frames_in_flight
     std::vector<PerFrameData> m_frame_data;
     // Size: swapchain image count
     std::vector<VkSemaphore> m_render_finished;
@@ -1,75 +1,369 @@
 #include "scene3d.hpp"
 #include "graphics/material3d.hpp"
+#include "core/job_system.hpp"
+#include "graphics/gltf.hpp"
+#include "graphics/kmesh.hpp"
+#include "graphics/mesh_optimizer.hpp"
+#include "graphics/mesh_simplifier.hpp"
 #include "graphics/texture.hpp"
+#include "resources/mapped_file.hpp"
+#include "resources/resources.hpp"
 
 #include <fastgltf/core.hpp>
 #include <fastgltf/types.hpp>
-#include <fastgltf/glm_element_traits.hpp>
-#include <stb_image.h>
+#include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstring>
 #include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace kzn {
 
+namespace {
+
+//! Encoded bytes of a glTF image. Images in buffers are viewed in place, only
+//! images referenced by URI are read into \p file_bytes.
 [[nodiscard]]
-static inline TextureData load_image(fastgltf::Asset& gltf_asset, std::size_t image_idx) {
-    std::vector<std::byte> bytes;
+std::span<const std::byte> image_bytes(
+    const fastgltf::Asset& gltf_asset,
+    std::size_t image_idx,
+    std::vector<std::byte>& file_bytes
+) {
+    const auto& image = gltf_asset.images[image_idx];
 
-    fastgltf::Image* image_ptr = &gltf_asset.images[image_idx];
+    if (const auto* uri_ptr = std::get_if<fastgltf::sources::URI>(&image.data)) {
+        std::ifstream file{uri_ptr->uri.c_str(), std::ios::binary | std::ios::ate};
+        if (file) {
+            file_bytes.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0, std::ios::beg);
+            file.read(reinterpret_cast<char*>(file_bytes.data()), file_bytes.size());
+        }
+        return file_bytes;
+    }
+    if (const auto* vector_ptr = std::get_if<fastgltf::sources::Vector>(&image.data)) {
+        return vector_ptr->bytes;
+    }
+    if (const auto* array_ptr = std::get_if<fastgltf::sources::Array>(&image.data)) {
+        return {array_ptr->bytes.data(), array_ptr->bytes.size()};
+    }
+    if (const auto* view_ptr = std::get_if<fastgltf::sources::BufferView>(&image.data)) {
+        return gltf::buffer_view_bytes(gltf_asset, view_ptr->bufferViewIndex);
+    }
+    return {};
+}
 
-    if (std::holds_alternative<fastgltf::sources::URI>(image_ptr->data)) {
-        const auto& uri = std::get<fastgltf::sources::URI>(image_ptr->data);
+//! Decodes a glTF image, or reads it if it's a cooked .ktex texture.
+//! \throws LoadingError
+[[nodiscard]]
+std::shared_ptr<const TextureData> load_image(
+    const fastgltf::Asset& gltf_asset,
+    std::size_t image_idx
+) {
+    std::vector<std::byte> file_bytes;
+    return TextureData::load_from_memory(
+        image_bytes(gltf_asset, image_idx, file_bytes)
+    );
+}
 
-        std::ifstream file{uri.uri.c_str(), std::ios::binary};
-        if(file) {
-            file.seekg(0, std::ios::end);
-            const auto size = static_cast<std::size_t>(file.tellg());
-            file.seekg(0, std::ios::beg);
+//! Decodes the images at \p image_indices on the job system if there's one.
+//! Each image is decoded once, no matter how many materials use it.
+//! \throws LoadingError if any image failed to decode.
+void load_images(
+    const fastgltf::Asset& gltf_asset,
+    const std::vector<std::size_t>& image_indices,
+    std::vector<std::shared_ptr<const TextureData>>& images
+) {
+    std::vector<std::string> errors(image_indices.size());
+    // Jobs can't throw, errors are rethrown once all images are done
+    const auto decode = [&](std::size_t i) {
+        try {
+            images[image_indices[i]] = load_image(gltf_asset, image_indices[i]);
+        }
+        catch (const LoadingError& e) {
+            errors[i] = e.message;
+        }
+    };
 
-            bytes.resize(size);
-            file.read(reinterpret_cast<char*>(bytes.data()), size);
+    if (JobSystem::exists()) {
+        JobSystem::singleton().parallel_for(0, image_indices.size(), decode, 1);
+    }
+    else {
+        for (std::size_t i = 0; i < image_indices.size(); ++i) {
+            decode(i);
         }
     }
-    else if(std::holds_alternative<fastgltf::sources::Vector>(image_ptr->data)) {
-        bytes = std::get<fastgltf::sources::Vector>(image_ptr->data).bytes;
+
+    for (auto& error : errors) {
+        if (!error.empty()) {
+            throw LoadingError{std::move(error)};
+        }
     }
-    else if (std::holds_alternative<fastgltf::sources::BufferView>(image_ptr->data)) {
-        const auto& view = std::get<fastgltf::sources::BufferView>(image_ptr->data);
-        const auto& buffer_view = gltf_asset.bufferViews[view.bufferViewIndex];
-        const auto& buffer = gltf_asset.buffers[buffer_view.bufferIndex];
+}
 
-        const auto& data = std::get<fastgltf::sources::Array>(buffer.data);
-        bytes = std::vector<std::byte>(
-            data.bytes.begin() + buffer_view.byteOffset,
-            data.bytes.begin() + buffer_view.byteOffset + buffer_view.byteLength
-        );
+//! Image index of a material texture slot, if it has one.
+template<typename TextureInfoOpt>
+[[nodiscard]]
+std::optional<std::size_t> texture_image_index(
+    const fastgltf::Asset& gltf_asset,
+    const TextureInfoOpt& texture_info_opt
+) {
+    if (!texture_info_opt.has_value()) {
+        return std::nullopt;
     }
+    const auto& texture = gltf_asset.textures[texture_info_opt->textureIndex];
+    if (!texture.imageIndex.has_value()) {
+        return std::nullopt;
+    }
+    return texture.imageIndex.value();
+}
+
+//! Copies \p count values from the front of \p bytes and advances past them.
+//! \throws LoadingError if \p bytes is too small.
+template<typename T>
+[[nodiscard]]
+std::vector<T> read_array(std::span<const std::byte>& bytes, std::uint64_t count) {
+    if (count > bytes.size() / sizeof(T)) {
+        throw LoadingError{"Truncated kmesh scene"};
+    }
+    std::vector<T> values(count);
+    std::memcpy(values.data(), bytes.data(), count * sizeof(T));
+    bytes = bytes.subspan(count * sizeof(T));
+    return values;
+}
 
-    // Decode image format
-    int width;
-    int height;
-    int channels;
-    unsigned char* result_ptr = stbi_load_from_memory(
-        reinterpret_cast<const stbi_uc*>(bytes.data()),
-        static_cast<int>(bytes.size()),
-        &width, &height, &channels,
-        STBI_rgb_alpha
+//! Reads a cooked .kmesh scene. Geometry is copied from the mapped file as
+//! is, only textures are loaded, on the job system if there's one.
+//! \throws LoadingError
+[[nodiscard]]
+std::shared_ptr<Scene3DData> read_kmesh(const std::filesystem::path& path) {
+    static_assert(
+        sizeof(Vertex3D) == 11 * sizeof(float),
+        "Vertices are stored as is, they can't have padding"
+    );
+    const MappedFile file{path};
+    auto bytes = file.bytes();
+    const auto invalid_kmesh = [&](std::string_view reason) {
+        return LoadingError{
+            fmt::format("Invalid kmesh '{}': {}", path.c_str(), reason)
+        };
+    };
+
+    const auto header = read_array<kmesh::Header>(bytes, 1).front();
+    if (header.magic != kmesh::magic) {
+        throw invalid_kmesh("not a kmesh file");
+    }
+    if (header.version != kmesh::version) {
+        throw invalid_kmesh(fmt::format("unsupported version {}", header.version));
+    }
+    const auto mesh_entries = read_array<kmesh::MeshEntry>(bytes, header.mesh_count);
+    const auto lod_entries = read_array<kmesh::LodEntry>(bytes, header.lod_count);
+    const auto submesh_entries =
+        read_array<kmesh::SubmeshEntry>(bytes, header.submesh_count);
+    const auto material_entries =
+        read_array<kmesh::MaterialEntry>(bytes, header.material_count);
+    if (header.vertex_count > bytes.size() / sizeof(Vertex3D) ||
+        header.index_count >
+            (bytes.size() - header.vertex_count * sizeof(Vertex3D)) / sizeof(std::uint32_t) ||
+        header.string_size != bytes.size() - header.vertex_count * sizeof(Vertex3D)
+            - header.index_count * sizeof(std::uint32_t)) {
+        throw invalid_kmesh("truncated");
+    }
+    const auto vertex_bytes = bytes.first(header.vertex_count * sizeof(Vertex3D));
+    const auto index_bytes = bytes.subspan(
+        vertex_bytes.size(), header.index_count * sizeof(std::uint32_t)
     );
+    const std::string_view strings{
+        reinterpret_cast<const char*>(bytes.data() + vertex_bytes.size() + index_bytes.size()),
+        header.string_size
+    };
+
+    auto scene3d_ptr = std::make_shared<Scene3DData>();
+
+    // Textures, each path loaded once
+    std::vector<std::string_view> image_paths;
+    std::vector<std::array<std::optional<std::size_t>, 4>> material_images;
+    material_images.reserve(material_entries.size());
+    for (const auto& material_entry : material_entries) {
+        auto& slots = material_images.emplace_back();
+        for (std::size_t slot = 0; slot < slots.size(); ++slot) {
+            const auto& ref = material_entry.textures[slot];
+            if (ref.size == 0) {
+                continue;
+            }
+            if (ref.offset > strings.size() || ref.size > strings.size() - ref.offset) {
+                throw invalid_kmesh("texture path out of bounds");
+            }
+            const auto image_path = strings.substr(ref.offset, ref.size);
+            auto it = std::ranges::find(image_paths, image_path);
+            slots[slot] = static_cast<std::size_t>(it - image_paths.begin());
+            if (it == image_paths.end()) {
+                image_paths.push_back(image_path);
+            }
+        }
+    }
+
+    // Textures go through the resource cache, relative to the asset path of
+    // the scene so they come from the same archive. Reloads only know the
+    // file of the scene.
+    const auto scene_asset_path = ResourceCache::loading_path();
+    const auto texture_path = [&](std::string_view image_path) {
+        if (scene_asset_path.empty()) {
+            return (path.parent_path() / image_path).string();
+        }
+        const auto dir_size = scene_asset_path.rfind('/') + 1;
+        return fmt::format("{}{}", scene_asset_path.substr(0, dir_size), image_path);
+    };
+    scene3d_ptr->images.resize(image_paths.size());
+    std::vector<std::string> errors(image_paths.size());
+    // Jobs can't throw, errors are rethrown once all textures are done
+    const auto load_texture = [&](std::size_t i) {
+        try {
+            scene3d_ptr->images[i] =
+                g_resources.load<TextureData>(texture_path(image_paths[i]));
+        }
+        catch (const LoadingError& e) {
+            errors[i] = e.message;
+        }
+    };
+    if (JobSystem::exists()) {
+        JobSystem::singleton().parallel_for(0, image_paths.size(), load_texture, 1);
+    }
+    else {
+        for (std::size_t i = 0; i < image_paths.size(); ++i) {
+            load_texture(i);
+        }
+    }
+    for (auto& error : errors) {
+        if (!error.empty()) {
+            throw LoadingError{std::move(error)};
+        }
+    }
+
+    scene3d_ptr->materials.reserve(material_images.size());
+    for (const auto& slots : material_images) {
+        const auto image = [&](std::size_t slot) {
+            return slots[slot].has_value()
+                ? scene3d_ptr->images[*slots[slot]]
+                : nullptr;
+        };
+        scene3d_ptr->materials.push_back(std::make_shared<const MaterialData>(
+            image(0), image(1), image(2), image(3)
+        ));
+    }
 
-    if (result_ptr == nullptr) {
-        throw LoadingError{stbi_failure_reason()};
+    // Geometry
+    scene3d_ptr->meshes.resize(mesh_entries.size());
+    for (std::size_t mesh_idx = 0; mesh_idx < mesh_entries.size(); ++mesh_idx) {
+        const auto& mesh_entry = mesh_entries[mesh_idx];
+        auto& mesh = scene3d_ptr->meshes[mesh_idx];
+        if (std::uint64_t{mesh_entry.first_vertex} + mesh_entry.vertex_count > header.vertex_count ||
+            mesh_entry.lod_count == 0 ||
+            std::uint64_t{mesh_entry.first_lod} + mesh_entry.lod_count > lod_entries.size()) {
+            throw invalid_kmesh("mesh out of bounds");
+        }
+        mesh.vertices.resize(mesh_entry.vertex_count);
+        std::memcpy(
+            mesh.vertices.data(),
+            vertex_bytes.data() + std::size_t{mesh_entry.first_vertex} * sizeof(Vertex3D),
+            mesh.vertices.size() * sizeof(Vertex3D)
+        );
+        mesh.bounds_min = Vec3{
+            mesh_entry.bounds_min[0], mesh_entry.bounds_min[1], mesh_entry.bounds_min[2]
+        };
+        mesh.bounds_max = Vec3{
+            mesh_entry.bounds_max[0], mesh_entry.bounds_max[1], mesh_entry.bounds_max[2]
+        };
+
+        for (std::uint32_t lod = 0; lod < mesh_entry.lod_count; ++lod) {
+            const auto& lod_entry = lod_entries[mesh_entry.first_lod + lod];
+            if (std::uint64_t{lod_entry.first_index} + lod_entry.index_count > header.index_count ||
+                std::uint64_t{lod_entry.first_submesh} + mesh_entry.submesh_count
+                    > submesh_entries.size()) {
+                throw invalid_kmesh("level of detail out of bounds");
+            }
+            std::vector<std::uint32_t> indices(lod_entry.index_count);
+            std::memcpy(
+                indices.data(),
+                index_bytes.data() + std::size_t{lod_entry.first_index} * sizeof(std::uint32_t),
+                indices.size() * sizeof(std::uint32_t)
+            );
+            std::vector<Submesh> submeshes;
+            submeshes.reserve(mesh_entry.submesh_count);
+            for (std::uint32_t i = 0; i < mesh_entry.submesh_count; ++i) {
+                const auto& submesh_entry = submesh_entries[lod_entry.first_submesh + i];
+                if (submesh_entry.material != kmesh::no_material &&
+                    submesh_entry.material >= scene3d_ptr->materials.size()) {
+                    throw invalid_kmesh("material out of bounds");
+                }
+                submeshes.push_back(Submesh{
+                    .index_offset = submesh_entry.index_offset,
+                    .index_count = submesh_entry.index_count,
+                    .material_ptr = (submesh_entry.material != kmesh::no_material)
+                        ? scene3d_ptr->materials[submesh_entry.material]
+                        : nullptr,
+                });
+            }
+
+            // The first level is the mesh itself
+            if (lod == 0) {
+                mesh.indices = std::move(indices);
+                mesh.submeshes = std::move(submeshes);
+            }
+            else {
+                mesh.lods.push_back(MeshLod{
+                    .indices = std::move(indices),
+                    .submeshes = std::move(submeshes),
+                    .error = lod_entry.error,
+                });
+            }
+        }
+        if (!mesh.has_valid_indices()) {
+            throw invalid_kmesh("index out of bounds");
+        }
     }
 
-    return TextureData(result_ptr, Vec3u{width, height, 1});
+    return scene3d_ptr;
+}
+
+} // namespace
+
+std::size_t Scene3DData::byte_size() const {
+    std::size_t size = 0;
+    for (const auto& mesh : meshes) {
+        size += mesh.vertices.size() * sizeof(Vertex3D)
+            + mesh.indices.size() * sizeof(std::uint32_t);
+        for (const auto& lod : mesh.lods) {
+            size += lod.indices.size() * sizeof(std::uint32_t);
+        }
+    }
+    // Shared images are counted once, not once per material
+    for (const auto& image_ptr : images) {
+        if (image_ptr != nullptr) {
+            size += image_ptr->byte_size();
+        }
+    }
+    return size;
 }
 
 std::shared_ptr<Scene3DData> Scene3DData::load(const std::filesystem::path& path) {
+    if (path.extension() == ".kmesh") {
+        return read_kmesh(path);
+    }
+
     auto& path_str = path.native();
     if(!path_str.ends_with(".gltf") && !path_str.ends_with(".glb")) {
-        Log::error("Unsupported Scene3D format");
-        return nullptr;
+        throw LoadingError{
+            fmt::format("Unsupported Scene3D format '{}'", path.extension().native())
+        };
     }
 
     // Map gltf file
@@ -94,121 +388,91 @@ std::shared_ptr<Scene3DData> Scene3DData::load(const std::filesystem::path& path
 
     auto scene3d_ptr = std::make_shared<Scene3DData>();
 
-    scene3d_ptr->meshes.resize(gltf_asset.meshes.size());
-    for(std::size_t i = 0; i < gltf_asset.meshes.size(); ++i) {
-        fastgltf::Mesh& gltf_mesh = gltf_asset.meshes[i];
-        auto& vertices = scene3d_ptr->meshes[i].vertices;
-        auto& indices = scene3d_ptr->meshes[i].indices;
-
-        for(auto& primitive : gltf_mesh.primitives) {
-            
-            ///////////////////////////////////////////////////////////////////
-            // Load primitive vertex data
-            ///////////////////////////////////////////////////////////////////
-
-            // TODO: Store primitive.type
-            // TODO: Store attributes layout
-            // TODO: Load material textures
-            
-            // Load indices
-            if (primitive.indicesAccessor.has_value()) {
-                auto& accessor = gltf_asset.accessors[primitive.indicesAccessor.value()];
-                indices.resize(accessor.count);
-                fastgltf::iterateAccessorWithIndex<std::uint32_t>(
-                    gltf_asset,
-                    accessor,
-                    [&indices](std::uint32_t i, std::size_t idx) {
-                        indices[idx] = i;
-                    }
-                );
-            }
+    scene3d_ptr->materials.resize(gltf_asset.materials.size());
+    scene3d_ptr->images.resize(gltf_asset.images.size());
 
-            // Load vertex positions
-            const auto& pos_accessor = gltf_asset.accessors[primitive.findAttribute("POSITION")->accessorIndex];
-            vertices.resize(pos_accessor.count);
-            fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                gltf_asset,
-                pos_accessor,
-                [&vertices](glm::vec3 pos, std::size_t idx) {
-                    vertices[idx].position = pos;
-                }
-            );
+    ///////////////////////////////////////////////////////////////////////////
+    // Load materials used by meshes
+    ///////////////////////////////////////////////////////////////////////////
 
-            // Load vertex normals
-            auto normals = primitive.findAttribute("NORMAL");
-            if (normals != primitive.attributes.end()) {
-                fastgltf::iterateAccessorWithIndex<glm::vec3>(
-                    gltf_asset,
-                    gltf_asset.accessors[normals->accessorIndex],
-                    [&vertices](glm::vec3 normal, std::size_t idx) {
-                        vertices[idx].normal = normal;
-                    }
-                );
+    // Texture slots of a material, in MaterialData order
+    const auto material_images = [&gltf_asset](const fastgltf::Material& material) {
+        return std::array{
+            texture_image_index(gltf_asset, material.pbrData.baseColorTexture),
+            texture_image_index(gltf_asset, material.normalTexture),
+            texture_image_index(gltf_asset, material.pbrData.metallicRoughnessTexture),
+            texture_image_index(gltf_asset, material.occlusionTexture),
+        };
+    };
+
+    std::vector<bool> is_material_used(gltf_asset.materials.size(), false);
+    for (const auto& gltf_mesh : gltf_asset.meshes) {
+        for (const auto& primitive : gltf_mesh.primitives) {
+            if (primitive.materialIndex.has_value()) {
+                is_material_used[*primitive.materialIndex] = true;
             }
+        }
+    }
 
-            // Load vertex texture coordinates
-            auto tex_coords = primitive.findAttribute("TEXCOORD_0");
-            if (tex_coords != primitive.attributes.end()) {
-                fastgltf::iterateAccessorWithIndex<glm::vec2>(
-                    gltf_asset,
-                    gltf_asset.accessors[tex_coords->accessorIndex],
-                    [&vertices](glm::vec2 uv, std::size_t idx) {
-                        vertices[idx].uv = uv;
-                    }
-                );
+    std::vector<bool> is_image_used(gltf_asset.images.size(), false);
+    std::vector<std::size_t> image_indices;
+    for (std::size_t material_idx = 0; material_idx < is_material_used.size(); ++material_idx) {
+        if (!is_material_used[material_idx]) {
+            continue;
+        }
+        const auto& material = gltf_asset.materials[material_idx];
+        for (const auto& image_idx_opt : material_images(material)) {
+            if (image_idx_opt.has_value() && !is_image_used[*image_idx_opt]) {
+                is_image_used[*image_idx_opt] = true;
+                image_indices.push_back(*image_idx_opt);
             }
+        }
+    }
 
-            ///////////////////////////////////////////////////////////////////
-            // Load primitive material data
-            ///////////////////////////////////////////////////////////////////
-            
-            if (primitive.materialIndex.has_value()) {
-                const auto& material = gltf_asset.materials[*primitive.materialIndex];
-
-                scene3d_ptr->meshes[i].material_opt = MaterialData{};
-                auto& material_data = *scene3d_ptr->meshes[i].material_opt;
-                
-                // Load albedo image
-                if(material.pbrData.baseColorTexture.has_value()) {
-                    const auto& texture = gltf_asset.textures[
-                        material.pbrData.baseColorTexture->textureIndex
-                    ];
-                    if (texture.imageIndex.has_value()) {
-                        material_data.albedo_opt = load_image(gltf_asset, texture.imageIndex.value());
-                    }
-                }
+    load_images(gltf_asset, image_indices, scene3d_ptr->images);
 
-                // Load normal map image
-                if(material.normalTexture.has_value()) {
-                    const auto& texture = gltf_asset.textures[
-                        material.normalTexture->textureIndex
-                    ];
-                    if (texture.imageIndex.has_value()) {
-                        material_data.normal_opt = load_image(gltf_asset, texture.imageIndex.value());
-                    }
-                }
+    for (std::size_t material_idx = 0; material_idx < is_material_used.size(); ++material_idx) {
+        if (!is_material_used[material_idx]) {
+            continue;
+        }
+        const auto slots = material_images(gltf_asset.materials[material_idx]);
+        const auto image = [&](std::size_t slot) {
+            return slots[slot].has_value()
+                ? scene3d_ptr->images[*slots[slot]]
+                : nullptr;
+        };
+        scene3d_ptr->materials[material_idx] = std::make_shared<const MaterialData>(
+            image(0), image(1), image(2), image(3)
+        );
+    }
 
-                // Load metallic roughness image
-                if(material.pbrData.metallicRoughnessTexture.has_value()) {
-                    const auto& texture = gltf_asset.textures[
-                        material.pbrData.metallicRoughnessTexture->textureIndex
-                    ];
-                    if (texture.imageIndex.has_value()) {
-                        material_data.metallic_roughness_opt = load_image(gltf_asset, texture.imageIndex.value());
-                    }
-                }
+    ///////////////////////////////////////////////////////////////////////////
+    // Load meshes
+    ///////////////////////////////////////////////////////////////////////////
 
-                // Load occlusion map image
-                if(material.occlusionTexture.has_value()) {
-                    const auto& texture = gltf_asset.textures[
-                        material.occlusionTexture->textureIndex
-                    ];
-                    if (texture.imageIndex.has_value()) {
-                        material_data.occlusion_opt = load_image(gltf_asset, texture.imageIndex.value());
-                    }
-                }
-            }
+    // TODO: Store attributes layout
+    scene3d_ptr->meshes.reserve(gltf_asset.meshes.size());
+    for (const auto& gltf_mesh : gltf_asset.meshes) {
+        scene3d_ptr->meshes.push_back(
+            gltf::read_mesh(gltf_asset, gltf_mesh, scene3d_ptr->materials)
+        );
+    }
+
+    const auto process_mesh = [](MeshData& mesh) {
+        if (cvar_res_optimize_meshes.get()) {
+            optimize_mesh(mesh);
         }
+        mesh.compute_bounds();
+        generate_lods(mesh, std::max(cvar_res_mesh_lods.get(), 0));
+    };
+    auto& meshes = scene3d_ptr->meshes;
+    if (JobSystem::exists()) {
+        JobSystem::singleton().parallel_for(0, meshes.size(), [&](std::size_t i) {
+            process_mesh(meshes[i]);
+        }, 1);
+    }
+    else {
+        std::ranges::for_each(meshes, process_mesh);
     }
 
     return scene3d_ptr;
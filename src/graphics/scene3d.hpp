@@ -2,6 +2,7 @@
 
 #include "mesh.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -9,7 +10,20 @@ namespace kzn {
 
 struct Scene3DData {
     std::vector<MeshData> meshes;
+    //! Materials by glTF material index, shared by the meshes that use them.
+    //! Materials no mesh uses aren't loaded and are nullptr.
+    std::vector<std::shared_ptr<const MaterialData>> materials;
+    //! Decoded images by glTF image index, shared by the materials that use
+    //! them. Images no material uses aren't decoded and are nullptr.
+    std::vector<std::shared_ptr<const TextureData>> images;
 
+    //! Size of all mesh data and images in bytes.
+    [[nodiscard]]
+    std::size_t byte_size() const;
+
+    //! Loads a glTF scene, or reads a scene cooked by mesh_cooker if the
+    //! extension is .kmesh.
+    //! \throws LoadingError
     [[nodiscard]]
     static std::shared_ptr<Scene3DData> load(const std::filesystem::path& path);
 };
@@ -0,0 +1,95 @@
+#include "skyline_packer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace kzn {
+
+SkylinePacker::SkylinePacker(Vec2u extent)
+    : m_extent{extent}
+{
+    clear();
+}
+
+std::optional<Vec2u> SkylinePacker::pack(Vec2u size) {
+    if (size.x == 0 || size.y == 0 || size.x > m_extent.x || size.y > m_extent.y) {
+        return std::nullopt;
+    }
+
+    // Lowest top over all positions starting at a segment, ties go to the
+    // narrowest segment so wide ones stay available for wide rectangles
+    std::size_t best_idx = m_skyline.size();
+    std::uint32_t best_top = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t best_width = std::numeric_limits<std::uint32_t>::max();
+    for (std::size_t i = 0; i < m_skyline.size(); ++i) {
+        const auto x = m_skyline[i].x;
+        if (x + size.x > m_extent.x) {
+            break;
+        }
+        // Rests on the highest segment under it
+        std::uint32_t y = 0;
+        for (std::size_t j = i; j < m_skyline.size() && m_skyline[j].x < x + size.x; ++j) {
+            y = std::max(y, m_skyline[j].y);
+        }
+        const auto top = y + size.y;
+        if (top > m_extent.y) {
+            continue;
+        }
+        if (top < best_top || (top == best_top && m_skyline[i].width < best_width)) {
+            best_idx = i;
+            best_top = top;
+            best_width = m_skyline[i].width;
+        }
+    }
+    if (best_idx == m_skyline.size()) {
+        return std::nullopt;
+    }
+
+    // Raise the skyline over the rectangle, trimming the segments it covers
+    const auto x = m_skyline[best_idx].x;
+    const auto right = x + size.x;
+    auto end_idx = best_idx;
+    while (end_idx < m_skyline.size() && m_skyline[end_idx].x < right) {
+        ++end_idx;
+    }
+    auto& last = m_skyline[end_idx - 1];
+    const auto last_right = last.x + last.width;
+    if (last_right > right) {
+        // Part of the last segment sticks out to the right
+        last.width = last_right - right;
+        last.x = right;
+        --end_idx;
+    }
+    m_skyline.erase(m_skyline.begin() + best_idx, m_skyline.begin() + end_idx);
+    m_skyline.insert(
+        m_skyline.begin() + best_idx,
+        Segment{.x = x, .y = best_top, .width = size.x}
+    );
+
+    // Merge neighbours of the same height
+    for (std::size_t i = (best_idx > 0 ? best_idx - 1 : 0);
+         i + 1 < m_skyline.size() && i <= best_idx + 1;) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else {
+            ++i;
+        }
+    }
+
+    m_used_area += std::uint64_t{size.x} * size.y;
+    return Vec2u{x, best_top - size.y};
+}
+
+void SkylinePacker::clear() {
+    m_skyline.assign(1, Segment{.x = 0, .y = 0, .width = m_extent.x});
+    m_used_area = 0;
+}
+
+float SkylinePacker::occupancy() const {
+    const auto area = std::uint64_t{m_extent.x} * m_extent.y;
+    return area == 0 ? 0.f : float(double(m_used_area) / double(area));
+}
+
+} // namespace kzn
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "math/types.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace kzn {
+
+//! Packs rectangles into a fixed size area, such as an atlas page, without
+//! them overlapping. It only does the bookkeeping, the owner of the area
+//! places its rectangles where it's told.
+//!
+//! The packed area is described by its skyline, the top edge of the
+//! rectangles packed so far from left to right. Each rectangle is placed on
+//! the skyline where its top ends lowest, so rows of similar heights fill up
+//! before new ones start. Space under the skyline is never reused, packing
+//! larger rectangles first wastes less of it.
+class SkylinePacker {
+public:
+    // Ctor
+    explicit SkylinePacker(Vec2u extent);
+    // Copy
+    SkylinePacker(const SkylinePacker&) = default;
+    SkylinePacker& operator=(const SkylinePacker&) = default;
+    // Move
+    SkylinePacker(SkylinePacker&&) = default;
+    SkylinePacker& operator=(SkylinePacker&&) = default;
+    // Dtor
+    ~SkylinePacker() = default;
+
+    //! Position of the top left corner of a rectangle of \p size, or nullopt
+    //! if there's no room left for it.
+    [[nodiscard]]
+    std::optional<Vec2u> pack(Vec2u size);
+
+    //! Makes the whole area free again.
+    void clear();
+
+    [[nodiscard]]
+    Vec2u extent() const {
+        return m_extent;
+    }
+    //! Fraction of the area covered by packed rectangles.
+    [[nodiscard]]
+    float occupancy() const;
+
+private:
+    //! Horizontal span of the skyline at height `y`.
+    struct Segment {
+        std::uint32_t x;
+        std::uint32_t y;
+        std::uint32_t width;
+    };
+
+private:
+    Vec2u m_extent;
+    std::uint64_t m_used_area = 0;
+    //! Segments by x, covering the whole width without gaps.
+    std::vector<Segment> m_skyline;
+};
+
+} // namespace kzn
@@ -0,0 +1,235 @@
+#include "sprite_atlas.hpp"
+
+#include "core/assert.hpp"
+#include "core/log.hpp"
+#include "resources/resources.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+namespace kzn {
+
+namespace {
+
+constexpr std::size_t pixel_size = 4;
+
+//! Copies an RGBA8 texture into a page at \p position, surrounded by
+//! \p padding pixels repeating its edges.
+void blit_padded(
+    std::vector<unsigned char>& page_pixels,
+    std::uint32_t page_width,
+    const TextureData& texture,
+    Vec2u position,
+    std::uint32_t padding
+) {
+    const auto width = texture.extent.x;
+    const auto height = texture.extent.y;
+    for (std::uint32_t y = 0; y < height + 2 * padding; ++y) {
+        const auto src_y = std::clamp(y, padding, height + padding - 1) - padding;
+        const auto* src_row = texture.bytes + std::size_t{src_y} * width * pixel_size;
+        auto* dst_row = page_pixels.data()
+            + (std::size_t{position.y + y} * page_width + position.x) * pixel_size;
+        std::memcpy(dst_row + padding * pixel_size, src_row, width * pixel_size);
+        for (std::uint32_t x = 0; x < padding; ++x) {
+            std::memcpy(dst_row + x * pixel_size, src_row, pixel_size);
+            std::memcpy(
+                dst_row + (padding + width + x) * pixel_size,
+                src_row + (width - 1) * pixel_size,
+                pixel_size
+            );
+        }
+    }
+}
+
+} // namespace
+
+SpriteAtlas::SpriteAtlas(Renderer& renderer)
+    : m_renderer_ptr{&renderer}
+{
+}
+
+AtlasRegion SpriteAtlas::find_or_add(
+    Handle<TextureData> handle,
+    const TextureData& texture
+) {
+    if (const auto it = m_regions.find(key(handle)); it != m_regions.end()) {
+        return it->second;
+    }
+
+    const Vec2u size{texture.extent.x, texture.extent.y};
+    const bool is_packable = texture.format == TextureFormat::Rgba8
+        && texture.mip_levels == 1
+        && texture.is_srgb
+        && texture.extent.z == 1
+        && size.x > 0
+        && size.y > 0
+        && size.x <= max_packed_size
+        && size.y <= max_packed_size;
+    if (!is_packable) {
+        const auto page = add_page(
+            std::nullopt,
+            {},
+            g_resources.profile_upload(&texture, [&] {
+                return create_texture_image(m_renderer_ptr->device(), texture);
+            })
+        );
+        m_pages[page]->region_count = 1;
+        m_pages[page]->is_uploaded = true;
+        const auto region = AtlasRegion{
+            .page = page,
+            .uv_offset = Vec2{0.f, 0.f},
+            .uv_size = Vec2{1.f, 1.f},
+        };
+        m_regions.emplace(key(handle), region);
+        m_handles.emplace(key(handle), handle);
+        return region;
+    }
+
+    // First shared page with room for the texture and its padding
+    const Vec2u padded_size = size + Vec2u{2 * padding};
+    std::optional<std::uint32_t> page_opt;
+    std::optional<Vec2u> position_opt;
+    for (std::uint32_t i = 0; i < m_pages.size() && !position_opt; ++i) {
+        if (m_pages[i] != nullptr && m_pages[i]->packer_opt.has_value()) {
+            position_opt = m_pages[i]->packer_opt->pack(padded_size);
+            page_opt = i;
+        }
+    }
+    if (!position_opt.has_value()) {
+        page_opt = add_page(
+            SkylinePacker(Vec2u{page_size}),
+            std::vector<unsigned char>(std::size_t{page_size} * page_size * pixel_size),
+            vk::Image(
+                m_renderer_ptr->device(),
+                VkExtent3D{page_size, page_size, 1},
+                VK_FORMAT_R8G8B8A8_SRGB
+            )
+        );
+        Log::debug("Sprite atlas page {} created", *page_opt);
+        position_opt = m_pages[*page_opt]->packer_opt->pack(padded_size);
+        KZN_ASSERT(position_opt.has_value());
+    }
+
+    auto& page = *m_pages[*page_opt];
+    blit_padded(page.pixels, page_size, texture, *position_opt, padding);
+    page.region_count += 1;
+    page.dirty_rects.push_back(VkRect2D{
+        .offset = {int32_t(position_opt->x), int32_t(position_opt->y)},
+        .extent = {padded_size.x, padded_size.y},
+    });
+    page.dirty_handles.push_back(handle);
+    const auto region = AtlasRegion{
+        .page = *page_opt,
+        .uv_offset = Vec2{*position_opt + Vec2u{padding}} / float(page_size),
+        .uv_size = Vec2{size} / float(page_size),
+    };
+    m_regions.emplace(key(handle), region);
+    m_handles.emplace(key(handle), handle);
+    return region;
+}
+
+void SpriteAtlas::remove(Handle<TextureData> handle) {
+    const auto it = m_regions.find(key(handle));
+    if (it == m_regions.end()) {
+        return;
+    }
+    const auto page_idx = it->second.page;
+    m_regions.erase(it);
+    m_handles.erase(key(handle));
+
+    auto& page_ptr = m_pages[page_idx];
+    page_ptr->region_count -= 1;
+    if (page_ptr->region_count > 0) {
+        return;
+    }
+    // Shared pages are kept for the next textures, others are freed
+    if (page_ptr->packer_opt.has_value()) {
+        page_ptr->packer_opt->clear();
+    }
+    else {
+        page_ptr.reset();
+    }
+}
+
+void SpriteAtlas::remove_released() {
+    std::vector<Handle<TextureData>> released;
+    for (const auto& [_, handle] : m_handles) {
+        if (g_resources.get(handle) == nullptr) {
+            released.push_back(handle);
+        }
+    }
+    for (const auto handle : released) {
+        remove(handle);
+    }
+}
+
+void SpriteAtlas::upload() {
+    for (auto& page_ptr : m_pages) {
+        if (page_ptr == nullptr || page_ptr->dirty_rects.empty()) {
+            continue;
+        }
+        const auto upload_begin = std::chrono::steady_clock::now();
+        if (page_ptr->is_uploaded) {
+            page_ptr->image.upload_regions(
+                page_ptr->pixels.data(), page_ptr->dirty_rects
+            );
+        }
+        else {
+            // Not sampled by any frame yet
+            page_ptr->image.upload(page_ptr->pixels.data());
+            page_ptr->is_uploaded = true;
+        }
+        const float upload_ms = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - upload_begin
+        ).count();
+
+        const auto area = [](const VkRect2D& rect) {
+            return float(rect.extent.width) * float(rect.extent.height);
+        };
+        float dirty_area = 0.f;
+        for (const auto& rect : page_ptr->dirty_rects) {
+            dirty_area += area(rect);
+        }
+        for (std::size_t i = 0; i < page_ptr->dirty_handles.size(); ++i) {
+            // Released before its upload
+            const auto* texture_ptr = g_resources.get(page_ptr->dirty_handles[i]);
+            if (texture_ptr != nullptr) {
+                g_resources.add_upload_time(
+                    texture_ptr,
+                    upload_ms * area(page_ptr->dirty_rects[i]) / dirty_area
+                );
+            }
+        }
+        page_ptr->dirty_rects.clear();
+        page_ptr->dirty_handles.clear();
+    }
+}
+
+std::uint32_t SpriteAtlas::add_page(
+    std::optional<SkylinePacker> packer_opt,
+    std::vector<unsigned char> pixels,
+    vk::Image image
+) {
+    auto& device = m_renderer_ptr->device();
+    auto page_ptr = std::make_unique<Page>(Page{
+        .packer_opt = std::move(packer_opt),
+        .pixels = std::move(pixels),
+        .image = std::move(image),
+        .dset = device.dset_allocator().allocate(
+            device.dset_layout_cache().layout({vk::sampler_binding(0)})
+        ),
+    });
+    page_ptr->dset.update({page_ptr->image.info()});
+
+    const auto free_it = std::ranges::find(m_pages, nullptr);
+    if (free_it != m_pages.end()) {
+        *free_it = std::move(page_ptr);
+        return static_cast<std::uint32_t>(free_it - m_pages.begin());
+    }
+    m_pages.push_back(std::move(page_ptr));
+    return static_cast<std::uint32_t>(m_pages.size() - 1);
+}
+
+} // namespace kzn
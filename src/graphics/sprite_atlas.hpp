@@ -0,0 +1,130 @@
+#pragma once
+
+#include "graphics/renderer.hpp"
+#include "graphics/skyline_packer.hpp"
+#include "graphics/texture.hpp"
+#include "math/types.hpp"
+#include "resources/handle.hpp"
+#include "vk/dset.hpp"
+#include "vk/image.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+//! Where a texture is in the sprite atlas.
+struct AtlasRegion {
+    std::uint32_t page;
+    //! Normalized offset and size of the texture in the page.
+    Vec2 uv_offset;
+    Vec2 uv_size;
+};
+
+//! Combines sprite textures into shared pages, so that sprites drawn one
+//! after another only switch descriptor sets when their textures are in
+//! different pages. Textures are packed into pages as they're first used.
+//!
+//! Textures too large to share a page, or that aren't single mip sRGB RGBA8,
+//! get a page of their own. Textures are removed once their handle is
+//! released, as long as it's acquired their region is kept for every material
+//! using it. Space of removed textures is only reused once all the textures
+//! of its page were removed.
+class SpriteAtlas {
+public:
+    //! Width and height of shared pages.
+    static constexpr std::uint32_t page_size = 2048;
+    //! Largest width or height of a texture packed into a shared page.
+    static constexpr std::uint32_t max_packed_size = 512;
+    //! Edge pixels repeated around packed textures, so that filtering doesn't
+    //! blend in their neighbours.
+    static constexpr std::uint32_t padding = 1;
+
+public:
+    // Ctor
+    SpriteAtlas(Renderer& renderer);
+    // Copy
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+    // Move
+    SpriteAtlas(SpriteAtlas&&) = delete;
+    SpriteAtlas& operator=(SpriteAtlas&&) = delete;
+    // Dtor
+    ~SpriteAtlas() = default;
+
+    //! Region of a texture, added to the atlas the first time.
+    //! \note Shared pages are uploaded by `upload()`.
+    [[nodiscard]]
+    AtlasRegion find_or_add(Handle<TextureData> handle, const TextureData& texture);
+
+    //! Forgets a texture, so that it's added again the next time, such as
+    //! after it was reloaded. Does nothing if it isn't in the atlas.
+    void remove(Handle<TextureData> handle);
+
+    //! Forgets the textures whose handles were released since, freeing their
+    //! space like `remove()`.
+    void remove_released();
+
+    //! Uploads the textures packed into shared pages since the last call.
+    //! New pages are uploaded whole, pages in use only where textures were
+    //! packed, after the frames in flight are done sampling them. The upload
+    //! time of a page is split between its textures by area.
+    void upload();
+
+    //! Descriptor set sampling a page.
+    [[nodiscard]]
+    vk::DescriptorSet& dset(std::uint32_t page) {
+        return m_pages[page]->dset;
+    }
+
+    [[nodiscard]]
+    std::size_t page_count() const {
+        return m_pages.size();
+    }
+
+private:
+    struct Page {
+        //! Packer and pixels of shared pages, nullopt for pages of a single
+        //! texture.
+        std::optional<SkylinePacker> packer_opt;
+        std::vector<unsigned char> pixels;
+        vk::Image image;
+        vk::DescriptorSet dset;
+        std::size_t region_count = 0;
+        //! Whether the image was uploaded whole once, after which only the
+        //! rectangles of newly packed textures are uploaded.
+        bool is_uploaded = false;
+        std::vector<VkRect2D> dirty_rects;
+        //! Textures packed into each dirty rectangle, the time to upload the
+        //! page is added to their load records.
+        std::vector<Handle<TextureData>> dirty_handles;
+    };
+
+private:
+    //! Index of a new page with \p image, reusing the slot of a freed page.
+    [[nodiscard]]
+    std::uint32_t add_page(
+        std::optional<SkylinePacker> packer_opt,
+        std::vector<unsigned char> pixels,
+        vk::Image image
+    );
+
+    [[nodiscard]]
+    static std::uint64_t key(Handle<TextureData> handle) {
+        return (std::uint64_t{handle.index()} << 32) | handle.generation();
+    }
+
+private:
+    Renderer* m_renderer_ptr;
+    //! Null for freed pages of a single texture, so page indices stay valid.
+    std::vector<std::unique_ptr<Page>> m_pages;
+    std::unordered_map<std::uint64_t, AtlasRegion> m_regions;
+    //! Handles of the textures in the atlas, to find released ones.
+    std::unordered_map<std::uint64_t, Handle<TextureData>> m_handles;
+};
+
+} // namespace kzn
@@ -5,6 +5,8 @@
 #include "core/type.hpp"
 #include "graphics/renderer.hpp"
 #include "vk/buffer.hpp"
+#include "vk/vertex_layout.hpp"
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -14,10 +16,23 @@ namespace kzn {
 
 //! Vertex unit used for 2D rendering
 struct Vertex2D {
-    //! x and y components are positional, z is used for depth sorting.
-    Vec3 position;
-    //! Maps texture to the vertices
-    Vec2 tex_coords;
+    //! x and y components, depth comes from the sprite transform.
+    Vec2 position;
+    //! Maps texture to the vertices, as 16 bit unorm.
+    std::array<std::uint16_t, 2> tex_coords;
+
+    //! Vertex input layout, 12 bytes per vertex.
+    [[nodiscard]]
+    static const vk::VertexLayout& layout() {
+        static const auto vertex_layout = vk::VertexLayout{
+            .stride = sizeof(Vertex2D),
+            .attributes = {
+                {VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex2D, position)},
+                {VK_FORMAT_R16G16_UNORM, offsetof(Vertex2D, tex_coords)},
+            },
+        };
+        return vertex_layout;
+    }
 };
 
 struct SpriteGeometry {
@@ -67,14 +82,13 @@ public:
                 vk::VertexBuffer(m_renderer_ptr->device(), sizeof(Vertex2D) * 4);
 
             // Upload quad vertex data to vertex buffer in the Gpu
-            const Vec3 centered_offset = {width / 2.f, height / 2.f, 0.f};
+            const Vec2 centered_offset = {width / 2.f, height / 2.f};
+            constexpr std::uint16_t one = 0xffff;
             const std::array vertices{
-                Vertex2D{Vec3{0, height, 0.f} - centered_offset, Vec2{0, 1}},
-                Vertex2D{Vec3{0, 0, 0.f} - centered_offset, Vec2{0, 0}},
-                Vertex2D{
-                    Vec3{width, height, 0.f} - centered_offset, Vec2{1, 1}
-                },
-                Vertex2D{Vec3{width, 0, 0.f} - centered_offset, Vec2{1, 0}}
+                Vertex2D{Vec2{0, height} - centered_offset, {0, one}},
+                Vertex2D{Vec2{0, 0} - centered_offset, {0, 0}},
+                Vertex2D{Vec2{width, height} - centered_offset, {one, one}},
+                Vertex2D{Vec2{width, 0} - centered_offset, {one, 0}}
             };
             quad_vbo.upload(static_cast<const void*>(vertices.data()));
 
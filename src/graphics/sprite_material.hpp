@@ -1,13 +1,9 @@
 #pragma once
 
-#include "graphics/renderer.hpp"
+#include "graphics/sprite_atlas.hpp"
 #include "graphics/texture.hpp"
 #include "math/types.hpp"
 #include "resources/resources.hpp"
-#include "vk/buffer.hpp"
-#include "vk/dset.hpp"
-#include "vk/image.hpp"
-#include "vk/uniform.hpp"
 
 #include <memory>
 #include <optional>
@@ -15,64 +11,56 @@
 
 namespace kzn {
 
-struct SpriteUniformData {
-    glsl::Vec4 slice;
-    glsl::Vec4 overlap_color;
-};
-
 struct SpriteMaterialRenderData {
-    SpriteMaterialRenderData(
-        Renderer& renderer,
-        std::shared_ptr<TextureData>& texture_ptr,
-        Vec2 slice_offset,
-        Vec2 slice_size,
-        Vec4 overlap_color
-    )
-        : material_dset{renderer.device().dset_allocator().allocate(
-              renderer.device().dset_layout_cache().layout({
-                  vk::sampler_binding(0),
-                  vk::uniform_binding(1),
-              })
-          )}
-        , albedo_image(renderer.device(), texture_ptr->vk_extent())
-        , material_ubo{renderer.device(), sizeof(SpriteUniformData)} {
-        // Upload texture data to gpu image memory
-        albedo_image.upload(texture_ptr->bytes);
-        // Update material dset and upload data
-        material_dset.update({albedo_image.info(), material_ubo.info()});
-        material_ubo.upload(SpriteUniformData{
-            glsl::Vec4{
-                slice_offset.x, slice_offset.y, slice_size.x, slice_size.y
-            },
-            overlap_color
-        });
-    }
-
-    ~SpriteMaterialRenderData() {}
-
-    vk::DescriptorSet material_dset;
-    vk::Image albedo_image;
-    vk::UniformBuffer material_ubo;
+    //! Where the texture of the material is in the sprite atlas.
+    AtlasRegion region;
 };
 
 //! Sprite texture and parameters to use in shader
 class SpriteMaterial {
 public:
     // Ctor
-    SpriteMaterial(std::shared_ptr<TextureData> albedo_ptr)
-        : m_texture_ptr(std::move(albedo_ptr)) {}
+    //! Takes ownership of an acquired texture handle.
+    SpriteMaterial(Handle<TextureData> albedo)
+        : m_texture(albedo) {}
+    // Copy
+    SpriteMaterial(const SpriteMaterial&) = delete;
+    SpriteMaterial& operator=(const SpriteMaterial&) = delete;
+    // Move
+    SpriteMaterial(SpriteMaterial&&) = delete;
+    SpriteMaterial& operator=(SpriteMaterial&&) = delete;
     // Dtor
-    ~SpriteMaterial() = default;
+    ~SpriteMaterial() {
+        g_resources.release(m_texture);
+    }
 
     void set_slice(Vec2 offset, Vec2 size) {
         m_slice_offset = offset;
         m_slice_size = size;
-        m_was_modified = true;
     }
 
     void set_overlap_color(Vec4 overlap_color) {
         m_overlap_color = overlap_color;
-        m_was_modified = true;
+    }
+
+    //! Normalized offset and size of the part of the texture drawn.
+    [[nodiscard]]
+    Vec2 slice_offset() const {
+        return m_slice_offset;
+    }
+    [[nodiscard]]
+    Vec2 slice_size() const {
+        return m_slice_size;
+    }
+
+    [[nodiscard]]
+    Vec4 overlap_color() const {
+        return m_overlap_color;
+    }
+
+    [[nodiscard]]
+    Handle<TextureData> texture() const {
+        return m_texture;
     }
 
     [[nodiscard]]
@@ -80,40 +68,23 @@ public:
         return m_render_data_opt.has_value();
     }
 
-    void create_render_data(Renderer& renderer) {
-        m_render_data_opt.emplace(
-            renderer, m_texture_ptr, m_slice_offset, m_slice_size, m_overlap_color
-        );
-        m_was_modified = false;
+    void create_render_data(SpriteAtlas& atlas) {
+        m_render_data_opt.emplace(SpriteMaterialRenderData{
+            .region = atlas.find_or_add(m_texture, *g_resources.get(m_texture)),
+        });
     }
 
     void destroy_render_data() { m_render_data_opt = std::nullopt; }
 
-    void update_render_data() {
-        if (m_was_modified) {
-            m_render_data_opt->material_ubo.upload(SpriteUniformData{
-                glsl::Vec4{
-                    m_slice_offset.x,
-                    m_slice_offset.y,
-                    m_slice_size.x,
-                    m_slice_size.y
-                },
-                m_overlap_color
-            });
-            m_was_modified = false;
-        }
-    }
-
     std::optional<SpriteMaterialRenderData>& render_data() {
         return m_render_data_opt;
     }
 
 private:
-    std::shared_ptr<TextureData> m_texture_ptr;
+    Handle<TextureData> m_texture;
     Vec2 m_slice_offset = {0, 0};
     Vec2 m_slice_size = {1, 1};
     Vec4 m_overlap_color = {0, 0, 0, 0};
-    bool m_was_modified = false;
     std::optional<SpriteMaterialRenderData> m_render_data_opt = std::nullopt;
 };
 
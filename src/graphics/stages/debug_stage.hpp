@@ -30,16 +30,23 @@ public:
         , m_camera_dset_ptr{&camera_dset}
         , m_debug_render(renderer) {}
 
-    bool is_enabled() const { return m_use_debug_render; }
-    void enable(bool enable) { m_use_debug_render = enable; }
+    bool is_enabled() const override { return cvar_r_debug.get(); }
+    void enable(bool enable) { cvar_r_debug.set(enable); }
+
+    void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) override {
+        if (m_debug_pipeline.uses_shader(event.as<vk::ShaderCode>())) {
+            m_debug_pipeline.rebuild();
+        }
+    }
 
     void render(Scene& scene, vk::CommandBuffer& cmd_buffer) override {
         // Create debug line render vbo
-        auto debug_vbo_opt = m_use_debug_render
-                                 ? m_debug_render.create_debug_vbo()
-                                 : std::nullopt;
+        auto debug_vbo_opt = m_debug_render.create_debug_vbo();
 
-        if (m_use_debug_render && debug_vbo_opt.has_value()) {
+        if (debug_vbo_opt.has_value()) {
             auto& debug_render = m_debug_render.value();
             auto& debug_vbo = debug_vbo_opt.value();
             vk::cmd_bind_pipeline(cmd_buffer, m_debug_pipeline);
@@ -79,7 +86,6 @@ public:
 private:
     Renderer* m_renderer_ptr;
     vk::Pipeline m_debug_pipeline;
-    bool m_use_debug_render = false;
     vk::DescriptorSet* m_camera_dset_ptr;
     // Debug render interface
     Context<DebugRender> m_debug_render;
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "core/assert.hpp"
+#include "graphics/camera.hpp"
 #include "graphics/mesh.hpp"
+#include "graphics/scene3d.hpp"
 #include "graphics/renderer.hpp"
 #include "graphics/stages/render_stage.hpp"
 #include "math/transform.hpp"
@@ -13,7 +15,11 @@
 #include <glm/trigonometric.hpp>
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <optional>
+#include <string_view>
 
 namespace kzn {
 
@@ -24,6 +30,18 @@ const Vec3 cyan =   Vec3{0.22, 0.88, 0.88};
 const Vec3 pink =   Vec3{0.88, 0.22, 0.88};
 const Vec3 yellow = Vec3{0.88, 0.88, 0.22};
 
+inline CVar<bool> cvar_r_geometry{"r_geometry", true, "Render 3D geometry"};
+inline CVar<bool> cvar_r_lod{
+    "r_lod",
+    true,
+    "Draw meshes at a level of detail picked from their size on screen"
+};
+inline CVar<float> cvar_r_lod_error{
+    "r_lod_error",
+    1.f,
+    "Largest error in pixels of the level of detail meshes are drawn at"
+};
+
 class GeometryStage
     : public RenderStage
     , public EventListener {
@@ -35,18 +53,8 @@ public:
         vk::DescriptorSet& camera_dset
     )
         : m_renderer_ptr{&renderer}
-        , m_pipeline{
-            vk::PipelineBuilder(render_pass)
-                .set_vertex_stage(load_shader("shaders://pbr/pbr.vert.spv"))
-                .set_fragment_stage(load_shader("shaders://pbr/pbr.frag.spv"))
-                .set_vertex_input<Vec3,Vec3,Vec2,Vec3>()
-                .set_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
-                .set_cull_mode(VK_CULL_MODE_BACK_BIT)
-                .set_front_face(VK_FRONT_FACE_COUNTER_CLOCKWISE)
-                .set_depth_test(true)
-                .set_depth_write(true)
-                .build(renderer.device())
-        }
+        , m_render_pass_ptr{&render_pass}
+        , m_pipeline{build_pipeline(VertexFormat::Float)}
         , m_light_ubo(renderer.device(), sizeof(Lights))
         , m_camera_dset_ptr{&camera_dset}
         , m_light_dset{renderer.device().dset_allocator().allocate(
@@ -61,6 +69,34 @@ public:
         m_lights_changed = true;
     }
 
+    bool is_enabled() const override { return cvar_r_geometry.get(); }
+
+    void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) override {
+        if (m_pipeline.uses_shader(event.as<vk::ShaderCode>())) {
+            m_pipeline.rebuild();
+        }
+        if (m_packed_pipeline_opt.has_value() &&
+            m_packed_pipeline_opt->uses_shader(event.as<vk::ShaderCode>())) {
+            m_packed_pipeline_opt->rebuild();
+        }
+        const auto* scene3d_ptr = event.as<Scene3DData>();
+        if (scene3d_ptr == nullptr) {
+            return;
+        }
+        auto meshes_view = scene.registry.registry().view<MeshComponent>();
+        for (auto [entity, mesh] : meshes_view->each()) {
+            if (mesh.source() == scene3d_ptr) {
+                mesh.reload(
+                    m_renderer_ptr->geometry_pools(),
+                    m_renderer_ptr->material_cache()
+                );
+            }
+        }
+    }
+
     void pre_render(Scene& scene) override {
         if(m_lights_changed) {
             // Gather lights data
@@ -79,19 +115,33 @@ public:
             m_light_ubo.upload(m_lights);
             m_lights_changed = false;
         }
+
+        select_lods(scene);
     }
     
     void render(Scene& scene, vk::CommandBuffer& cmd_buffer) override {
-        vk::cmd_bind_pipeline(cmd_buffer, m_pipeline);
         const auto swapchain_extent = m_renderer_ptr->swapchain().extent();
-        vk::cmd_set_viewport(cmd_buffer, vk::create_viewport(swapchain_extent));
-        vk::cmd_set_scissor(cmd_buffer, vk::create_scissor(swapchain_extent));
+        vk::Pipeline* bound_pipeline_ptr = nullptr;
+        const vk::VertexBuffer* bound_vtx_buffer_ptr = nullptr;
 
         auto meshes_view = scene.registry.registry().view<MeshComponent>();
         for (auto [entity, mesh] : meshes_view->each()) {
-            // Bind buffers
-            vk::cmd_bind_vtx_buffer(cmd_buffer, mesh.mesh().vtx_buffer());
-            vk::cmd_bind_idx_buffer(cmd_buffer, mesh.mesh().idx_buffer());
+            // Rebind only when the vertex format changes
+            auto& pipeline = this->pipeline(mesh.mesh().vtx_format());
+            if (&pipeline != bound_pipeline_ptr) {
+                vk::cmd_bind_pipeline(cmd_buffer, pipeline);
+                vk::cmd_set_viewport(cmd_buffer, vk::create_viewport(swapchain_extent));
+                vk::cmd_set_scissor(cmd_buffer, vk::create_scissor(swapchain_extent));
+                bound_pipeline_ptr = &pipeline;
+            }
+
+            // Meshes share the buffers of their pool block, rebind only when
+            // the block changes
+            if (&mesh.mesh().vtx_buffer() != bound_vtx_buffer_ptr) {
+                vk::cmd_bind_vtx_buffer(cmd_buffer, mesh.mesh().vtx_buffer());
+                vk::cmd_bind_idx_buffer(cmd_buffer, mesh.mesh().idx_buffer());
+                bound_vtx_buffer_ptr = &mesh.mesh().vtx_buffer();
+            }
             
             struct TransformPushData {
                 glsl::Mat4 matrix = {1.f};
@@ -101,24 +151,125 @@ public:
             if (transform_ptr != nullptr) {
                 transform.matrix = transform_ptr->matrix();
             }
-            KZN_ASSERT_MSG(mesh.material() != std::nullopt, "Mesh must have material");
-            vk::cmd_bind_dsets(
-                cmd_buffer,
-                std::array{
-                    m_camera_dset_ptr,
-                    &m_light_dset,
-                    &mesh.material()->dset
-                },
-                m_pipeline.layout()
+            if (mesh.mesh().vtx_format() == VertexFormat::Packed) {
+                transform.matrix = transform.matrix * mesh.mesh().dequantize_matrix();
+            }
+            vk::cmd_push_constants(cmd_buffer, pipeline.layout(), transform);
+
+            // Draw each submesh with its material
+            for (std::size_t i = 0; i < mesh.submeshes().size(); ++i) {
+                const auto& submesh = mesh.submeshes()[i];
+                auto* material_ptr = mesh.material(i);
+                KZN_ASSERT_MSG(material_ptr != nullptr, "Mesh must have material");
+                vk::cmd_bind_dsets(
+                    cmd_buffer,
+                    std::array{
+                        m_camera_dset_ptr,
+                        &m_light_dset,
+                        &material_ptr->dset
+                    },
+                    pipeline.layout()
+                );
+                vk::cmd_draw_indexed(
+                    cmd_buffer,
+                    submesh.index_count,
+                    1,
+                    mesh.mesh().first_index() + submesh.index_offset,
+                    mesh.mesh().base_vertex()
+                );
+            }
+        }
+    }
+
+private:
+    //! Picks the level of detail of each mesh from the size its bounds
+    //! project to on screen.
+    void select_lods(Scene& scene) {
+        auto& registry = scene.registry.registry();
+        const Camera3DComponent* camera_ptr = nullptr;
+        for (auto [entity, camera] : registry.view<Camera3DComponent>().each()) {
+            camera_ptr = &camera;
+            break;
+        }
+
+        auto meshes_view = registry.view<MeshComponent>();
+        if (!cvar_r_lod.get() || camera_ptr == nullptr) {
+            // Full meshes, no level's error is under an infinite size
+            for (auto [entity, mesh] : meshes_view->each()) {
+                mesh.select_lod(std::numeric_limits<float>::infinity(), 0.f, 0.f);
+            }
+            return;
+        }
+
+        // Pixels a unit projects to at a distance of 1
+        const float viewport_height =
+            float(m_renderer_ptr->swapchain().extent().height);
+        const float projection_scale = viewport_height
+            / (2.f * std::tan(glm::radians(camera_ptr->fov_v) * 0.5f));
+        for (auto [entity, mesh] : meshes_view->each()) {
+            Mat4 matrix{1.f};
+            const auto* transform_ptr = registry.try_get<Transform3DComponent>(entity);
+            if (transform_ptr != nullptr) {
+                matrix = transform_ptr->matrix();
+            }
+            const Vec3 center = Vec3{matrix * Vec4{mesh.bounds_center(), 1.f}};
+            const float scale = std::max({
+                glm::length(Vec3{matrix[0]}),
+                glm::length(Vec3{matrix[1]}),
+                glm::length(Vec3{matrix[2]}),
+            });
+            const float distance = std::max(
+                glm::distance(center, camera_ptr->position)
+                    - mesh.bounds_radius() * scale,
+                camera_ptr->near
+            );
+            mesh.select_lod(
+                scale * projection_scale / distance,
+                cvar_r_lod_error.get(),
+                lod_hysteresis
             );
-            vk::cmd_push_constants(cmd_buffer, m_pipeline.layout(), transform);
-            vk::cmd_draw_indexed(cmd_buffer, mesh.mesh().idx_count());
         }
     }
 
+    [[nodiscard]]
+    vk::Pipeline build_pipeline(VertexFormat format) {
+        const std::string_view vertex_shader_path = (format == VertexFormat::Packed)
+            ? "shaders://pbr/pbr_packed.vert.spv"
+            : "shaders://pbr/pbr.vert.spv";
+        return vk::PipelineBuilder(*m_render_pass_ptr)
+            .set_vertex_stage(load_shader(vertex_shader_path))
+            .set_fragment_stage(load_shader("shaders://pbr/pbr.frag.spv"))
+            .set_vertex_input(vertex_layout(format))
+            .set_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+            .set_cull_mode(VK_CULL_MODE_BACK_BIT)
+            .set_front_face(VK_FRONT_FACE_COUNTER_CLOCKWISE)
+            .set_depth_test(true)
+            .set_depth_write(true)
+            .build(m_renderer_ptr->device());
+    }
+
+    //! Pipeline drawing vertices of a format, the packed variant is only
+    //! built once a packed mesh is drawn.
+    [[nodiscard]]
+    vk::Pipeline& pipeline(VertexFormat format) {
+        if (format == VertexFormat::Float) {
+            return m_pipeline;
+        }
+        if (!m_packed_pipeline_opt.has_value()) {
+            m_packed_pipeline_opt.emplace(build_pipeline(VertexFormat::Packed));
+        }
+        return *m_packed_pipeline_opt;
+    }
+
 private:
+    //! Fraction of the error threshold a mesh must get under to switch to a
+    //! coarser level of detail.
+    static constexpr float lod_hysteresis = 0.25f;
+
     Renderer* m_renderer_ptr;
+    vk::RenderPass* m_render_pass_ptr;
     vk::Pipeline m_pipeline;
+    std::optional<vk::Pipeline> m_packed_pipeline_opt;
     vk::UniformBuffer m_light_ubo;
     vk::DescriptorSet* m_camera_dset_ptr;
     vk::DescriptorSet m_light_dset;
@@ -14,6 +14,8 @@
 
 namespace kzn {
 
+inline CVar<bool> cvar_r_planet{"r_planet", true, "Render planet"};
+
 class PlanetStage : public RenderStage {
 public:
     // Ctor
@@ -38,14 +40,32 @@ public:
         , m_earth_dset{renderer.device().dset_allocator().allocate(
             *m_pipeline.dset_layout(1)
         )}
-        , m_earth_image(renderer.device(), m_earth_tex_ptr->vk_extent())
+        , m_earth_image{g_resources.profile_upload(m_earth_tex_ptr.get(), [&] {
+            return create_texture_image(renderer.device(), *m_earth_tex_ptr);
+        })}
     {
-        // Upload texture data to gpu image memory
-        m_earth_image.upload(m_earth_tex_ptr->bytes);
         // Update dset and upload data
         m_earth_dset.update({m_earth_image.info()});
     }
 
+    bool is_enabled() const override { return cvar_r_planet.get(); }
+
+    void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) override {
+        if (m_pipeline.uses_shader(event.as<vk::ShaderCode>())) {
+            m_pipeline.rebuild();
+        }
+        if (event.as<TextureData>() == m_earth_tex_ptr.get()) {
+            // Texture size may have changed
+            m_earth_image = create_texture_image(
+                m_renderer_ptr->device(), *m_earth_tex_ptr
+            );
+            m_earth_dset.update({m_earth_image.info()});
+        }
+    }
+
     void render(Scene& scene, vk::CommandBuffer& cmd_buffer) override {
         vk::cmd_bind_pipeline(cmd_buffer, m_pipeline);
         const auto swapchain_extent = m_renderer_ptr->swapchain().extent();
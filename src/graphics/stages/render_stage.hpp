@@ -1,28 +1,45 @@
 #pragma once
 
+#include "core/cvar.hpp"
 #include "ecs/scene.hpp"
+#include "events/events.hpp"
 #include "graphics/texture.hpp"
 #include "resources/resources.hpp"
 #include "vk/cmd_buffer.hpp"
 #include "vk/shader_code.hpp"
 
 #include <memory>
+#include <source_location>
 
 namespace kzn {
 
 // FIXME: Temporary util function
-inline std::shared_ptr<vk::ShaderCode> load_shader(const std::string_view path) {
-    return g_resources.load<vk::ShaderCode>(path);
+inline std::shared_ptr<vk::ShaderCode> load_shader(
+    const AssetPath path,
+    const std::source_location call_site = std::source_location::current()
+) {
+    return g_resources.load<vk::ShaderCode>(path, call_site);
 }
-inline std::shared_ptr<TextureData> load_texture(const std::string_view path) {
-    return g_resources.load<TextureData>(path);
+inline std::shared_ptr<TextureData> load_texture(
+    const AssetPath path,
+    const std::source_location call_site = std::source_location::current()
+) {
+    return g_resources.load<TextureData>(path, call_site);
 }
 
 struct RenderStage {
     virtual ~RenderStage() {}
+    //! Disabled stages are skipped entirely by the render system.
+    virtual bool is_enabled() const { return true; }
     virtual void pre_render(Scene& scene) {}
     virtual void render(Scene& scene, vk::CommandBuffer& cmd_buffer) = 0;
     virtual void post_render(Scene& scene) {}
+    //! Called at the start of a frame for each resource reloaded since the
+    //! last frame, with the device idle, to recreate what was created from it.
+    virtual void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) {}
 };
 
 } // namespace kzn
\ No newline at end of file
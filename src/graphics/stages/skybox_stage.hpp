@@ -12,8 +12,13 @@
 #include "vk/pipeline_builder.hpp"
 #include "vk/render_pass.hpp"
 
+#include <array>
+#include <optional>
+
 namespace kzn {
 
+inline CVar<bool> cvar_r_skybox{"r_skybox", true, "Render skybox"};
+
 class SkyboxStage : public RenderStage {
 public:
     // Ctor
@@ -35,34 +40,76 @@ public:
         }
         , m_camera_dset_ptr{&camera_dset}
         , m_skybox_tex{
-            load_texture("textures://skybox/space0.png"),
-            load_texture("textures://skybox/space1.png"),
-            load_texture("textures://skybox/space2.png"),
-            load_texture("textures://skybox/space3.png"),
-            load_texture("textures://skybox/space4.png"),
-            load_texture("textures://skybox/space5.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space0.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space1.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space2.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space3.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space4.png"),
+            g_resources.load_async<TextureData>("textures://skybox/space5.png"),
         }
         , m_skybox_dset{renderer.device().dset_allocator().allocate(
             *m_pipeline.dset_layout(1)
-        )}
-        , m_skybox_image(renderer.device(), m_skybox_tex[0]->vk_extent())
-    {
+        )} {}
+
+    bool is_enabled() const override { return cvar_r_skybox.get(); }
+
+    void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) override {
+        if (m_pipeline.uses_shader(event.as<vk::ShaderCode>())) {
+            m_pipeline.rebuild();
+        }
+        const auto* texture_ptr = event.as<TextureData>();
+        for (const auto& tex : m_skybox_tex) {
+            if (texture_ptr != nullptr && tex.get().get() == texture_ptr) {
+                // Created again on pre_render
+                m_skybox_image_opt = std::nullopt;
+                break;
+            }
+        }
+    }
+
+    void pre_render(Scene& scene) override {
+        if (m_skybox_image_opt.has_value() || m_skybox_failed) {
+            return;
+        }
+        // Textures are loaded in the background, create the cube image once
+        // all faces are ready
+        for (const auto& tex : m_skybox_tex) {
+            if (tex.has_failed()) {
+                Log::error("Skybox disabled: {}", tex.error());
+                m_skybox_failed = true;
+                return;
+            }
+            if (!tex.is_ready()) {
+                return;
+            }
+        }
+
+        m_skybox_image_opt.emplace(
+            m_renderer_ptr->device(), m_skybox_tex[0].get()->vk_extent()
+        );
         // Upload texture data to gpu image memory
-        m_skybox_image.upload(
+        m_skybox_image_opt->upload(
             (const void*[6]) {
-                m_skybox_tex[0]->bytes,
-                m_skybox_tex[1]->bytes,
-                m_skybox_tex[2]->bytes,
-                m_skybox_tex[3]->bytes,
-                m_skybox_tex[4]->bytes,
-                m_skybox_tex[5]->bytes
+                m_skybox_tex[0].get()->bytes,
+                m_skybox_tex[1].get()->bytes,
+                m_skybox_tex[2].get()->bytes,
+                m_skybox_tex[3].get()->bytes,
+                m_skybox_tex[4].get()->bytes,
+                m_skybox_tex[5].get()->bytes
             }
         );
         // Update dset and upload data
-        m_skybox_dset.update({m_skybox_image.info()});
+        m_skybox_dset.update({m_skybox_image_opt->info()});
     }
 
     void render(Scene& scene, vk::CommandBuffer& cmd_buffer) override {
+        if (!m_skybox_image_opt.has_value()) {
+            return;
+        }
+
         vk::cmd_bind_pipeline(cmd_buffer, m_pipeline);
         const auto swapchain_extent = m_renderer_ptr->swapchain().extent();
         vk::cmd_set_viewport(cmd_buffer, vk::create_viewport(swapchain_extent));
@@ -82,9 +129,10 @@ private:
     Renderer* m_renderer_ptr;
     vk::Pipeline m_pipeline;
     vk::DescriptorSet* m_camera_dset_ptr;
-    std::array<std::shared_ptr<TextureData>, 6> m_skybox_tex;
+    std::array<AsyncResource<TextureData>, 6> m_skybox_tex;
     vk::DescriptorSet m_skybox_dset;
-    vk::CubeImage m_skybox_image;
+    std::optional<vk::CubeImage> m_skybox_image_opt;
+    bool m_skybox_failed = false;
 };
 
 } // namespace kzn
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/type.hpp"
 #include "ecs/entity.hpp"
 #include "graphics/renderer.hpp"
+#include "graphics/sprite_atlas.hpp"
 #include "graphics/sprite_component.hpp"
 #include "graphics/stages/render_stage.hpp"
 #include "math/transform.hpp"
@@ -12,18 +13,24 @@
 #include "vk/pipeline_builder.hpp"
 #include "vk/render_pass.hpp"
 
+#include <cstdint>
+#include <optional>
+
 namespace kzn {
 
+inline CVar<bool> cvar_r_sprites{"r_sprites", true, "Render sprites"};
+
 class SpriteStage : public RenderStage {
 public:
     // Ctor
     SpriteStage(Renderer& renderer, vk::RenderPass& render_pass, vk::DescriptorSet& camera_dset)
         : m_renderer_ptr{&renderer}
         , m_sprite_geom_cache{renderer}
+        , m_sprite_atlas{renderer}
         , m_pipeline{vk::PipelineBuilder(render_pass)
             .set_vertex_stage(load_shader("shaders://sprites/sprite_render.vert.spv"))
             .set_fragment_stage(load_shader("shaders://sprites/sprite_render.frag.spv"))
-            .set_vertex_input<Vec3, Vec2>()
+            .set_vertex_input(Vertex2D::layout())
             .set_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP)
             .build(renderer.device())
         }
@@ -41,7 +48,34 @@ public:
         m_sprite_geom_cache.clear();
     }
 
+    bool is_enabled() const override { return cvar_r_sprites.get(); }
+
+    void on_resource_reloaded(
+        Scene& scene,
+        const ResourceReloadedEvent& event
+    ) override {
+        if (m_pipeline.uses_shader(event.as<vk::ShaderCode>())) {
+            m_pipeline.rebuild();
+        }
+        const auto* texture_ptr = event.as<TextureData>();
+        if (texture_ptr == nullptr) {
+            return;
+        }
+        // Render data is created again on pre_render, with the texture packed
+        // again into the atlas
+        auto sprites_view = scene.registry.registry().view<SpriteComponent>();
+        for (auto [entity, sprite] : sprites_view->each()) {
+            if (g_resources.get(sprite.material()->texture()) == texture_ptr) {
+                m_sprite_atlas.remove(sprite.material()->texture());
+                sprite.material()->destroy_render_data();
+            }
+        }
+    }
+
     void pre_render(Scene& scene) override {
+        // Free the atlas space of textures no material uses anymore
+        m_sprite_atlas.remove_released();
+
         auto sprites_view = scene.registry.registry().view<SpriteComponent>();
         for (auto [entity, sprite] : sprites_view->each()) {
             if (sprite.geometry() == nullptr) {
@@ -49,15 +83,11 @@ public:
             }
 
             if (!sprite.material()->has_render_data()) {
-                sprite.material()->create_render_data(*m_renderer_ptr);
+                sprite.material()->create_render_data(m_sprite_atlas);
             }
-
-            // Properties of materials can be changed multiple times per frame
-            // but uploading those changes is only done once. update_render_data
-            // checks if the material was modified before uploading data to the
-            // GPU.
-            sprite.material()->update_render_data();
         }
+        // Atlas pages that new textures were packed into
+        m_sprite_atlas.upload();
     }
 
     void render(Scene& scene, vk::CommandBuffer& cmd_buffer) override {
@@ -71,7 +101,10 @@ public:
             cmd_buffer, vk::create_scissor(swapchain_extent)
         );
 
-        // Render sprite components
+        // Render sprite components, switching atlas page and geometry only
+        // when they change between sprites
+        std::optional<std::uint32_t> bound_page_opt;
+        const SpriteGeometry* bound_geometry_ptr = nullptr;
         auto sprites_view = scene.registry.registry().view<SpriteComponent>();
         for (auto [entity, sprite] : sprites_view.each()) {
             Mat4 transform_mat{};
@@ -83,26 +116,42 @@ public:
                 transform_mat = transform_ptr->matrix();
             }
 
-            vk::cmd_bind_dsets(
-                cmd_buffer,
-                std::array{
-                    m_camera_dset_ptr,
-                    &sprite.material()->render_data()->material_dset
-                },
-                m_pipeline.layout()
-            );
+            auto& material = *sprite.material();
+            const auto& region = material.render_data()->region;
+            if (region.page != bound_page_opt) {
+                vk::cmd_bind_dsets(
+                    cmd_buffer,
+                    std::array{
+                        m_camera_dset_ptr,
+                        &m_sprite_atlas.dset(region.page)
+                    },
+                    m_pipeline.layout()
+                );
+                bound_page_opt = region.page;
+            }
 
-            struct PvmPushData {
+            // Slice of the texture within its region of the atlas page
+            struct SpritePushData {
                 Mat4 matrix;
-            } pvm = {
-                transform_mat 
+                Vec4 uv_rect;
+                Vec4 overlap_color;
+            } sprite_data = {
+                transform_mat,
+                Vec4{
+                    region.uv_offset + material.slice_offset() * region.uv_size,
+                    material.slice_size() * region.uv_size
+                },
+                material.overlap_color()
             };
             vk::cmd_push_constants(
-                cmd_buffer, m_pipeline.layout(), pvm
+                cmd_buffer, m_pipeline.layout(), sprite_data
             );
 
             // Bind vertex buffer
-            vk::cmd_bind_vtx_buffer(cmd_buffer, sprite.geometry()->quad_vbo);
+            if (sprite.geometry().get() != bound_geometry_ptr) {
+                vk::cmd_bind_vtx_buffer(cmd_buffer, sprite.geometry()->quad_vbo);
+                bound_geometry_ptr = sprite.geometry().get();
+            }
 
             // Draw call
             vk::cmd_draw(cmd_buffer, 4);
@@ -112,6 +161,7 @@ public:
 private:
     Renderer* m_renderer_ptr;
     SpriteGeometryCache m_sprite_geom_cache;
+    SpriteAtlas m_sprite_atlas;
     vk::Pipeline m_pipeline;
     vk::DescriptorSet* m_camera_dset_ptr;
 };
@@ -1,12 +1,65 @@
 #include "texture.hpp"
 
+#include "graphics/ktex.hpp"
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 namespace kzn {
 
+namespace {
+
+[[nodiscard]]
+bool is_ktex(std::span<const std::byte> bytes) {
+    return bytes.size() >= ktex::magic.size() &&
+           std::memcmp(bytes.data(), ktex::magic.data(), ktex::magic.size()) == 0;
+}
+
+//! Reads a cooked texture, no decoding needed.
+std::shared_ptr<TextureData> read_ktex(std::span<const std::byte> bytes) {
+    ktex::Header header;
+    if (!is_ktex(bytes) || bytes.size() < sizeof(header)) {
+        throw LoadingError{"Not a ktex texture"};
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.version != ktex::version) {
+        throw LoadingError{
+            fmt::format("Unsupported ktex version {}", header.version)
+        };
+    }
+    if (header.format > TextureFormat::Bc7 || header.depth != 1 ||
+        header.width == 0 || header.height == 0 || header.mip_levels == 0 ||
+        header.mip_levels > mip_level_count(header.width, header.height)) {
+        throw LoadingError{"Invalid ktex header"};
+    }
+
+    auto texture_ptr = std::make_shared<TextureData>(
+        nullptr,
+        Vec3u{header.width, header.height, header.depth},
+        header.format,
+        header.mip_levels,
+        (header.flags & ktex::flag_srgb) != 0
+    );
+    const auto level_bytes = bytes.subspan(sizeof(header));
+    if (level_bytes.size() != texture_ptr->byte_size()) {
+        throw LoadingError{"Truncated ktex texture"};
+    }
+    // Allocated like stb_image pixels, so both are freed the same way
+    texture_ptr->bytes =
+        static_cast<unsigned char*>(STBI_MALLOC(level_bytes.size()));
+    std::memcpy(texture_ptr->bytes, level_bytes.data(), level_bytes.size());
+    return texture_ptr;
+}
+
+} // namespace
+
 TextureData::~TextureData() {
     if(bytes != nullptr) {
         stbi_image_free(bytes);
@@ -14,6 +67,19 @@ TextureData::~TextureData() {
 }
 
 std::shared_ptr<TextureData> TextureData::load(const std::filesystem::path& path) {
+    if (path.extension() == ".ktex") {
+        auto file = std::ifstream{path, std::ios::ate | std::ios::binary};
+        if (!file.is_open()) {
+            throw LoadingError{
+                fmt::format("Failed to open file '{}'", path.c_str())
+            };
+        }
+        std::vector<std::byte> bytes(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+        return read_ktex(bytes);
+    }
+
     int width;
     int height;
     int channels;
@@ -34,4 +100,64 @@ std::shared_ptr<TextureData> TextureData::load(const std::filesystem::path& path
     );
 }
 
+Task<std::shared_ptr<TextureData>> TextureData::load_async(
+    std::filesystem::path path
+) {
+    const auto encoded_bytes = co_await read_file_async(std::move(path));
+    // Resumed on the worker that read the file
+    co_return load_from_memory(encoded_bytes);
+}
+
+std::shared_ptr<TextureData> TextureData::load_from_memory(
+    std::span<const std::byte> encoded_bytes
+) {
+    if (is_ktex(encoded_bytes)) {
+        return read_ktex(encoded_bytes);
+    }
+
+    int width;
+    int height;
+    int channels;
+    unsigned char* result_ptr = stbi_load_from_memory(
+        reinterpret_cast<const stbi_uc*>(encoded_bytes.data()),
+        static_cast<int>(encoded_bytes.size()),
+        &width,
+        &height,
+        &channels,
+        STBI_rgb_alpha
+    );
+    if (result_ptr == nullptr) {
+        throw LoadingError{stbi_failure_reason()};
+    }
+
+    return std::make_shared<TextureData>(
+        result_ptr,
+        Vec3u{static_cast<uint>(width), static_cast<uint>(height), 1}
+    );
+}
+
+vk::Image create_texture_image(vk::Device& device, const TextureData& texture) {
+    // Checked here rather than only asserted by vk::Image, cooked textures
+    // are block compressed and not every device samples those
+    if (!device.supports_format(
+            texture.vk_format(),
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT
+        )) {
+        throw LoadingError{fmt::format(
+            "Texture format {} is not supported by the device",
+            to_string(texture.format)
+        )};
+    }
+    auto image = vk::Image(
+        device,
+        texture.vk_extent(),
+        texture.vk_format(),
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        texture.mip_levels
+    );
+    image.upload(texture.bytes);
+    return image;
+}
+
 } // namespace kzn
\ No newline at end of file
@@ -1,20 +1,38 @@
 #pragma once
 
+#include "core/task.hpp"
+#include "graphics/texture_format.hpp"
 #include "resources/resource.hpp"
+#include "vk/image.hpp"
 #include "vk/utils.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <span>
+#include <utility>
 #include <vulkan/vulkan_core.h>
 
 namespace kzn {
 
-//! Represents decoded and uncompressed texture data. Can be used to upload
-//! data directly to the GPU.
+//! Represents texture data ready to upload directly to the GPU. Either
+//! decoded RGBA8 pixels of a source image, or the mip levels of a cooked
+//! .ktex texture, largest first.
 struct TextureData {
     unsigned char* bytes;
     Vec3u extent;
+    TextureFormat format = TextureFormat::Rgba8;
+    std::uint32_t mip_levels = 1;
+    bool is_srgb = true;
 
     constexpr TextureData(unsigned char* img_bytes, Vec3u img_extent);
+    constexpr TextureData(
+        unsigned char* img_bytes,
+        Vec3u img_extent,
+        TextureFormat img_format,
+        std::uint32_t img_mip_levels,
+        bool img_is_srgb
+    );
 
     constexpr TextureData(TextureData&&);
     constexpr TextureData& operator=(TextureData&&);
@@ -26,13 +44,45 @@ struct TextureData {
     [[nodiscard]]
     constexpr VkExtent3D vk_extent() const;
 
+    //! Vulkan format of the texture data.
+    [[nodiscard]]
+    constexpr VkFormat vk_format() const;
+
+    //! Size of all mip levels in bytes.
+    [[nodiscard]]
+    constexpr std::size_t byte_size() const;
+
     //! \brief Creates a new texture data from the specified path.
-    //! \param path Relative path to the texture file.
+    //! \param path Relative path to the texture file, cooked if its extension
+    //! is .ktex.
     //! \throws LoadingError
     [[nodiscard]]
     static std::shared_ptr<TextureData> load(const std::filesystem::path& path);
+
+    //! \brief Reads and decodes a texture on job system workers.
+    //! \param path Relative path to the texture file.
+    //! \throws LoadingError when awaited.
+    [[nodiscard]]
+    static Task<std::shared_ptr<TextureData>> load_async(
+        std::filesystem::path path
+    );
+
+    //! \brief Decodes a texture from encoded bytes in memory, or reads it if
+    //! they're a cooked .ktex texture.
+    //! \throws LoadingError
+    [[nodiscard]]
+    static std::shared_ptr<TextureData> load_from_memory(
+        std::span<const std::byte> encoded_bytes
+    );
 };
 
+//! Creates a sampled image with the format and mip levels of a texture and
+//! uploads the texture to it.
+//! \throws LoadingError if the device can't sample the texture format, such
+//! as block compressed formats without `textureCompressionBC`.
+[[nodiscard]]
+vk::Image create_texture_image(vk::Device& device, const TextureData& texture);
+
 } // namespace kzn
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,17 +95,36 @@ constexpr TextureData::TextureData(unsigned char* img_bytes, Vec3u img_extent)
     : bytes{img_bytes}
     , extent{img_extent} {}
 
+constexpr TextureData::TextureData(
+    unsigned char* img_bytes,
+    Vec3u img_extent,
+    TextureFormat img_format,
+    std::uint32_t img_mip_levels,
+    bool img_is_srgb
+)
+    : bytes{img_bytes}
+    , extent{img_extent}
+    , format{img_format}
+    , mip_levels{img_mip_levels}
+    , is_srgb{img_is_srgb} {}
+
 constexpr TextureData::TextureData(TextureData&& other)
     : bytes{other.bytes}
     , extent{other.extent}
+    , format{other.format}
+    , mip_levels{other.mip_levels}
+    , is_srgb{other.is_srgb}
 {
     other.bytes = nullptr;
 }
 
 constexpr TextureData& TextureData::operator=(TextureData&& other) {
-    bytes = other.bytes;
+    // Swap so the previous pixels are freed with other
+    std::swap(bytes, other.bytes);
     extent = other.extent;
-    other.bytes = nullptr;
+    format = other.format;
+    mip_levels = other.mip_levels;
+    is_srgb = other.is_srgb;
     return *this;
 }
 
@@ -67,4 +136,32 @@ constexpr VkExtent3D TextureData::vk_extent() const {
     };
 }
 
+constexpr VkFormat TextureData::vk_format() const {
+    switch (format) {
+        case TextureFormat::Rgba8:
+            return is_srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        case TextureFormat::Bc1:
+            return is_srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                           : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case TextureFormat::Bc3:
+            return is_srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        // Two channel data, never sRGB
+        case TextureFormat::Bc5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureFormat::Bc7:
+            return is_srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+constexpr std::size_t TextureData::byte_size() const {
+    std::size_t size = 0;
+    for (std::uint32_t level = 0; level < mip_levels; ++level) {
+        size += level_byte_size(
+            format, mip_extent(extent.x, level), mip_extent(extent.y, level)
+        );
+    }
+    return size * extent.z;
+}
+
 } // namespace kzn
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "texture_cooker.hpp"
+
+#include "core/assert.hpp"
+#include "graphics/block_compression.hpp"
+#include "graphics/ktex.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <span>
+
+namespace kzn {
+
+namespace {
+
+float srgb_to_linear(float value) {
+    return (value <= 0.04045f) ? value / 12.92f
+                               : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float linear_to_srgb(float value) {
+    return (value <= 0.0031308f)
+               ? value * 12.92f
+               : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+//! Halves an RGBA8 image with a 2x2 box filter.
+std::vector<std::uint8_t> downsample(
+    std::span<const std::uint8_t> rgba,
+    std::uint32_t width,
+    std::uint32_t height,
+    bool srgb
+) {
+    static const auto to_linear_table = [] {
+        std::array<float, 256> table;
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            table[i] = srgb_to_linear(float(i) / 255.f);
+        }
+        return table;
+    }();
+
+    const std::uint32_t dst_width = mip_extent(width, 1);
+    const std::uint32_t dst_height = mip_extent(height, 1);
+    std::vector<std::uint8_t> dst(std::size_t{dst_width} * dst_height * 4);
+    for (std::uint32_t y = 0; y < dst_height; ++y) {
+        for (std::uint32_t x = 0; x < dst_width; ++x) {
+            std::array<float, 4> sum{};
+            for (std::uint32_t dy = 0; dy < 2; ++dy) {
+                for (std::uint32_t dx = 0; dx < 2; ++dx) {
+                    // Odd extents repeat the last row or column
+                    const std::size_t src_x = std::min(x * 2 + dx, width - 1);
+                    const std::size_t src_y = std::min(y * 2 + dy, height - 1);
+                    const auto* pixel_ptr = &rgba[(src_y * width + src_x) * 4];
+                    for (std::size_t c = 0; c < 4; ++c) {
+                        sum[c] += (srgb && c < 3) ? to_linear_table[pixel_ptr[c]]
+                                                  : pixel_ptr[c] / 255.f;
+                    }
+                }
+            }
+            auto* dst_ptr = &dst[(std::size_t{y} * dst_width + x) * 4];
+            for (std::size_t c = 0; c < 4; ++c) {
+                const float value = sum[c] / 4.f;
+                const float encoded =
+                    (srgb && c < 3) ? linear_to_srgb(value) : value;
+                dst_ptr[c] = std::uint8_t(std::lround(encoded * 255.f));
+            }
+        }
+    }
+    return dst;
+}
+
+void append(std::vector<std::byte>& dst, std::span<const std::byte> bytes) {
+    dst.insert(dst.end(), bytes.begin(), bytes.end());
+}
+
+} // namespace
+
+std::vector<std::byte> cook_texture(
+    const TextureData& source,
+    const TextureCookOptions& options,
+    std::uint64_t source_hash
+) {
+    KZN_ASSERT_MSG(
+        source.format == TextureFormat::Rgba8 && source.mip_levels == 1 &&
+            source.extent.z == 1,
+        "Only decoded 2D textures can be cooked"
+    );
+    std::uint32_t width = source.extent.x;
+    std::uint32_t height = source.extent.y;
+
+    const ktex::Header header{
+        .magic = ktex::magic,
+        .version = ktex::version,
+        .source_hash = source_hash,
+        .format = options.format,
+        .flags = options.srgb ? ktex::flag_srgb : 0,
+        .width = width,
+        .height = height,
+        .depth = 1,
+        .mip_levels = options.generate_mips ? mip_level_count(width, height) : 1,
+    };
+
+    std::vector<std::byte> ktex_bytes;
+    append(ktex_bytes, std::as_bytes(std::span{&header, 1}));
+
+    std::vector<std::uint8_t> level{
+        source.bytes, source.bytes + std::size_t{width} * height * 4
+    };
+    for (std::uint32_t mip = 0; mip < header.mip_levels; ++mip) {
+        if (mip > 0) {
+            level = downsample(level, width, height, options.srgb);
+            width = mip_extent(width, 1);
+            height = mip_extent(height, 1);
+        }
+        append(ktex_bytes, bc::compress(options.format, level, width, height));
+    }
+    return ktex_bytes;
+}
+
+} // namespace kzn
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "graphics/texture.hpp"
+#include "graphics/texture_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kzn {
+
+struct TextureCookOptions {
+    TextureFormat format = TextureFormat::Bc7;
+    bool generate_mips = true;
+    //! Pixels are sRGB color, mips are filtered in linear space.
+    bool srgb = true;
+};
+
+//! Encodes a decoded RGBA8 texture as a .ktex file with a box filtered mip
+//! chain. Blocks are compressed on the job system, if there's one.
+//! \param source_hash Stored in the header to detect unchanged sources.
+[[nodiscard]]
+std::vector<std::byte> cook_texture(
+    const TextureData& source,
+    const TextureCookOptions& options,
+    std::uint64_t source_hash
+);
+
+} // namespace kzn
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+
+namespace kzn {
+
+//! Pixel formats of texture data.
+enum class TextureFormat : std::uint32_t {
+    //! Uncompressed 8 bit RGBA.
+    Rgba8 = 0,
+    //! RGB in 8 byte 4x4 blocks.
+    Bc1 = 1,
+    //! RGBA in 16 byte 4x4 blocks, BC1 color with BC4 alpha.
+    Bc3 = 2,
+    //! Two channels in 16 byte 4x4 blocks, for normal maps.
+    Bc5 = 3,
+    //! High quality RGBA in 16 byte 4x4 blocks.
+    Bc7 = 4,
+};
+
+[[nodiscard]]
+constexpr bool is_block_compressed(TextureFormat format) {
+    return format != TextureFormat::Rgba8;
+}
+
+//! Width and height in pixels of a block, 1 for uncompressed formats.
+[[nodiscard]]
+constexpr std::uint32_t block_extent(TextureFormat format) {
+    return is_block_compressed(format) ? 4 : 1;
+}
+
+//! Size in bytes of a block, or of a pixel for uncompressed formats.
+[[nodiscard]]
+constexpr std::size_t block_byte_size(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::Rgba8: return 4;
+        case TextureFormat::Bc1: return 8;
+        case TextureFormat::Bc3:
+        case TextureFormat::Bc5:
+        case TextureFormat::Bc7: return 16;
+    }
+    return 0;
+}
+
+//! Size in bytes of one mip level of a 2D texture.
+[[nodiscard]]
+constexpr std::size_t level_byte_size(
+    TextureFormat format,
+    std::uint32_t width,
+    std::uint32_t height
+) {
+    const std::uint32_t block = block_extent(format);
+    const std::size_t blocks_x = (width + block - 1) / block;
+    const std::size_t blocks_y = (height + block - 1) / block;
+    return blocks_x * blocks_y * block_byte_size(format);
+}
+
+//! Extent of a dimension at a mip level.
+[[nodiscard]]
+constexpr std::uint32_t mip_extent(std::uint32_t extent, std::uint32_t level) {
+    return std::max(extent >> level, std::uint32_t{1});
+}
+
+//! Number of levels of a full mip chain, down to 1x1.
+[[nodiscard]]
+constexpr std::uint32_t mip_level_count(
+    std::uint32_t width,
+    std::uint32_t height
+) {
+    std::uint32_t count = 1;
+    for (std::uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+        ++count;
+    }
+    return count;
+}
+
+[[nodiscard]]
+constexpr std::string_view to_string(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::Rgba8: return "rgba8";
+        case TextureFormat::Bc1: return "bc1";
+        case TextureFormat::Bc3: return "bc3";
+        case TextureFormat::Bc5: return "bc5";
+        case TextureFormat::Bc7: return "bc7";
+    }
+    return "unknown";
+}
+
+[[nodiscard]]
+constexpr std::optional<TextureFormat> texture_format_from_string(
+    std::string_view name
+) {
+    for (auto format : {
+             TextureFormat::Rgba8,
+             TextureFormat::Bc1,
+             TextureFormat::Bc3,
+             TextureFormat::Bc5,
+             TextureFormat::Bc7,
+         }) {
+        if (to_string(format) == name) {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace kzn
@@ -0,0 +1,130 @@
+#include "vertex_packing.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace kzn {
+
+namespace {
+
+template<typename T>
+[[nodiscard]]
+T quantize_unorm(float value) {
+    constexpr float max = std::numeric_limits<T>::max();
+    return static_cast<T>(std::lround(std::clamp(value, 0.f, 1.f) * max));
+}
+
+template<typename T>
+[[nodiscard]]
+T quantize_snorm(float value) {
+    constexpr float max = std::numeric_limits<T>::max();
+    return static_cast<T>(std::lround(std::clamp(value, -1.f, 1.f) * max));
+}
+
+} // namespace
+
+std::uint16_t float_to_half(float value) {
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = (bits >> 16) & 0x8000;
+    const std::uint32_t abs_bits = bits & 0x7fff'ffff;
+
+    // Infinity and NaN, keeping NaNs quiet
+    if (abs_bits >= 0x7f80'0000) {
+        return std::uint16_t(sign | 0x7c00 | (abs_bits > 0x7f80'0000 ? 0x200 : 0));
+    }
+    // Too large, rounds to infinity
+    if (abs_bits >= 0x477f'f000) {
+        return std::uint16_t(sign | 0x7c00);
+    }
+    // Subnormal halves, below 2^-14
+    if (abs_bits < 0x3880'0000) {
+        // Below half the smallest subnormal, rounds to zero
+        if (abs_bits < 0x3300'0000) {
+            return std::uint16_t(sign);
+        }
+        const std::uint32_t exponent = abs_bits >> 23;
+        const std::uint32_t mantissa = (abs_bits & 0x7f'ffff) | 0x80'0000;
+        const std::uint32_t shift = 126 - exponent;
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const std::uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            ++half;
+        }
+        return std::uint16_t(sign | half);
+    }
+    // Rebias the exponent from 127 to 15, a rounding carry into the exponent
+    // is still correct
+    std::uint32_t half = (abs_bits - 0x3800'0000) >> 13;
+    const std::uint32_t remainder = abs_bits & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        ++half;
+    }
+    return std::uint16_t(sign | half);
+}
+
+std::array<std::int16_t, 2> octahedral_encode(Vec3 normal) {
+    const float l1_norm =
+        std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1_norm == 0.f) {
+        return {0, 0};
+    }
+    float x = normal.x / l1_norm;
+    float y = normal.y / l1_norm;
+    // Fold the lower hemisphere over the diagonals
+    if (normal.z < 0.f) {
+        const float folded_x = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        const float folded_y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = folded_x;
+        y = folded_y;
+    }
+    return {quantize_snorm<std::int16_t>(x), quantize_snorm<std::int16_t>(y)};
+}
+
+PackedVertices pack_vertices(std::span<const Vertex3D> vertices) {
+    PackedVertices packed;
+    if (vertices.empty()) {
+        return packed;
+    }
+
+    Vec3 min = vertices[0].position;
+    Vec3 max = vertices[0].position;
+    for (const auto& vertex : vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    packed.position_min = min;
+    packed.position_extent = max - min;
+
+    const Vec3 extent = packed.position_extent;
+    const auto quantize_position = [](float value, float min, float extent) {
+        return quantize_unorm<std::uint16_t>(
+            extent > 0.f ? (value - min) / extent : 0.f
+        );
+    };
+    packed.vertices.reserve(vertices.size());
+    for (const auto& vertex : vertices) {
+        const Vec3& position = vertex.position;
+        packed.vertices.push_back(PackedVertex3D{
+            .position = {
+                quantize_position(position.x, min.x, extent.x),
+                quantize_position(position.y, min.y, extent.y),
+                quantize_position(position.z, min.z, extent.z),
+                0,
+            },
+            .normal = octahedral_encode(vertex.normal),
+            .uv = {float_to_half(vertex.uv.x), float_to_half(vertex.uv.y)},
+            .color = {
+                quantize_unorm<std::uint8_t>(vertex.color.x),
+                quantize_unorm<std::uint8_t>(vertex.color.y),
+                quantize_unorm<std::uint8_t>(vertex.color.z),
+                255,
+            },
+        });
+    }
+    return packed;
+}
+
+} // namespace kzn
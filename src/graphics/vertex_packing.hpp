@@ -0,0 +1,47 @@
+#pragma once
+
+#include "graphics/mesh.hpp"
+#include "math/types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace kzn {
+
+//! Vertex3D quantized from 44 to 20 bytes.
+struct PackedVertex3D {
+    //! Position in the mesh bounds as 16 bit unorm, w is unused.
+    std::array<std::uint16_t, 4> position;
+    //! Octahedral encoded normal as 16 bit snorm.
+    std::array<std::int16_t, 2> normal;
+    //! Half floats, texture coordinates may repeat outside [0, 1].
+    std::array<std::uint16_t, 2> uv;
+    //! RGBA as 8 bit unorm.
+    std::array<std::uint8_t, 4> color;
+};
+
+static_assert(sizeof(PackedVertex3D) == 20);
+
+//! Vertices packed relative to the bounds of their positions.
+struct PackedVertices {
+    std::vector<PackedVertex3D> vertices;
+    Vec3 position_min{0.f};
+    //! Size of the bounds, unpacked positions are min + unorm * extent.
+    Vec3 position_extent{0.f};
+};
+
+//! Converts to an IEEE half float, rounding to nearest even.
+[[nodiscard]]
+std::uint16_t float_to_half(float value);
+
+//! Maps a unit vector onto the octahedron unfolded in [-1, 1]^2, as 16 bit
+//! snorm.
+[[nodiscard]]
+std::array<std::int16_t, 2> octahedral_encode(Vec3 normal);
+
+[[nodiscard]]
+PackedVertices pack_vertices(std::span<const Vertex3D> vertices);
+
+} // namespace kzn
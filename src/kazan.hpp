@@ -3,6 +3,7 @@
 
 // Core
 #include "core/app.hpp"
+#include "core/job_system.hpp"
 #include "core/log.hpp"
 #include "core/timing.hpp"
 #include "core/window.hpp"
@@ -6,6 +6,7 @@
 #include "box2d/math_functions.h"
 #include "box2d/types.h"
 #include "core/assert.hpp"
+#include "core/cvar.hpp"
 #include "core/singleton.hpp"
 #include "ecs/context.hpp"
 #include "ecs/entity.hpp"
@@ -18,6 +19,8 @@
 #include "input/keyboard.hpp"
 #include "math/transform.hpp"
 
+#include <algorithm>
+
 namespace kzn {
 
 struct PhysicsWorld : public Singleton<PhysicsWorld> {
@@ -96,6 +99,11 @@ private:
     Vec2 m_size;
 };
 
+//! Number of box2d sub-steps per physics step. Trades accuracy for cost.
+inline CVar<int> cvar_phys_substeps{
+    "phys_substeps", 4, "Physics sub-steps per update"
+};
+
 class PhysicsSystem : public System {
 public:
     // Ctor
@@ -134,8 +142,11 @@ public:
                 );
             }
 
-            constexpr int sub_step_count = 4;
-            b2World_Step(m_physics_world.world_id, delta_time, sub_step_count);
+            b2World_Step(
+                m_physics_world.world_id,
+                delta_time,
+                std::max(cvar_phys_substeps.get(), 1)
+            );
 
             for (auto [entity, physics, transform] : view.each()) {
 
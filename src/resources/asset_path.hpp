@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/string_hash.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace kzn {
+
+//! Path of an asset, possibly with a path alias, and its id. The id is the
+//! hash of the path as written, so literal paths are hashed at compile time
+//! and cache lookups don't resolve or allocate paths.
+//! \warning Only views the path, must not outlive it.
+class AssetPath {
+public:
+    // Ctor
+    //! Literal path, hashed at compile time.
+    template<std::size_t N>
+    consteval AssetPath(const char (&path)[N])
+        : m_path{path, N - 1}
+        , m_id{std::string_view{path, N - 1}} {}
+
+    //! Runtime buffer, such as a text input, hashed at runtime. Preferred
+    //! over the literal overload for non-const arrays, which can't be hashed
+    //! at compile time.
+    template<std::size_t N>
+    AssetPath(char (&path)[N])
+        : AssetPath(std::string_view{path}) {}
+
+    AssetPath(std::string_view path)
+        : m_path{path}
+        , m_id{path} {}
+
+    AssetPath(const std::string& path)
+        : AssetPath(std::string_view{path}) {}
+
+    [[nodiscard]]
+    constexpr std::string_view str() const noexcept {
+        return m_path;
+    }
+
+    [[nodiscard]]
+    constexpr StringHash id() const noexcept {
+        return m_id;
+    }
+
+private:
+    std::string_view m_path;
+    StringHash m_id;
+};
+
+} // namespace kzn
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "core/string_hash.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace kzn {
+
+namespace internal {
+
+template<typename T>
+class ResourcePool;
+
+} // namespace internal
+
+//! Reference to a resource in the pool of its type. Only valid until the
+//! resource is released, afterwards it dereferences to nullptr, even if the
+//! slot was reused.
+template<typename T>
+class Handle {
+public:
+    // Ctor
+    //! Null handle.
+    constexpr Handle() = default;
+
+    [[nodiscard]]
+    constexpr bool is_null() const noexcept {
+        return m_generation == 0;
+    }
+
+    [[nodiscard]]
+    constexpr std::uint32_t index() const noexcept {
+        return m_index;
+    }
+
+    [[nodiscard]]
+    constexpr std::uint32_t generation() const noexcept {
+        return m_generation;
+    }
+
+    constexpr bool operator==(const Handle&) const = default;
+
+private:
+    friend class internal::ResourcePool<T>;
+
+    constexpr Handle(std::uint32_t index, std::uint32_t generation)
+        : m_index{index}
+        , m_generation{generation} {}
+
+private:
+    std::uint32_t m_index = 0;
+    // Generation 0 is never used by a slot
+    std::uint32_t m_generation = 0;
+};
+
+namespace internal {
+
+//! Index of a resource type, assigned on first use.
+inline std::size_t next_resource_type_index() {
+    static std::atomic<std::size_t> next_index = 0;
+    return next_index++;
+}
+
+template<typename T>
+std::size_t resource_type_index() {
+    static const std::size_t index = next_resource_type_index();
+    return index;
+}
+
+class ResourcePoolBase {
+public:
+    virtual ~ResourcePoolBase() = default;
+};
+
+//! Dense storage of the resources of one type referenced by handles. Each
+//! resource is in the pool once, shared by every handle to it, and counts the
+//! handles acquired.
+template<typename T>
+class ResourcePool : public ResourcePoolBase {
+public:
+    //! Resource of a handle, or nullptr if it was released.
+    [[nodiscard]]
+    T* get(Handle<T> handle) const noexcept {
+        return (handle.m_index < m_generations.size() &&
+                m_generations[handle.m_index] == handle.m_generation)
+                   ? m_resource_ptrs[handle.m_index]
+                   : nullptr;
+    }
+
+    //! Handle of a resource already in the pool, with its count incremented.
+    //! \return Null handle if the resource isn't in the pool.
+    [[nodiscard]]
+    Handle<T> acquire(StringHash key) {
+        auto it = m_indices.find(key);
+        if (it == m_indices.end()) {
+            return {};
+        }
+        ++m_slots[it->second].ref_count;
+        return {it->second, m_generations[it->second]};
+    }
+
+    //! Adds a resource to the pool with a count of 1.
+    [[nodiscard]]
+    Handle<T> insert(StringHash key, std::shared_ptr<T> resource_ptr) {
+        std::uint32_t index;
+        if (!m_free_indices.empty()) {
+            index = m_free_indices.back();
+            m_free_indices.pop_back();
+        }
+        else {
+            index = static_cast<std::uint32_t>(m_generations.size());
+            m_generations.push_back(1);
+            m_resource_ptrs.push_back(nullptr);
+            m_slots.emplace_back();
+        }
+        m_resource_ptrs[index] = resource_ptr.get();
+        m_slots[index] = Slot{std::move(resource_ptr), key, 1};
+        m_indices.emplace(key, index);
+        return {index, m_generations[index]};
+    }
+
+    //! Increments the count of a resource.
+    void retain(Handle<T> handle) {
+        if (get(handle) != nullptr) {
+            ++m_slots[handle.m_index].ref_count;
+        }
+    }
+
+    //! Decrements the count of a resource and removes it from the pool when
+    //! it reaches 0, so the resource cache may evict it.
+    void release(Handle<T> handle) {
+        if (get(handle) == nullptr) {
+            return;
+        }
+        auto& slot = m_slots[handle.m_index];
+        if (--slot.ref_count > 0) {
+            return;
+        }
+        m_indices.erase(slot.key);
+        slot = Slot{};
+        m_resource_ptrs[handle.m_index] = nullptr;
+        // Skip generation 0 on wrap around, it marks null handles
+        if (++m_generations[handle.m_index] == 0) {
+            m_generations[handle.m_index] = 1;
+        }
+        m_free_indices.push_back(handle.m_index);
+    }
+
+    //! Number of resources in the pool.
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_indices.size();
+    }
+
+private:
+    struct Slot {
+        //! Keeps the resource in the resource cache.
+        std::shared_ptr<T> resource_ptr;
+        StringHash key = ""_sh;
+        std::uint32_t ref_count = 0;
+    };
+
+private:
+    // Only what dereferencing a handle reads is kept densely
+    std::vector<T*> m_resource_ptrs;
+    std::vector<std::uint32_t> m_generations;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_free_indices;
+    std::unordered_map<StringHash, std::uint32_t> m_indices;
+};
+
+} // namespace internal
+
+} // namespace kzn
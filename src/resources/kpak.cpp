@@ -0,0 +1,290 @@
+#include "kpak.hpp"
+
+#include "core/job_system.hpp"
+#include "core/log.hpp"
+#include "resources/lz4.hpp"
+#include "resources/resource.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace kzn {
+
+static_assert(sizeof(kpak::Header) == 24);
+static_assert(sizeof(kpak::TocEntry) == 40);
+static_assert(std::is_trivially_copyable_v<kpak::TocEntry>);
+
+namespace {
+
+//! Runs \p fn for every index in [0, count), in parallel if possible.
+template<typename Fn>
+void for_each_index(std::size_t count, Fn&& fn) {
+    if (JobSystem::exists() && count > 1) {
+        JobSystem::singleton().parallel_for(0, count, fn, 1);
+    }
+    else {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+}
+
+std::size_t block_count(std::size_t size) {
+    return (size + kpak::block_size - 1) / kpak::block_size;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// PackArchive
+///////////////////////////////////////////////////////////////////////////////
+
+PackArchive::PackArchive(const std::filesystem::path& path)
+    : m_path{path}
+    , m_file{path} {
+    const auto bytes = m_file.bytes();
+    const auto invalid_archive = [&](std::string_view reason) {
+        return LoadingError{
+            fmt::format("Invalid archive '{}': {}", path.c_str(), reason)
+        };
+    };
+
+    kpak::Header header;
+    if (bytes.size() < sizeof(header)) {
+        throw invalid_archive("too small");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != kpak::magic) {
+        throw invalid_archive("not a kpak file");
+    }
+    if (header.version != kpak::version) {
+        throw invalid_archive(fmt::format("unsupported version {}", header.version));
+    }
+    if (header.toc_offset % alignof(kpak::TocEntry) != 0 ||
+        header.toc_offset > bytes.size() ||
+        header.entry_count >
+            (bytes.size() - header.toc_offset) / sizeof(kpak::TocEntry)) {
+        throw invalid_archive("table of contents out of bounds");
+    }
+
+    // Mapping is page aligned, so the table can be used in place
+    m_toc = {
+        reinterpret_cast<const kpak::TocEntry*>(
+            bytes.data() + header.toc_offset
+        ),
+        static_cast<std::size_t>(header.entry_count)
+    };
+    for (const auto& entry : m_toc) {
+        if (entry.offset > bytes.size() ||
+            entry.stored_size > bytes.size() - entry.offset) {
+            throw invalid_archive("entry out of bounds");
+        }
+    }
+}
+
+const kpak::TocEntry* PackArchive::find(StringHash key) const {
+    auto it = std::ranges::lower_bound(
+        m_toc, key.value(), {}, &kpak::TocEntry::key
+    );
+    return (it != m_toc.end() && it->key == key.value()) ? &*it : nullptr;
+}
+
+std::optional<ArchiveData> PackArchive::read(StringHash key) const {
+    const auto* entry_ptr = find(key);
+    if (entry_ptr == nullptr) {
+        return std::nullopt;
+    }
+    const auto& entry = *entry_ptr;
+    const auto stored_bytes =
+        m_file.bytes().subspan(entry.offset, entry.stored_size);
+
+    if (entry.compression == kpak::Compression::None) {
+        if (entry.size != entry.stored_size) {
+            throw LoadingError{fmt::format(
+                "Corrupted entry in archive '{}'", m_path.c_str()
+            )};
+        }
+        return ArchiveData{stored_bytes};
+    }
+
+    // Find where each block starts
+    const std::size_t num_blocks = entry.block_count;
+    const std::size_t sizes_size = num_blocks * sizeof(std::uint32_t);
+    if (num_blocks != block_count(entry.size) ||
+        stored_bytes.size() < sizes_size) {
+        throw LoadingError{
+            fmt::format("Corrupted entry in archive '{}'", m_path.c_str())
+        };
+    }
+    std::vector<std::uint32_t> block_sizes(num_blocks);
+    std::memcpy(block_sizes.data(), stored_bytes.data(), sizes_size);
+    std::vector<std::size_t> block_offsets(num_blocks);
+    std::size_t block_offset = sizes_size;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        block_offsets[i] = block_offset;
+        block_offset += block_sizes[i];
+    }
+    if (block_offset != stored_bytes.size()) {
+        throw LoadingError{
+            fmt::format("Corrupted entry in archive '{}'", m_path.c_str())
+        };
+    }
+
+    std::vector<std::byte> bytes(entry.size);
+    std::atomic<bool> failed = false;
+    for_each_index(num_blocks, [&](std::size_t i) {
+        const std::size_t begin = i * kpak::block_size;
+        const auto dst = std::span{bytes}.subspan(
+            begin, std::min(kpak::block_size, bytes.size() - begin)
+        );
+        const auto src = stored_bytes.subspan(block_offsets[i], block_sizes[i]);
+        if (!lz4::decompress(src, dst)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    if (failed) {
+        throw LoadingError{
+            fmt::format("Corrupted entry in archive '{}'", m_path.c_str())
+        };
+    }
+
+    return ArchiveData{std::move(bytes)};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PackWriter
+///////////////////////////////////////////////////////////////////////////////
+
+void PackWriter::add(std::string name, std::vector<std::byte> bytes) {
+    m_entries.push_back(Entry{std::move(name), std::move(bytes)});
+}
+
+bool PackWriter::write(const std::filesystem::path& path, bool compress) const {
+    struct StoredEntry {
+        kpak::TocEntry toc_entry;
+        std::vector<std::byte> compressed_bytes;
+        const Entry* entry_ptr;
+    };
+
+    std::vector<StoredEntry> stored(m_entries.size());
+    for_each_index(m_entries.size(), [&](std::size_t i) {
+        const auto& entry = m_entries[i];
+        auto& stored_entry = stored[i];
+        stored_entry.entry_ptr = &entry;
+        stored_entry.toc_entry = kpak::TocEntry{
+            .key = StringHash{entry.name}.value(),
+            .offset = 0,
+            .stored_size = entry.bytes.size(),
+            .size = entry.bytes.size(),
+            .compression = kpak::Compression::None,
+            .block_count = 0,
+        };
+        if (!compress || entry.bytes.empty()) {
+            return;
+        }
+
+        // Block sizes followed by blocks
+        const std::size_t num_blocks = block_count(entry.bytes.size());
+        const std::size_t sizes_size = num_blocks * sizeof(std::uint32_t);
+        auto& compressed = stored_entry.compressed_bytes;
+        compressed.resize(
+            sizes_size + num_blocks * lz4::compress_bound(kpak::block_size)
+        );
+        std::size_t compressed_size = sizes_size;
+        for (std::size_t block = 0; block < num_blocks; ++block) {
+            const std::size_t begin = block * kpak::block_size;
+            const auto src = std::span{entry.bytes}.subspan(
+                begin, std::min(kpak::block_size, entry.bytes.size() - begin)
+            );
+            const auto block_size = std::uint32_t(lz4::compress(
+                src, std::span{compressed}.subspan(compressed_size)
+            ));
+            std::memcpy(
+                compressed.data() + block * sizeof(std::uint32_t),
+                &block_size,
+                sizeof(block_size)
+            );
+            compressed_size += block_size;
+        }
+
+        // Not worth decompressing
+        if (compressed_size >= entry.bytes.size()) {
+            compressed.clear();
+            return;
+        }
+        compressed.resize(compressed_size);
+        compressed.shrink_to_fit();
+        stored_entry.toc_entry.stored_size = compressed_size;
+        stored_entry.toc_entry.compression = kpak::Compression::Lz4;
+        stored_entry.toc_entry.block_count = std::uint32_t(num_blocks);
+    });
+
+    // Sorted table of contents for binary search
+    std::ranges::sort(stored, {}, [](const StoredEntry& stored_entry) {
+        return stored_entry.toc_entry.key;
+    });
+    for (std::size_t i = 1; i < stored.size(); ++i) {
+        if (stored[i].toc_entry.key == stored[i - 1].toc_entry.key) {
+            Log::error(
+                "Entries '{}' and '{}' have the same hash",
+                stored[i - 1].entry_ptr->name,
+                stored[i].entry_ptr->name
+            );
+            return false;
+        }
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.is_open()) {
+        Log::error("Failed to open file '{}'", path.c_str());
+        return false;
+    }
+    const auto pad_to_alignment = [&file] {
+        const std::size_t offset = file.tellp();
+        const std::size_t padding = (kpak::alignment - offset % kpak::alignment)
+                                  % kpak::alignment;
+        const std::array<char, kpak::alignment> zeros{};
+        file.write(zeros.data(), padding);
+        return offset + padding;
+    };
+
+    kpak::Header header{
+        .magic = kpak::magic,
+        .version = kpak::version,
+        .entry_count = stored.size(),
+        .toc_offset = 0,
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (auto& stored_entry : stored) {
+        stored_entry.toc_entry.offset = pad_to_alignment();
+        const auto& bytes =
+            (stored_entry.toc_entry.compression == kpak::Compression::None)
+                ? stored_entry.entry_ptr->bytes
+                : stored_entry.compressed_bytes;
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    header.toc_offset = pad_to_alignment();
+    for (const auto& stored_entry : stored) {
+        file.write(
+            reinterpret_cast<const char*>(&stored_entry.toc_entry),
+            sizeof(kpak::TocEntry)
+        );
+    }
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!file.good()) {
+        Log::error("Failed to write archive '{}'", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace kzn
\ No newline at end of file
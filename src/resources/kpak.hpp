@@ -0,0 +1,162 @@
+#pragma once
+
+#include "core/string_hash.hpp"
+#include "resources/mapped_file.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+//! Kazan asset archive (.kpak) format.
+//!
+//! \code
+//! Header
+//! Entry data, each aligned to `kpak::alignment`
+//! Table of contents, entries sorted by key
+//! \endcode
+//!
+//! Entries are keyed by the `StringHash` of their path relative to the
+//! archive root, with '/' separators. Compressed entries are split in blocks
+//! of `kpak::block_size` bytes compressed independently with LZ4, so they can
+//! be decompressed in parallel. Their data starts with the compressed size of
+//! each block as `std::uint32_t`, followed by the blocks.
+//! \note All values are little endian.
+namespace kzn::kpak {
+
+inline constexpr std::array<char, 4> magic = {'K', 'P', 'A', 'K'};
+inline constexpr std::uint32_t version = 1;
+//! Entry data alignment, so uncompressed entries can be used in place.
+inline constexpr std::size_t alignment = 64;
+//! Uncompressed size of compressed entry blocks.
+inline constexpr std::size_t block_size = 64 * 1024;
+
+enum class Compression : std::uint32_t {
+    None = 0,
+    Lz4 = 1,
+};
+
+struct Header {
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint64_t entry_count;
+    std::uint64_t toc_offset;
+};
+
+struct TocEntry {
+    std::uint64_t key;
+    //! Offset of the entry data from the start of the archive.
+    std::uint64_t offset;
+    //! Size of the entry data in the archive.
+    std::uint64_t stored_size;
+    std::uint64_t size;
+    Compression compression;
+    std::uint32_t block_count;
+};
+
+} // namespace kzn::kpak
+
+namespace kzn {
+
+//! Bytes of an archive entry. Views the archive mapping directly if the entry
+//! isn't compressed, so it must not outlive its archive.
+class ArchiveData {
+public:
+    // Ctor
+    explicit ArchiveData(std::span<const std::byte> mapped_bytes)
+        : m_bytes{mapped_bytes} {}
+    explicit ArchiveData(std::vector<std::byte> decompressed_bytes)
+        : m_storage{std::move(decompressed_bytes)}
+        , m_bytes{m_storage} {}
+    // Copy
+    ArchiveData(const ArchiveData&) = delete;
+    ArchiveData& operator=(const ArchiveData&) = delete;
+    // Move
+    ArchiveData(ArchiveData&&) = default;
+    ArchiveData& operator=(ArchiveData&&) = default;
+    // Dtor
+    ~ArchiveData() = default;
+
+    [[nodiscard]]
+    std::span<const std::byte> bytes() const noexcept {
+        return m_bytes;
+    }
+
+private:
+    // Moving a vector keeps its buffer, so the view stays valid
+    std::vector<std::byte> m_storage;
+    std::span<const std::byte> m_bytes;
+};
+
+//! Read only .kpak archive mapped in memory.
+class PackArchive {
+public:
+    // Ctor
+    //! \throws LoadingError if the file can't be read or isn't a valid
+    //! archive.
+    explicit PackArchive(const std::filesystem::path& path);
+    // Copy
+    PackArchive(const PackArchive&) = delete;
+    PackArchive& operator=(const PackArchive&) = delete;
+    // Move
+    PackArchive(PackArchive&&) = default;
+    PackArchive& operator=(PackArchive&&) = default;
+    // Dtor
+    ~PackArchive() = default;
+
+    [[nodiscard]]
+    std::size_t entry_count() const noexcept {
+        return m_toc.size();
+    }
+
+    [[nodiscard]]
+    bool contains(StringHash key) const {
+        return find(key) != nullptr;
+    }
+
+    //! Reads an entry, decompressing it if needed. Blocks are decompressed on
+    //! the job system, if there's one.
+    //! \return std::nullopt if there's no entry with \p key.
+    //! \throws LoadingError if the entry data is corrupted.
+    [[nodiscard]]
+    std::optional<ArchiveData> read(StringHash key) const;
+
+private:
+    [[nodiscard]]
+    const kpak::TocEntry* find(StringHash key) const;
+
+private:
+    std::filesystem::path m_path;
+    MappedFile m_file;
+    std::span<const kpak::TocEntry> m_toc;
+};
+
+//! Builds .kpak archives.
+class PackWriter {
+public:
+    //! Adds an entry with the data of a file.
+    //! \param name Path relative to the archive root.
+    void add(std::string name, std::vector<std::byte> bytes);
+
+    //! Compresses the entries, on the job system if there's one, and writes
+    //! the archive. Entries that don't compress well are stored as is.
+    //! \return false if the archive couldn't be written or two entry names
+    //! have the same hash.
+    [[nodiscard]]
+    bool write(const std::filesystem::path& path, bool compress) const;
+
+private:
+    struct Entry {
+        std::string name;
+        std::vector<std::byte> bytes;
+    };
+
+private:
+    std::vector<Entry> m_entries;
+};
+
+} // namespace kzn
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "lz4.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace kzn::lz4 {
+
+namespace {
+
+constexpr std::size_t min_match = 4;
+//! The last match must start at least 12 bytes before the end of the block.
+constexpr std::size_t match_find_limit = 12;
+//! The last 5 bytes of a block are always literals.
+constexpr std::size_t last_literals = 5;
+constexpr std::size_t max_offset = 65535;
+constexpr std::size_t hash_log = 12;
+
+std::uint32_t read32(const std::byte* ptr) {
+    std::uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash4(std::uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - hash_log);
+}
+
+//! Writes the extra bytes of a literal or match length over 15.
+std::byte* write_length(std::byte* out_ptr, std::size_t length) {
+    while (length >= 255) {
+        *out_ptr++ = std::byte{255};
+        length -= 255;
+    }
+    *out_ptr++ = std::byte(length);
+    return out_ptr;
+}
+
+std::byte* write_sequence(
+    std::byte* out_ptr,
+    const std::byte* literals_ptr,
+    std::size_t literal_length,
+    std::size_t offset,
+    std::size_t match_length
+) {
+    std::byte* token_ptr = out_ptr++;
+    std::uint8_t token = 0;
+
+    // Literals
+    if (literal_length >= 15) {
+        token = 15 << 4;
+        out_ptr = write_length(out_ptr, literal_length - 15);
+    }
+    else {
+        token = std::uint8_t(literal_length << 4);
+    }
+    if (literal_length > 0) {
+        std::memcpy(out_ptr, literals_ptr, literal_length);
+        out_ptr += literal_length;
+    }
+
+    // Last sequence has no match
+    if (match_length != 0) {
+        *out_ptr++ = std::byte(offset & 0xff);
+        *out_ptr++ = std::byte(offset >> 8);
+        const std::size_t length = match_length - min_match;
+        if (length >= 15) {
+            token |= 15;
+            out_ptr = write_length(out_ptr, length - 15);
+        }
+        else {
+            token |= std::uint8_t(length);
+        }
+    }
+
+    *token_ptr = std::byte{token};
+    return out_ptr;
+}
+
+//! Reads the extra bytes of a literal or match length.
+bool read_length(
+    const std::byte*& in_ptr,
+    const std::byte* in_end,
+    std::size_t& length
+) {
+    std::uint8_t value;
+    do {
+        if (in_ptr >= in_end) {
+            return false;
+        }
+        value = std::uint8_t(*in_ptr++);
+        length += value;
+    } while (value == 255);
+    return true;
+}
+
+} // namespace
+
+std::size_t compress(std::span<const std::byte> src, std::span<std::byte> dst) {
+    if (dst.size() < compress_bound(src.size())) {
+        return 0;
+    }
+
+    const std::byte* const src_ptr = src.data();
+    const std::size_t src_size = src.size();
+    std::byte* out_ptr = dst.data();
+    std::size_t anchor = 0;
+
+    if (src_size > match_find_limit) {
+        // Last position seen for each hashed 4 byte sequence
+        std::array<std::uint32_t, 1 << hash_log> table;
+        table.fill(UINT32_MAX);
+
+        const std::size_t match_limit = src_size - last_literals;
+        std::size_t pos = 0;
+        while (pos < src_size - match_find_limit) {
+            const std::uint32_t sequence = read32(src_ptr + pos);
+            auto& entry = table[hash4(sequence)];
+            const std::size_t candidate = entry;
+            entry = std::uint32_t(pos);
+
+            if (candidate == UINT32_MAX || pos - candidate > max_offset ||
+                read32(src_ptr + candidate) != sequence) {
+                ++pos;
+                continue;
+            }
+
+            std::size_t match_length = min_match;
+            while (pos + match_length < match_limit &&
+                   src_ptr[candidate + match_length] ==
+                       src_ptr[pos + match_length]) {
+                ++match_length;
+            }
+
+            out_ptr = write_sequence(
+                out_ptr,
+                src_ptr + anchor,
+                pos - anchor,
+                pos - candidate,
+                match_length
+            );
+            pos += match_length;
+            anchor = pos;
+        }
+    }
+
+    out_ptr = write_sequence(out_ptr, src_ptr + anchor, src_size - anchor, 0, 0);
+    return std::size_t(out_ptr - dst.data());
+}
+
+bool decompress(std::span<const std::byte> src, std::span<std::byte> dst) {
+    const std::byte* in_ptr = src.data();
+    const std::byte* const in_end = in_ptr + src.size();
+    std::byte* out_ptr = dst.data();
+    std::byte* const out_end = out_ptr + dst.size();
+
+    while (in_ptr < in_end) {
+        const std::uint8_t token = std::uint8_t(*in_ptr++);
+
+        // Literals
+        std::size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(in_ptr, in_end, literal_length)) {
+            return false;
+        }
+        if (literal_length > std::size_t(in_end - in_ptr) ||
+            literal_length > std::size_t(out_end - out_ptr)) {
+            return false;
+        }
+        if (literal_length > 0) {
+            std::memcpy(out_ptr, in_ptr, literal_length);
+            in_ptr += literal_length;
+            out_ptr += literal_length;
+        }
+
+        // Last sequence has no match
+        if (in_ptr == in_end) {
+            break;
+        }
+
+        // Match
+        if (in_end - in_ptr < 2) {
+            return false;
+        }
+        const std::size_t offset =
+            std::size_t(in_ptr[0]) | (std::size_t(in_ptr[1]) << 8);
+        in_ptr += 2;
+        std::size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(in_ptr, in_end, match_length)) {
+            return false;
+        }
+        match_length += min_match;
+        if (offset == 0 || offset > std::size_t(out_ptr - dst.data()) ||
+            match_length > std::size_t(out_end - out_ptr)) {
+            return false;
+        }
+        // Byte by byte since the match may overlap the output
+        const std::byte* match_ptr = out_ptr - offset;
+        for (std::size_t i = 0; i < match_length; ++i) {
+            out_ptr[i] = match_ptr[i];
+        }
+        out_ptr += match_length;
+    }
+
+    return out_ptr == out_end;
+}
+
+} // namespace kzn::lz4
\ No newline at end of file
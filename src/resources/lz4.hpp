@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+//! LZ4 block format compression.
+//! https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//!
+//! Blocks are compressed with a single pass greedy matcher, which is fast but
+//! doesn't compress as well as the reference high compression mode. Any valid
+//! LZ4 block can be decompressed.
+namespace kzn::lz4 {
+
+//! Max compressed size of \p src_size bytes.
+[[nodiscard]]
+constexpr std::size_t compress_bound(std::size_t src_size) {
+    return src_size + src_size / 255 + 16;
+}
+
+//! Compresses \p src into \p dst.
+//! \return Compressed size, or 0 if \p dst is smaller than
+//! `compress_bound(src.size())`.
+[[nodiscard]]
+std::size_t compress(std::span<const std::byte> src, std::span<std::byte> dst);
+
+//! Decompresses the block \p src into \p dst.
+//! \return false if \p src is malformed or doesn't decompress to exactly
+//! `dst.size()` bytes.
+[[nodiscard]]
+bool decompress(std::span<const std::byte> src, std::span<std::byte> dst);
+
+} // namespace kzn::lz4
\ No newline at end of file
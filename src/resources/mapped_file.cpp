@@ -0,0 +1,109 @@
+#include "mapped_file.hpp"
+
+#include "resources/resource.hpp"
+
+#include <fmt/format.h>
+
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace kzn {
+
+#ifdef __linux__
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw LoadingError{
+            fmt::format("Failed to open file '{}'", path.c_str())
+        };
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) < 0) {
+        close(fd);
+        throw LoadingError{
+            fmt::format("Failed to stat file '{}'", path.c_str())
+        };
+    }
+    m_size = static_cast<std::size_t>(file_stat.st_size);
+
+    // Empty files can't be mapped
+    if (m_size > 0) {
+        void* data_ptr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ptr == MAP_FAILED) {
+            close(fd);
+            throw LoadingError{
+                fmt::format("Failed to map file '{}'", path.c_str())
+            };
+        }
+        // Start reading ahead, archives are read almost entirely on startup
+        madvise(data_ptr, m_size, MADV_WILLNEED);
+        m_data_ptr = static_cast<const std::byte*>(data_ptr);
+    }
+    // The mapping keeps the file open
+    close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data_ptr{std::exchange(other.m_data_ptr, nullptr)}
+    , m_size{std::exchange(other.m_size, 0)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (m_data_ptr != nullptr) {
+            munmap(const_cast<std::byte*>(m_data_ptr), m_size);
+        }
+        m_data_ptr = std::exchange(other.m_data_ptr, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data_ptr != nullptr) {
+        munmap(const_cast<std::byte*>(m_data_ptr), m_size);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file.is_open()) {
+        throw LoadingError{
+            fmt::format("Failed to open file '{}'", path.string())
+        };
+    }
+    m_bytes.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_bytes.data()), m_bytes.size());
+    m_data_ptr = m_bytes.data();
+    m_size = m_bytes.size();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data_ptr{std::exchange(other.m_data_ptr, nullptr)}
+    , m_size{std::exchange(other.m_size, 0)}
+    , m_bytes{std::move(other.m_bytes)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    m_data_ptr = std::exchange(other.m_data_ptr, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_bytes = std::move(other.m_bytes);
+    return *this;
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+} // namespace kzn
\ No newline at end of file
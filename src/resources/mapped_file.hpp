@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace kzn {
+
+//! Read only view of a whole file mapped in memory.
+//! \note Only mapped on Linux, on other platforms the file is read into
+//! memory.
+class MappedFile {
+public:
+    // Ctor
+    //! \throws LoadingError
+    explicit MappedFile(const std::filesystem::path& path);
+    // Copy
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    // Move
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    // Dtor
+    ~MappedFile();
+
+    [[nodiscard]]
+    std::span<const std::byte> bytes() const noexcept {
+        return {m_data_ptr, m_size};
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+private:
+    const std::byte* m_data_ptr = nullptr;
+    std::size_t m_size = 0;
+#ifndef __linux__
+    std::vector<std::byte> m_bytes;
+#endif
+};
+
+} // namespace kzn
\ No newline at end of file
@@ -80,7 +80,7 @@ public:
     }
 
 private:
-    FlatMap<StringHash, std::filesystem::path> m_path_aliases;
+    FlatSplitMap<StringHash, std::filesystem::path> m_path_aliases;
 };
 
 } // namespace kzn
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <source_location>
+#include <span>
+#include <string>
 #include <string_view>
+#include <typeinfo>
 
 namespace kzn {
 
@@ -16,4 +22,52 @@ concept LoadableResource = requires(const std::filesystem::path& path) {
     { T::load(path) } -> std::convertible_to<std::shared_ptr<T>>;
 };
 
+//! Concept for resource types that can also be loaded from bytes in memory,
+//! such as archive entries
+template<typename T>
+concept MemoryLoadableResource = requires(std::span<const std::byte> bytes) {
+    { T::load_from_memory(bytes) } -> std::convertible_to<std::shared_ptr<T>>;
+};
+
+//! Concept for resource types that report how much memory they use
+template<typename T>
+concept SizedResource = requires(const T& resource) {
+    { resource.byte_size() } -> std::convertible_to<std::size_t>;
+};
+
+//! Memory used by a resource, used by the resource cache memory budget.
+//! Resources that don't report their size count as their object size.
+template<typename T>
+std::size_t resource_byte_size(const T& resource) {
+    if constexpr (SizedResource<T>) {
+        return resource.byte_size();
+    }
+    else {
+        return sizeof(T);
+    }
+}
+
+//! Readable name of a resource type without its namespace, such as
+//! "TextureData", taken from the signature of this function as spelled by
+//! GCC and Clang. Falls back to the implementation defined `typeid` name.
+template<typename T>
+std::string_view resource_type_name() {
+    const std::string_view signature =
+        std::source_location::current().function_name();
+    constexpr std::string_view arg_token = "T = ";
+    const auto begin = signature.find(arg_token);
+    if (begin == signature.npos) {
+        return typeid(T).name();
+    }
+    const auto name_begin = begin + arg_token.size();
+    const auto name_end = signature.find_first_of(";]", name_begin);
+    auto name = signature.substr(name_begin, name_end - name_begin);
+    // Scopes of template arguments are kept
+    const auto scope_end = name.rfind("::", name.find('<'));
+    if (scope_end != name.npos) {
+        name.remove_prefix(scope_end + 2);
+    }
+    return name;
+}
+
 } // namespace kzn
\ No newline at end of file
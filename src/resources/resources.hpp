@@ -1,18 +1,40 @@
 #pragma once
 
+#include "core/cvar.hpp"
+#include "core/file_watcher.hpp"
+#include "core/job_system.hpp"
 #include "core/log.hpp"
 #include "core/string_hash.hpp"
+#include "events/events.hpp"
 #include "fmt/format.h"
+#include "resources/asset_path.hpp"
+#include "resources/handle.hpp"
+#include "resources/kpak.hpp"
 #include "resources/path_aliases.hpp"
 #include "resources/resource.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <filesystem>
+#include <iterator>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <source_location>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace kzn {
 
@@ -24,6 +46,258 @@ struct ResourceKeyHash {
     }
 };
 
+enum class AsyncResourceStatus {
+    Pending,
+    Ready,
+    Failed,
+};
+
+namespace internal {
+
+//! State shared between the cache, the loading job and every handle of an
+//! asynchronous load.
+struct AsyncResourceState {
+    std::atomic<AsyncResourceStatus> status = AsyncResourceStatus::Pending;
+    //! Written by the loading job before status is set.
+    std::shared_ptr<void> resource;
+    std::size_t byte_size = 0;
+    std::string error;
+};
+
+//! Type erased operations to reload a resource in place, so every existing
+//! reference sees the new data.
+struct ReloadOps {
+    std::shared_ptr<void> (*load)(
+        const std::filesystem::path& path,
+        std::size_t& byte_size
+    );
+    void (*assign)(void* dst_ptr, void* src_ptr);
+};
+
+//! Reload operations of T, or nullptr if T can't be reloaded in place.
+template<LoadableResource T>
+const ReloadOps* reload_ops() {
+    if constexpr (std::is_move_assignable_v<T>) {
+        static constexpr ReloadOps ops{
+            .load = [](const std::filesystem::path& path,
+                       std::size_t& byte_size) -> std::shared_ptr<void> {
+                auto resource_ptr = T::load(path);
+                if (resource_ptr == nullptr) {
+                    throw LoadingError{"Loader returned no resource"};
+                }
+                byte_size = resource_byte_size(*resource_ptr);
+                return resource_ptr;
+            },
+            .assign =
+                [](void* dst_ptr, void* src_ptr) {
+                    *static_cast<T*>(dst_ptr) =
+                        std::move(*static_cast<T*>(src_ptr));
+                },
+        };
+        return &ops;
+    }
+    else {
+        return nullptr;
+    }
+}
+
+//! Appends \p str to \p out as a quoted JSON string.
+inline void append_json_string(std::string& out, const std::string_view str) {
+    out += '"';
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fmt::format_to(std::back_inserter(out), "\\u{:04x}", int(c));
+            }
+            else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+} // namespace internal
+
+//! Handle to a resource being loaded in the background. Cheap to copy, can be
+//! stored in components right away and polled until the resource is ready.
+template<LoadableResource T>
+class AsyncResource {
+public:
+    // Ctor
+    AsyncResource() = default;
+
+    [[nodiscard]]
+    AsyncResourceStatus status() const noexcept {
+        return (m_state_ptr != nullptr)
+                   ? m_state_ptr->status.load(std::memory_order_acquire)
+                   : AsyncResourceStatus::Failed;
+    }
+
+    [[nodiscard]]
+    bool is_pending() const noexcept {
+        return status() == AsyncResourceStatus::Pending;
+    }
+
+    [[nodiscard]]
+    bool is_ready() const noexcept {
+        return status() == AsyncResourceStatus::Ready;
+    }
+
+    [[nodiscard]]
+    bool has_failed() const noexcept {
+        return status() == AsyncResourceStatus::Failed;
+    }
+
+    //! Loaded resource, or nullptr if it's not ready.
+    [[nodiscard]]
+    std::shared_ptr<T> get() const {
+        return is_ready() ? std::static_pointer_cast<T>(m_state_ptr->resource)
+                          : nullptr;
+    }
+
+    //! Loading error message if the load failed.
+    [[nodiscard]]
+    std::string_view error() const {
+        return has_failed() && m_state_ptr != nullptr
+                   ? std::string_view{m_state_ptr->error}
+                   : std::string_view{};
+    }
+
+private:
+    friend class ResourceCache;
+
+    explicit AsyncResource(
+        std::shared_ptr<internal::AsyncResourceState> state_ptr
+    )
+        : m_state_ptr{std::move(state_ptr)} {}
+
+private:
+    std::shared_ptr<internal::AsyncResourceState> m_state_ptr;
+};
+
+//! Memory used by cached resources and cache usage counters, of one resource
+//! type or of all of them.
+struct ResourceStats {
+    //! Resources currently in the cache.
+    std::size_t count = 0;
+    //! Memory used by the resources currently in the cache.
+    std::size_t bytes = 0;
+    //! Requests served by a cached or in flight resource.
+    std::uint64_t hits = 0;
+    //! Requests that had to load the resource.
+    std::uint64_t misses = 0;
+    //! Resources evicted to stay within the memory budget.
+    std::uint64_t evictions = 0;
+
+    ResourceStats& operator+=(const ResourceStats& other) {
+        count += other.count;
+        bytes += other.bytes;
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        return *this;
+    }
+};
+
+//! Where the time loading a resource went and how much data it took, to find
+//! the resources that dominate loading and the ones loaded redundantly.
+struct ResourceLoadRecord {
+    std::string path;
+    //! Resource type name, from `resource_type_name()`.
+    std::string type;
+    //! Source file and line that requested the load.
+    std::string call_site;
+    bool is_async = false;
+    //! Read from a mounted archive rather than from its file.
+    bool from_archive = false;
+    //! The same file was already loaded as the same type, through another
+    //! path or before it was evicted, and that record is still kept.
+    bool is_redundant = false;
+    //! Resolving the path alias, in milliseconds.
+    float resolve_ms = 0.f;
+    //! Reading the archive entry, in milliseconds. Resources loaded from
+    //! files read them while decoding, so their I/O is part of `decode_ms`.
+    float io_ms = 0.f;
+    //! Creating the resource from its bytes, in milliseconds.
+    float decode_ms = 0.f;
+    //! Creating GPU data from the resource, in milliseconds, as reported with
+    //! `ResourceCache::profile_upload()` or `ResourceCache::add_upload_time()`.
+    float upload_ms = 0.f;
+    //! Size of the archive entry or file.
+    std::size_t bytes_read = 0;
+    //! Memory used by the loaded resource.
+    std::size_t decoded_bytes = 0;
+    //! Requests served by the cached resource after it was loaded.
+    std::uint64_t hits = 0;
+
+    [[nodiscard]]
+    float total_ms() const {
+        return resolve_ms + io_ms + decode_ms + upload_ms;
+    }
+};
+
+inline CVar<int> cvar_res_budget_mb{
+    "res_budget_mb",
+    1024,
+    "Resource cache memory budget in MiB, 0 for unlimited"
+};
+inline CVar<int> cvar_res_profile_max_records{
+    "res_profile_max_records",
+    4096,
+    "Load records kept for profiling, oldest dropped first, 0 to disable"
+};
+inline CVar<bool> cvar_res_hot_reload{
+    "res_hot_reload",
+    false,
+    "Reload cached resources when their files change"
+};
+
+//! Cache of loaded resources keyed by asset path id and type.
+//!
+//! Resources are keyed by the path as written, so a cache hit is a single
+//! lookup without resolving path aliases. The same file requested through
+//! different paths, such as "textures://a.png" and "assets://textures/a.png",
+//! is cached once per path.
+//!
+//! Resources are kept in least recently used order. When the memory used by
+//! cached resources exceeds the `res_budget_mb` budget, the least recently
+//! used resources that are no longer referenced outside the cache are evicted.
+//! Referenced resources are never evicted, so the budget may be exceeded.
+//!
+//! With `res_hot_reload` enabled, the directories of cached resources are
+//! watched and changed files are loaded again on the job system. The new data
+//! is moved into the existing resource object on `update()`, so references to
+//! it stay valid, and a `ResourceReloadedEvent` is sent for dependents to
+//! rebuild what they created from it. Reloaded data is only moved in once the
+//! job system is idle, so no job reads a resource while it's overwritten.
+//!
+//! Resources that can be loaded from memory are read from mounted .kpak
+//! archives when these have an entry for them, and from files otherwise.
+//!
+//! Every load is recorded with the time spent resolving, reading, decoding
+//! and uploading the resource, see `load_records()` and
+//! `load_profile_json()`.
+//!
+//! Resources can also be referenced by `Handle<T>`, an index and generation
+//! into a dense pool per type, which is dereferenced without hashing or
+//! refcounting. Handles are counted explicitly with `acquire()`, `retain()`
+//! and `release()`, and keep their resource from being evicted.
+//! \note Handle functions are meant for the main thread and aren't
+//! synchronized with each other.
 class ResourceCache {
 public:
     PathAliases path_aliases;
@@ -32,69 +306,870 @@ public:
     ResourceCache() = default;
     ~ResourceCache() = default;
 
+    //! Path of the resource being loaded by the cache on this thread, as
+    //! requested, so loaders can load the resources it references through
+    //! the cache relative to it. Empty outside of loads and for reloads.
+    [[nodiscard]]
+    static std::string_view loading_path() noexcept {
+        return t_loading_path;
+    }
+
     //! Find resource of specified type T, if not found, returns nullptr.
-    //! \warning If specified type is not same type as the loaded resource,
-    //! or if path contains a path alias that wasn't registered, throws
-    // LoadingError.
     template<LoadableResource T>
-    std::shared_ptr<T> find(const std::string_view path) const {
-        const auto resolved_path_opt = path_aliases.resolve(path);
-        // If path contains a path alias that wasn't registered.
-        if (resolved_path_opt == std::nullopt) {
-            throw LoadingError{fmt::format("Unknown path alias '{}'", path)};
-        }
+    std::shared_ptr<T> find(const AssetPath path) {
+        const auto key = resource_key<T>(path);
 
-        const auto& resolved_path = resolved_path_opt.value();
-        const auto key = std::make_pair(
-            StringHash(std::string_view{resolved_path.native()}),
-            std::type_index(typeid(T))
-        );
+        std::scoped_lock lock{m_mutex};
         auto it = m_resources.find(key);
         if (it != m_resources.end()) {
-            return std::static_pointer_cast<T>(it->second);
+            touch(it->second);
+            return std::static_pointer_cast<T>(it->second.resource);
         }
 
         return nullptr;
     }
 
     //! Find or load resource of specified type T
+    //! If the resource is being loaded asynchronously, waits for it while
+    //! running pending jobs.
     //! \warning If specified type is not same type as the loaded resource,
     //! or if path contains a path alias that wasn't registered, throws
     // LoadingError.
     template<LoadableResource T>
-    std::shared_ptr<T> load(const std::string_view path) {
-        const auto resolved_path_opt = path_aliases.resolve(path);
-        // If path contains a path alias that wasn't registered.
-        if (resolved_path_opt == std::nullopt) {
-            throw LoadingError{fmt::format("Unknown path alias '{}'", path)};
+    std::shared_ptr<T> load(
+        const AssetPath path,
+        const std::source_location call_site = std::source_location::current()
+    ) {
+        const auto key = resource_key<T>(path);
+
+        std::shared_ptr<internal::AsyncResourceState> in_flight_ptr;
+        {
+            std::scoped_lock lock{m_mutex};
+            auto it = m_resources.find(key);
+            if (it != m_resources.end()) {
+                touch(it->second);
+                count_hit(key);
+                return std::static_pointer_cast<T>(it->second.resource);
+            }
+            auto in_flight_it = m_in_flight.find(key);
+            if (in_flight_it != m_in_flight.end()) {
+                in_flight_ptr = in_flight_it->second;
+                count_hit(key);
+            }
+            else {
+                ++m_stats[key.second].misses;
+            }
         }
 
-        const auto& resolved_path = resolved_path_opt.value();
-        const auto key = std::make_pair(
-            StringHash(std::string_view{resolved_path.native()}),
-            std::type_index(typeid(T))
+        if (in_flight_ptr != nullptr) {
+            wait(*in_flight_ptr);
+            if (in_flight_ptr->status == AsyncResourceStatus::Failed) {
+                throw LoadingError{in_flight_ptr->error};
+            }
+            return std::static_pointer_cast<T>(in_flight_ptr->resource);
+        }
+
+        // Load without holding the lock, loaders may load other resources
+        auto record = make_load_record<T>(path.str(), call_site, false);
+        const auto resolve_begin = Clock::now();
+        const auto resolved_path = resolve(path);
+        record.resolve_ms = elapsed_ms(resolve_begin);
+        auto resource_ptr = load_resource<T>(path.str(), resolved_path, record);
+        const auto byte_size = resource_byte_size(*resource_ptr);
+        record.decoded_bytes = byte_size;
+
+        std::scoped_lock lock{m_mutex};
+        add_load_record(key, resolved_path, std::move(record), resource_ptr.get());
+        auto loaded_ptr = std::static_pointer_cast<T>(
+            insert(
+                key,
+                std::move(resource_ptr),
+                byte_size,
+                resolved_path,
+                internal::reload_ops<T>()
+            ).resource
         );
-        auto it = m_resources.find(key);
-        if (it != m_resources.end()) {
-            return std::static_pointer_cast<T>(it->second);
+        evict_unused();
+
+        Log::info("Loaded '{}'", path.str());
+
+        return loaded_ptr;
+    }
+
+    //! Find or start loading resource of specified type T on the job system.
+    //! Requests of a resource already being loaded share the same load.
+    //! The resource is added to the cache and a `ResourceLoadedEvent` is sent
+    //! on the next `update()`.
+    //! \note Loads synchronously if there's no job system.
+    //! \note If path contains a path alias that wasn't registered, the load
+    //! fails.
+    template<LoadableResource T>
+    AsyncResource<T> load_async(
+        const AssetPath path,
+        const std::source_location call_site = std::source_location::current()
+    ) {
+        const auto key = resource_key<T>(path);
+
+        auto state_ptr = std::make_shared<internal::AsyncResourceState>();
+        {
+            std::scoped_lock lock{m_mutex};
+            auto it = m_resources.find(key);
+            if (it != m_resources.end()) {
+                touch(it->second);
+                count_hit(key);
+                state_ptr->resource = it->second.resource;
+                state_ptr->status = AsyncResourceStatus::Ready;
+                return AsyncResource<T>{std::move(state_ptr)};
+            }
+            auto [in_flight_it, inserted] =
+                m_in_flight.try_emplace(key, state_ptr);
+            if (!inserted) {
+                count_hit(key);
+                return AsyncResource<T>{in_flight_it->second};
+            }
+            ++m_stats[key.second].misses;
         }
 
-        auto [inserted_it, _] = m_resources.insert({
-            key,
-            std::static_pointer_cast<void>(T::load(resolved_path.native()))
+        auto load_job = [this,
+                         key,
+                         state_ptr,
+                         path = std::string{path.str()},
+                         record = make_load_record<T>(
+                             path.str(), call_site, true
+                         )]() mutable {
+            std::filesystem::path resolved_path;
+            bool succeeded = false;
+            try {
+                const auto resolve_begin = Clock::now();
+                resolved_path = resolve(path);
+                record.resolve_ms = elapsed_ms(resolve_begin);
+                auto resource_ptr =
+                    load_resource<T>(path, resolved_path, record);
+                state_ptr->byte_size = resource_byte_size(*resource_ptr);
+                record.decoded_bytes = state_ptr->byte_size;
+                state_ptr->resource = std::move(resource_ptr);
+                succeeded = true;
+            }
+            catch (const LoadingError& e) {
+                state_ptr->error = e.message;
+            }
+            catch (const std::exception& e) {
+                state_ptr->error = e.what();
+            }
+            // Jobs must not throw, whatever the loader threw
+            catch (...) {
+                state_ptr->error = "Unknown error";
+            }
+            if (!succeeded && state_ptr->error.empty()) {
+                state_ptr->error = "Unknown error";
+            }
+            // Recorded before the status is set, so uploads by threads
+            // waiting for the resource are added to its record
+            std::scoped_lock lock{m_mutex};
+            if (succeeded) {
+                add_load_record(
+                    key,
+                    resolved_path,
+                    std::move(record),
+                    state_ptr->resource.get()
+                );
+            }
+            state_ptr->status.store(
+                succeeded ? AsyncResourceStatus::Ready
+                          : AsyncResourceStatus::Failed,
+                std::memory_order_release
+            );
+            m_completed.push_back(CompletedLoad{
+                key,
+                state_ptr,
+                std::move(path),
+                std::move(resolved_path),
+                internal::reload_ops<T>(),
+            });
+        };
+
+        if (JobSystem::exists()) {
+            JobSystem::singleton().schedule(std::move(load_job));
+        }
+        else {
+            load_job();
+        }
+        return AsyncResource<T>{std::move(state_ptr)};
+    }
+
+    //! Publishes finished asynchronous loads into the cache and sends their
+    //! `ResourceLoadedEvent`, then evicts unused resources over the memory
+    //! budget. Swaps in reloaded resources and starts reloading changed ones.
+    //! Called once per frame from the main thread.
+    void update() {
+        update_reloads();
+
+        std::vector<CompletedLoad> completed;
+        {
+            std::scoped_lock lock{m_mutex};
+            completed.swap(m_completed);
+            for (const auto& load : completed) {
+                if (load.state_ptr->status == AsyncResourceStatus::Ready) {
+                    insert(
+                        load.key,
+                        load.state_ptr->resource,
+                        load.state_ptr->byte_size,
+                        load.resolved_path,
+                        load.reload_ops_ptr
+                    );
+                }
+                m_in_flight.erase(load.key);
+            }
+            // Resources may have been released since the last update
+            evict_unused();
+        }
+
+        for (const auto& load : completed) {
+            const bool success =
+                load.state_ptr->status == AsyncResourceStatus::Ready;
+            if (success) {
+                Log::info("Loaded '{}'", load.path);
+            }
+            else {
+                Log::error(
+                    "Failed to load '{}': {}", load.path, load.state_ptr->error
+                );
+            }
+            EventManager::send(ResourceLoadedEvent{
+                .path = load.path,
+                .type = load.key.second,
+                .success = success,
+            });
+        }
+    }
+
+    //! Find or load resource of specified type T and get a handle to it.
+    //! Acquiring the same resource again returns the same handle with its
+    //! count incremented.
+    //! \throws LoadingError like `load()`.
+    template<LoadableResource T>
+    [[nodiscard]]
+    Handle<T> acquire(
+        const AssetPath path,
+        const std::source_location call_site = std::source_location::current()
+    ) {
+        const auto key = path.id();
+        auto& resource_pool = pool<T>();
+        if (auto handle = resource_pool.acquire(key); !handle.is_null()) {
+            std::scoped_lock lock{m_mutex};
+            count_hit(resource_key<T>(path));
+            return handle;
+        }
+        return resource_pool.insert(key, load<T>(path, call_site));
+    }
+
+    //! Resource of a handle, or nullptr if it's null or was released.
+    template<LoadableResource T>
+    [[nodiscard]]
+    T* get(Handle<T> handle) const noexcept {
+        const auto type_index = internal::resource_type_index<T>();
+        if (type_index >= m_pools.size() || m_pools[type_index] == nullptr) {
+            return nullptr;
+        }
+        return static_cast<const internal::ResourcePool<T>&>(
+                   *m_pools[type_index]
+        ).get(handle);
+    }
+
+    //! Increments the count of a handle, for each copy stored elsewhere.
+    template<LoadableResource T>
+    void retain(Handle<T> handle) {
+        pool<T>().retain(handle);
+    }
+
+    //! Decrements the count of a handle. The resource may be evicted once
+    //! every handle to it was released and it's not referenced otherwise.
+    template<LoadableResource T>
+    void release(Handle<T> handle) {
+        pool<T>().release(handle);
+    }
+
+    //! Mounts a .kpak archive for paths with a path alias. Its entries are
+    //! looked up by path relative to the alias, "textures://a/b.png" is the
+    //! entry "a/b.png" of archives mounted on "textures". Archives mounted
+    //! later take precedence.
+    //! \throws LoadingError if the archive can't be read.
+    void mount(StringHash alias, const std::filesystem::path& archive_path) {
+        auto archive_ptr = std::make_unique<PackArchive>(archive_path);
+        Log::info(
+            "Mounted '{}' ({} entries)",
+            archive_path.c_str(),
+            archive_ptr->entry_count()
+        );
+
+        std::scoped_lock lock{m_mutex};
+        m_archives.emplace_back(alias, std::move(archive_ptr));
+    }
+
+    //! Memory usage and counters of resources of type T.
+    template<LoadableResource T>
+    [[nodiscard]]
+    ResourceStats stats() const {
+        std::scoped_lock lock{m_mutex};
+        auto it = m_stats.find(typeid(T));
+        return (it != m_stats.end()) ? it->second : ResourceStats{};
+    }
+
+    //! Memory usage and counters of all resources.
+    [[nodiscard]]
+    ResourceStats total_stats() const {
+        std::scoped_lock lock{m_mutex};
+        ResourceStats total;
+        for (const auto& [_, type_stats] : m_stats) {
+            total += type_stats;
+        }
+        return total;
+    }
+
+    //! Records of the latest `res_profile_max_records` resources loaded, in
+    //! load order.
+    [[nodiscard]]
+    std::vector<ResourceLoadRecord> load_records() const {
+        std::scoped_lock lock{m_mutex};
+        std::vector<ResourceLoadRecord> records;
+        records.reserve(m_load_records.size());
+        for (const auto& stored : m_load_records) {
+            records.push_back(stored.record);
+        }
+        return records;
+    }
+
+    //! Runs \p upload_fn, which creates GPU data from a loaded resource, and
+    //! adds the time it took to the load record of the resource.
+    //! \return Result of \p upload_fn.
+    template<typename Fn>
+    auto profile_upload(const void* resource_ptr, Fn&& upload_fn) {
+        const auto upload_begin = Clock::now();
+        auto result = std::forward<Fn>(upload_fn)();
+        add_upload_time(resource_ptr, elapsed_ms(upload_begin));
+        return result;
+    }
+
+    //! Adds \p upload_ms to the load record of a resource, for uploads that
+    //! are batched with other resources and timed by the caller.
+    void add_upload_time(const void* resource_ptr, float upload_ms) {
+        std::scoped_lock lock{m_mutex};
+        if (auto it = m_record_indices_by_resource.find(resource_ptr);
+            it != m_record_indices_by_resource.end()) {
+            record_at(it->second).upload_ms += upload_ms;
+        }
+    }
+
+    //! Load records and cache hit and miss counters as JSON.
+    [[nodiscard]]
+    std::string load_profile_json() const {
+        const auto records = load_records();
+        const auto total = total_stats();
+        const auto requests = total.hits + total.misses;
+
+        std::string json;
+        auto out = std::back_inserter(json);
+        fmt::format_to(
+            out,
+            "{{\n  \"hits\": {},\n  \"misses\": {},\n  \"hit_ratio\": {:.4f},\n"
+            "  \"loads\": [",
+            total.hits,
+            total.misses,
+            requests > 0 ? double(total.hits) / double(requests) : 0.0
+        );
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const auto& record = records[i];
+            json += (i == 0) ? "\n    {\"path\": " : ",\n    {\"path\": ";
+            internal::append_json_string(json, record.path);
+            json += ", \"type\": ";
+            internal::append_json_string(json, record.type);
+            json += ", \"call_site\": ";
+            internal::append_json_string(json, record.call_site);
+            fmt::format_to(
+                out,
+                ", \"async\": {}, \"archive\": {}, \"redundant\": {}, "
+                "\"resolve_ms\": {:.3f}, \"io_ms\": {:.3f}, "
+                "\"decode_ms\": {:.3f}, \"upload_ms\": {:.3f}, "
+                "\"bytes_read\": {}, \"decoded_bytes\": {}, \"hits\": {}}}",
+                record.is_async,
+                record.from_archive,
+                record.is_redundant,
+                record.resolve_ms,
+                record.io_ms,
+                record.decode_ms,
+                record.upload_ms,
+                record.bytes_read,
+                record.decoded_bytes,
+                record.hits
+            );
+        }
+        json += records.empty() ? "]\n}\n" : "\n  ]\n}\n";
+        return json;
+    }
+
+private:
+    using ResourceKey = std::pair<StringHash, std::type_index>;
+    using Clock = std::chrono::steady_clock;
+
+    struct CacheEntry {
+        std::shared_ptr<void> resource;
+        std::size_t byte_size;
+        //! Position in the LRU list.
+        std::list<ResourceKey>::iterator lru_it;
+        std::filesystem::path path;
+        //! Null if the resource can't be reloaded.
+        const internal::ReloadOps* reload_ops_ptr;
+    };
+
+    //! Sets `loading_path()` while in scope, loads may be nested.
+    struct LoadingPathScope {
+        explicit LoadingPathScope(std::string_view path)
+            : previous_path{std::exchange(t_loading_path, path)}
+        {}
+        LoadingPathScope(const LoadingPathScope&) = delete;
+        LoadingPathScope& operator=(const LoadingPathScope&) = delete;
+        ~LoadingPathScope() { t_loading_path = previous_path; }
+
+        std::string_view previous_path;
+    };
+
+    //! Load record and what refers to it, to forget it once it's dropped.
+    struct StoredLoadRecord {
+        ResourceLoadRecord record;
+        ResourceKey key;
+        ResourceKey file_key;
+        const void* resource_ptr;
+    };
+
+    struct CompletedLoad {
+        ResourceKey key;
+        std::shared_ptr<internal::AsyncResourceState> state_ptr;
+        std::string path;
+        std::filesystem::path resolved_path;
+        const internal::ReloadOps* reload_ops_ptr;
+    };
+
+    struct CompletedReload {
+        ResourceKey key;
+        std::shared_ptr<void> resource;
+        std::size_t byte_size;
+    };
+
+private:
+    template<LoadableResource T>
+    static ResourceKey resource_key(const AssetPath path) {
+        return {path.id(), std::type_index(typeid(T))};
+    }
+
+    [[nodiscard]]
+    static float elapsed_ms(Clock::time_point begin) {
+        return std::chrono::duration<float, std::milli>(Clock::now() - begin)
+            .count();
+    }
+
+    template<LoadableResource T>
+    [[nodiscard]]
+    static ResourceLoadRecord make_load_record(
+        const std::string_view path,
+        const std::source_location& call_site,
+        bool is_async
+    ) {
+        return ResourceLoadRecord{
+            .path = std::string{path},
+            .type = std::string{resource_type_name<T>()},
+            .call_site = fmt::format(
+                "{}:{}",
+                std::filesystem::path{call_site.file_name()}.filename().native(),
+                call_site.line()
+            ),
+            .is_async = is_async,
+        };
+    }
+
+    //! Resolves the path alias of a path, only needed to load a resource.
+    //! \throws LoadingError if the path alias wasn't registered.
+    std::filesystem::path resolve(const AssetPath path) const {
+        auto resolved_path_opt = path_aliases.resolve(path.str());
+        if (resolved_path_opt == std::nullopt) {
+            throw LoadingError{
+                fmt::format("Unknown path alias '{}'", path.str())
+            };
+        }
+        return std::move(resolved_path_opt.value());
+    }
+
+    template<LoadableResource T>
+    internal::ResourcePool<T>& pool() {
+        const auto type_index = internal::resource_type_index<T>();
+        if (type_index >= m_pools.size()) {
+            m_pools.resize(type_index + 1);
+        }
+        if (m_pools[type_index] == nullptr) {
+            m_pools[type_index] = std::make_unique<internal::ResourcePool<T>>();
+        }
+        return static_cast<internal::ResourcePool<T>&>(*m_pools[type_index]);
+    }
+
+    //! Loads a resource from a mounted archive if it has an entry for it,
+    //! otherwise from its file, timing it in \p record.
+    //! \throws LoadingError if loading fails or the loader returns null.
+    template<LoadableResource T>
+    std::shared_ptr<T> load_resource(
+        const std::string_view path,
+        const std::filesystem::path& resolved_path,
+        ResourceLoadRecord& record
+    ) {
+        if constexpr (MemoryLoadableResource<T>) {
+            const auto io_begin = Clock::now();
+            if (auto data_opt = read_archive(path)) {
+                record.io_ms = elapsed_ms(io_begin);
+                record.from_archive = true;
+                record.bytes_read = data_opt->bytes().size();
+                const auto decode_begin = Clock::now();
+                const LoadingPathScope loading_path_scope{path};
+                auto resource_ptr = T::load_from_memory(data_opt->bytes());
+                record.decode_ms = elapsed_ms(decode_begin);
+                if (resource_ptr == nullptr) {
+                    throw LoadingError{fmt::format(
+                        "Failed to load '{}': loader returned no resource", path
+                    )};
+                }
+                return resource_ptr;
+            }
+        }
+        std::error_code ec;
+        const auto file_size = std::filesystem::file_size(resolved_path, ec);
+        record.bytes_read = ec ? 0 : std::size_t(file_size);
+        const auto decode_begin = Clock::now();
+        const LoadingPathScope loading_path_scope{path};
+        auto resource_ptr = T::load(resolved_path.native());
+        record.decode_ms = elapsed_ms(decode_begin);
+        if (resource_ptr == nullptr) {
+            throw LoadingError{
+                fmt::format("Failed to load '{}': loader returned no resource", path)
+            };
+        }
+        return resource_ptr;
+    }
+
+    //! Reads the entry of an aliased path from the latest archive mounted on
+    //! its alias that contains it.
+    std::optional<ArchiveData> read_archive(const std::string_view path) const {
+        constexpr std::string_view alias_end_token = "://";
+        const auto token_pos = path.find(alias_end_token);
+        if (token_pos == path.npos) {
+            return std::nullopt;
+        }
+        const StringHash alias{path.substr(0, token_pos)};
+        const StringHash entry_key{
+            path.substr(token_pos + alias_end_token.size())
+        };
+
+        // Mounted archives are never removed, read without holding the lock
+        const PackArchive* archive_ptr = nullptr;
+        {
+            std::scoped_lock lock{m_mutex};
+            for (auto it = m_archives.rbegin(); it != m_archives.rend(); ++it) {
+                if (it->first == alias && it->second->contains(entry_key)) {
+                    archive_ptr = it->second.get();
+                    break;
+                }
+            }
+        }
+        if (archive_ptr == nullptr) {
+            return std::nullopt;
+        }
+        return archive_ptr->read(entry_key);
+    }
+
+    //! Waits for an asynchronous load running pending jobs meanwhile.
+    static void wait(const internal::AsyncResourceState& state) {
+        while (state.status.load(std::memory_order_acquire) ==
+               AsyncResourceStatus::Pending) {
+            if (!JobSystem::exists() || !JobSystem::singleton().try_run_job()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //! Applies finished reloads and reloads resources of changed files.
+    //! Reloads are only applied while no job is queued or running, since
+    //! they overwrite resources jobs may be reading.
+    void update_reloads() {
+        std::vector<ResourceReloadedEvent> events;
+        std::vector<JobFn> reload_jobs;
+        // Resources are reloaded in place, jobs may be reading them
+        const bool can_apply_reloads =
+            !JobSystem::exists() || JobSystem::singleton().is_idle();
+        {
+            std::scoped_lock lock{m_mutex};
+            auto reloaded = can_apply_reloads
+                                ? std::exchange(m_reloaded, {})
+                                : std::vector<CompletedReload>{};
+            for (auto& reload : reloaded) {
+                auto it = m_resources.find(reload.key);
+                // Evicted while reloading
+                if (it == m_resources.end()) {
+                    continue;
+                }
+                auto& entry = it->second;
+                entry.reload_ops_ptr->assign(
+                    entry.resource.get(), reload.resource.get()
+                );
+
+                auto& type_stats = m_stats[reload.key.second];
+                type_stats.bytes =
+                    type_stats.bytes - entry.byte_size + reload.byte_size;
+                m_total_bytes =
+                    m_total_bytes - entry.byte_size + reload.byte_size;
+                entry.byte_size = reload.byte_size;
+
+                events.push_back(ResourceReloadedEvent{
+                    .path = entry.path.native(),
+                    .type = reload.key.second,
+                    .resource_ptr = entry.resource.get(),
+                });
+            }
+
+            // Start or stop watching files when toggled
+            if (cvar_res_hot_reload.get() != (m_watcher_ptr != nullptr)) {
+                m_watcher_ptr = cvar_res_hot_reload.get()
+                                    ? std::make_unique<FileWatcher>()
+                                    : nullptr;
+                for (const auto& [_, entry] : m_resources) {
+                    watch(entry);
+                }
+            }
+            if (m_watcher_ptr != nullptr) {
+                for (const auto& changed_path : m_watcher_ptr->poll_changes()) {
+                    reload(changed_path, reload_jobs);
+                }
+            }
+        }
+
+        // Reload jobs lock the cache when done
+        for (auto& reload_job : reload_jobs) {
+            if (JobSystem::exists()) {
+                JobSystem::singleton().schedule(std::move(reload_job));
+            }
+            else {
+                reload_job();
+            }
+        }
+
+        for (const auto& event : events) {
+            Log::info("Reloaded '{}'", event.path);
+            EventManager::send(event);
+        }
+    }
+
+    // NOTE: The following functions must be called with m_mutex locked.
+
+    //! Watches the directory of an entry if hot reload is enabled.
+    void watch(const CacheEntry& entry) {
+        if (m_watcher_ptr != nullptr && entry.reload_ops_ptr != nullptr) {
+            m_watcher_ptr->watch(entry.path.parent_path());
+        }
+    }
+
+    //! Creates jobs to load again every resource of a file.
+    void reload(
+        const std::filesystem::path& path,
+        std::vector<JobFn>& reload_jobs
+    ) {
+        for (const auto& [key, entry] : m_resources) {
+            if (entry.path != path || entry.reload_ops_ptr == nullptr) {
+                continue;
+            }
+            reload_jobs.push_back([this,
+                                   key = key,
+                                   path,
+                                   reload_ops_ptr = entry.reload_ops_ptr] {
+                CompletedReload reload{key, nullptr, 0};
+                try {
+                    reload.resource =
+                        reload_ops_ptr->load(path, reload.byte_size);
+                }
+                catch (const LoadingError& e) {
+                    Log::error(
+                        "Failed to reload '{}': {}", path.native(), e.message
+                    );
+                    return;
+                }
+                catch (const std::exception& e) {
+                    Log::error(
+                        "Failed to reload '{}': {}", path.native(), e.what()
+                    );
+                    return;
+                }
+                std::scoped_lock lock{m_mutex};
+                m_reloaded.push_back(std::move(reload));
+            });
+        }
+    }
+
+    //! Counts a request served by a cached or in flight resource.
+    void count_hit(const ResourceKey& key) {
+        ++m_stats[key.second].hits;
+        if (auto it = m_record_indices.find(key); it != m_record_indices.end()) {
+            ++record_at(it->second).hits;
+        }
+    }
+
+    //! Kept record of a record number.
+    ResourceLoadRecord& record_at(std::size_t record_number) {
+        return m_load_records[record_number - m_dropped_records].record;
+    }
+
+    //! Adds the record of a resource that was just loaded, dropping the
+    //! oldest records over `res_profile_max_records`.
+    void add_load_record(
+        const ResourceKey& key,
+        const std::filesystem::path& resolved_path,
+        ResourceLoadRecord record,
+        const void* resource_ptr
+    ) {
+        const auto max_records =
+            std::size_t(std::max(cvar_res_profile_max_records.get(), 0));
+        if (max_records == 0) {
+            drop_load_records(0);
+            return;
+        }
+        drop_load_records(max_records - 1);
+
+        const ResourceKey file_key{StringHash{resolved_path.native()}, key.second};
+        const std::size_t record_number =
+            m_dropped_records + m_load_records.size();
+        const auto [file_it, is_first_load] =
+            m_loaded_files.insert_or_assign(file_key, record_number);
+        record.is_redundant = !is_first_load;
+        m_record_indices[key] = record_number;
+        m_record_indices_by_resource[resource_ptr] = record_number;
+        m_load_records.push_back(StoredLoadRecord{
+            std::move(record), key, file_key, resource_ptr
         });
+    }
+
+    //! Drops the oldest records until at most \p max_records are kept, and
+    //! forgets the keys, files and resources that refer to them.
+    void drop_load_records(std::size_t max_records) {
+        const auto erase_if_dropped = [this](auto& indices, const auto& key) {
+            if (auto it = indices.find(key);
+                it != indices.end() && it->second == m_dropped_records) {
+                indices.erase(it);
+            }
+        };
+        while (m_load_records.size() > max_records) {
+            const auto& stored = m_load_records.front();
+            erase_if_dropped(m_record_indices, stored.key);
+            erase_if_dropped(m_record_indices_by_resource, stored.resource_ptr);
+            erase_if_dropped(m_loaded_files, stored.file_key);
+            m_load_records.pop_front();
+            ++m_dropped_records;
+        }
+    }
+
+    //! Marks an entry as the most recently used.
+    void touch(CacheEntry& entry) {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lru_it);
+    }
+
+    //! Adds a resource to the cache, keeps the existing entry if the resource
+    //! was already added.
+    CacheEntry& insert(
+        const ResourceKey& key,
+        std::shared_ptr<void> resource_ptr,
+        std::size_t byte_size,
+        const std::filesystem::path& path,
+        const internal::ReloadOps* reload_ops_ptr
+    ) {
+        const void* raw_resource_ptr = resource_ptr.get();
+        auto [it, inserted] = m_resources.try_emplace(
+            key,
+            CacheEntry{
+                std::move(resource_ptr), byte_size, {}, path, reload_ops_ptr
+            }
+        );
+        if (!inserted) {
+            // The resource loaded concurrently is dropped, and its address
+            // may be reused
+            m_record_indices_by_resource.erase(raw_resource_ptr);
+            touch(it->second);
+            return it->second;
+        }
+        it->second.lru_it = m_lru.insert(m_lru.begin(), key);
+        watch(it->second);
+
+        auto& type_stats = m_stats[key.second];
+        ++type_stats.count;
+        type_stats.bytes += byte_size;
+        m_total_bytes += byte_size;
+        return it->second;
+    }
+
+    //! Evicts least recently used resources only referenced by the cache
+    //! until the memory used is within budget.
+    void evict_unused() {
+        const std::size_t budget =
+            std::size_t(std::max(cvar_res_budget_mb.get(), 0)) * 1024 * 1024;
+        if (budget == 0) {
+            return;
+        }
 
-        Log::info("Loaded '{}'", path);
+        auto lru_it = m_lru.end();
+        while (m_total_bytes > budget && lru_it != m_lru.begin()) {
+            --lru_it;
+            auto it = m_resources.find(*lru_it);
+            // Still in use
+            if (it->second.resource.use_count() > 1) {
+                continue;
+            }
 
-        return std::static_pointer_cast<T>(inserted_it->second);
+            auto& type_stats = m_stats[lru_it->second];
+            --type_stats.count;
+            type_stats.bytes -= it->second.byte_size;
+            ++type_stats.evictions;
+            m_total_bytes -= it->second.byte_size;
+
+            m_record_indices_by_resource.erase(it->second.resource.get());
+            m_resources.erase(it);
+            lru_it = m_lru.erase(lru_it);
+        }
     }
 
 private:
+    static inline thread_local std::string_view t_loading_path;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<ResourceKey, CacheEntry, ResourceKeyHash> m_resources;
+    //! Cached resource keys, most recently used first.
+    std::list<ResourceKey> m_lru;
+    std::size_t m_total_bytes = 0;
+    std::unordered_map<std::type_index, ResourceStats> m_stats;
     std::unordered_map<
-        std::pair<StringHash, std::type_index>,
-        std::shared_ptr<void>,
+        ResourceKey,
+        std::shared_ptr<internal::AsyncResourceState>,
         ResourceKeyHash
-    > m_resources;
+    > m_in_flight;
+    std::vector<CompletedLoad> m_completed;
+    std::unique_ptr<FileWatcher> m_watcher_ptr;
+    std::vector<CompletedReload> m_reloaded;
+    std::vector<std::pair<StringHash, std::unique_ptr<PackArchive>>> m_archives;
+    //! Handle pools indexed by `internal::resource_type_index<T>()`.
+    std::vector<std::unique_ptr<internal::ResourcePoolBase>> m_pools;
+    //! Latest records, capped by `res_profile_max_records`.
+    std::deque<StoredLoadRecord> m_load_records;
+    //! Records dropped so far, the number of the oldest kept record.
+    std::size_t m_dropped_records = 0;
+    //! Latest record number of each resource key and of each loaded
+    //! resource, only for kept records.
+    std::unordered_map<ResourceKey, std::size_t, ResourceKeyHash> m_record_indices;
+    //! Only holds cached resources, entries are erased once their resource
+    //! is evicted or dropped so a reused address doesn't match.
+    std::unordered_map<const void*, std::size_t> m_record_indices_by_resource;
+    //! Latest record number of the resolved paths and types of kept records,
+    //! to flag files loaded again.
+    std::unordered_map<ResourceKey, std::size_t, ResourceKeyHash> m_loaded_files;
 };
 
 // NOTE: This will be a global for now, but in the future, application should
@@ -0,0 +1,175 @@
+#include "core/flat_map.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Correctness checks
+///////////////////////////////////////////////////////////////////////////////
+
+void check_bulk_insert() {
+    FlatMap<int, int> map{{3, 30}, {1, 10}, {2, 20}, {1, 11}};
+    assert(map.size() == 3);
+    // First occurrence is kept
+    assert(map.at(1) == 10);
+
+    // Existing keys are not overwritten
+    const std::vector<std::pair<int, int>> more{{2, 21}, {0, 0}, {4, 40}};
+    map.insert_range(more);
+    assert(map.size() == 5);
+    assert(map.at(2) == 20);
+    assert(std::ranges::is_sorted(map, {}, [](auto& v) { return v.first; }));
+}
+
+void check_heterogeneous_find() {
+    FlatMap<std::string, int, std::less<>> map{{"shaders", 1}, {"textures", 2}};
+    const std::string_view key = "textures";
+    assert(map.find(key) != map.end());
+    assert(map.find(key)->second == 2);
+    assert(!map.contains(std::string_view{"models"}));
+}
+
+void check_split_map() {
+    std::mt19937 rng{42};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> data;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        data.emplace_back(rng() % 5000, i);
+    }
+    FlatMap<std::uint32_t, std::uint32_t> map(data.begin(), data.end());
+    FlatSplitMap<std::uint32_t, std::uint32_t> split_map(data.begin(), data.end());
+    assert(map.size() == split_map.size());
+    for (std::uint32_t k = 0; k < 5000; ++k) {
+        const auto it = map.find(k);
+        const auto split_it = split_map.find(k);
+        assert((it == map.end()) == (split_it == split_map.end()));
+        if (it != map.end()) {
+            assert(it->second == split_it->second);
+        }
+    }
+    split_map[7000] = 1;
+    assert(split_map.contains(7000));
+    assert(split_map.erase(7000));
+    assert(!split_map.contains(7000));
+}
+
+//! Counts default constructions, which only a missing key should cause.
+struct Counted {
+    static inline int constructions = 0;
+    int value = (++constructions, 0);
+};
+
+void check_split_map_subscript() {
+    FlatSplitMap<std::uint32_t, Counted> map;
+    map[1].value = 10;
+    assert(Counted::constructions == 1);
+    assert(map[1].value == 10);
+    assert(Counted::constructions == 1);
+    map[2].value = 20;
+    assert(Counted::constructions == 2);
+    assert(map.at(1).value == 10 && map.at(2).value == 20);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+using Clock = std::chrono::high_resolution_clock;
+
+template<typename Fn>
+double time_ns(Fn&& fn) {
+    auto start = Clock::now();
+    fn();
+    auto end = Clock::now();
+    return double(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+    );
+}
+
+void benchmark(std::size_t num_keys, std::size_t lookups) {
+    std::mt19937_64 rng{num_keys};
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> data(num_keys);
+    for (auto& [key, value] : data) {
+        key = rng();
+        value = key ^ 0xFF;
+    }
+    std::vector<std::uint64_t> queries(lookups);
+    for (auto& query : queries) {
+        // Half hits, half misses
+        query = (rng() & 1) ? data[rng() % num_keys].first : rng();
+    }
+
+    std::size_t sink = 0;
+
+    // Build
+    const double build_one_by_one_ns = time_ns([&] {
+        FlatMap<std::uint64_t, std::uint64_t> map;
+        for (auto& value : data) {
+            map.insert(value);
+        }
+        sink += map.size();
+    });
+    FlatMap<std::uint64_t, std::uint64_t> flat_map;
+    const double build_bulk_ns = time_ns([&] {
+        flat_map = FlatMap<std::uint64_t, std::uint64_t>(data.begin(), data.end());
+    });
+    FlatSplitMap<std::uint64_t, std::uint64_t> split_map;
+    const double build_split_ns = time_ns([&] {
+        split_map = FlatSplitMap<std::uint64_t, std::uint64_t>(data.begin(), data.end());
+    });
+    std::unordered_map<std::uint64_t, std::uint64_t> unordered_map;
+    const double build_unordered_ns = time_ns([&] {
+        unordered_map.reserve(num_keys);
+        unordered_map.insert(data.begin(), data.end());
+    });
+
+    // Lookup
+    const double find_flat_ns = time_ns([&] {
+        for (auto query : queries) {
+            auto it = flat_map.find(query);
+            sink += (it != flat_map.end()) ? it->second : 0;
+        }
+    });
+    const double find_split_ns = time_ns([&] {
+        for (auto query : queries) {
+            auto it = split_map.find(query);
+            sink += (it != split_map.end()) ? it->second : 0;
+        }
+    });
+    const double find_unordered_ns = time_ns([&] {
+        for (auto query : queries) {
+            auto it = unordered_map.find(query);
+            sink += (it != unordered_map.end()) ? it->second : 0;
+        }
+    });
+
+    std::cout << num_keys << " keys (sink " << (sink & 1) << ")\n"
+              << "  build FlatMap one by one: " << build_one_by_one_ns / num_keys << " ns/key\n"
+              << "  build FlatMap bulk:       " << build_bulk_ns / num_keys << " ns/key\n"
+              << "  build FlatSplitMap bulk:  " << build_split_ns / num_keys << " ns/key\n"
+              << "  build unordered_map:      " << build_unordered_ns / num_keys << " ns/key\n"
+              << "  find FlatMap:             " << find_flat_ns / lookups << " ns/find\n"
+              << "  find FlatSplitMap:        " << find_split_ns / lookups << " ns/find\n"
+              << "  find unordered_map:       " << find_unordered_ns / lookups << " ns/find\n";
+}
+
+int main() {
+    check_bulk_insert();
+    check_heterogeneous_find();
+    check_split_map();
+    check_split_map_subscript();
+
+    constexpr std::size_t lookups = 1'000'000;
+    for (std::size_t num_keys : {8, 64, 512, 4096, 32768, 100000}) {
+        benchmark(num_keys, lookups);
+    }
+
+    return 0;
+}
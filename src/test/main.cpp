@@ -47,12 +47,15 @@ struct TestApp : public BasicApp {
 
     void create_test_level() {
         auto create_mesh = [this](auto mesh_path, auto position) {
-            auto& device = m_systems
+            auto& renderer = m_systems
                 .get<RenderSystem>()
-                .context<Renderer>()
-                .device();
+                .context<Renderer>();
             auto entity = m_scene.registry.create();
-            entity.emplace<MeshComponent>(device, mesh_path);
+            entity.emplace<MeshComponent>(
+                renderer.geometry_pools(),
+                renderer.material_cache(),
+                mesh_path
+            );
             auto& transform = entity.emplace<Transform3DComponent>();
             transform.position = position;
         };
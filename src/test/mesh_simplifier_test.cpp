@@ -0,0 +1,112 @@
+#include "graphics/mesh.hpp"
+#include "graphics/mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+using namespace kzn;
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers
+///////////////////////////////////////////////////////////////////////////////
+
+//! Appends a grid of \p size by \p size quads from \p min_x to \p max_x as a
+//! submesh with vertices of its own.
+void add_grid_submesh(MeshData& mesh, int size, float min_x, float max_x) {
+    const auto first_vertex = static_cast<std::uint32_t>(mesh.vertices.size());
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            const float u = static_cast<float>(x) / static_cast<float>(size);
+            const float v = static_cast<float>(y) / static_cast<float>(size);
+            mesh.vertices.push_back(Vertex3D{
+                .position = Vec3{min_x + u * (max_x - min_x), v, 0.f},
+                .normal = Vec3{0.f, 0.f, 1.f},
+                .uv = Vec2{u, v},
+            });
+        }
+    }
+
+    const auto vertex = [&](int x, int y) {
+        return first_vertex + static_cast<std::uint32_t>(y * (size + 1) + x);
+    };
+    const auto index_offset = static_cast<std::uint32_t>(mesh.indices.size());
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            mesh.indices.insert(mesh.indices.end(), {
+                vertex(x, y), vertex(x + 1, y), vertex(x, y + 1),
+                vertex(x + 1, y), vertex(x + 1, y + 1), vertex(x, y + 1),
+            });
+        }
+    }
+    mesh.submeshes.push_back(Submesh{
+        .index_offset = index_offset,
+        .index_count = static_cast<std::uint32_t>(mesh.indices.size()) - index_offset,
+    });
+}
+
+//! Edges of \p indices lying on the line x = \p seam_x, as sorted pairs of y.
+std::set<std::pair<float, float>> seam_edges(
+    const MeshData& mesh,
+    std::span<const std::uint32_t> indices,
+    float seam_x
+) {
+    std::set<std::pair<float, float>> edges;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        for (std::size_t k = 0; k < 3; ++k) {
+            const auto& a = mesh.vertices[indices[i + k]].position;
+            const auto& b = mesh.vertices[indices[i + (k + 1) % 3]].position;
+            if (a.x == seam_x && b.x == seam_x) {
+                edges.emplace(std::min(a.y, b.y), std::max(a.y, b.y));
+            }
+        }
+    }
+    return edges;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Correctness checks
+///////////////////////////////////////////////////////////////////////////////
+
+void check_submesh_seams() {
+    // Two halves meeting at x = 0.5, each with its own seam vertices
+    MeshData mesh;
+    add_grid_submesh(mesh, 40, 0.f, 0.5f);
+    add_grid_submesh(mesh, 40, 0.5f, 1.f);
+
+    generate_lods(mesh, 3);
+    assert(!mesh.lods.empty());
+
+    const auto base_seam = seam_edges(mesh, mesh.indices, 0.5f);
+    for (const auto& lod : mesh.lods) {
+        assert(lod.submeshes.size() == 2);
+        const auto indices = std::span<const std::uint32_t>{lod.indices};
+        const auto& left = lod.submeshes[0];
+        const auto& right = lod.submeshes[1];
+        const auto left_seam = seam_edges(
+            mesh,
+            indices.subspan(left.index_offset, left.index_count),
+            0.5f
+        );
+        const auto right_seam = seam_edges(
+            mesh,
+            indices.subspan(right.index_offset, right.index_count),
+            0.5f
+        );
+        assert(left_seam == right_seam);
+        assert(left_seam == base_seam);
+        assert(lod.indices.size() < mesh.indices.size());
+    }
+}
+
+int main() {
+    check_submesh_seams();
+
+    std::cout << "mesh simplifier checks passed\n";
+    return 0;
+}
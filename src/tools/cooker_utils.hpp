@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core/log.hpp"
+#include "core/string_hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+//! File and hashing helpers shared by the asset cookers.
+namespace kzn::cooker {
+
+[[nodiscard]]
+inline std::optional<std::vector<std::byte>> read_file(
+    const std::filesystem::path& path
+) {
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    std::vector<std::byte> bytes(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    return bytes;
+}
+
+//! Writes a file, creating its directory if needed. Logs an error on failure.
+inline bool write_file(
+    const std::filesystem::path& path,
+    std::span<const std::byte> bytes
+) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    if (!file.good()) {
+        Log::error("Failed to write '{}'", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+//! FNV-1a of the sources of a cooked asset and of the settings it was cooked
+//! with, stored in its header to skip cooking it again.
+class SourceHasher {
+public:
+    void add(std::span<const std::byte> bytes) {
+        for (const std::byte byte : bytes) {
+            m_hash = (m_hash ^ std::uint64_t(byte)) * Params::prime;
+        }
+    }
+
+    template<typename T>
+    void add(std::span<const T> values) {
+        add(std::as_bytes(values));
+    }
+
+    [[nodiscard]]
+    std::uint64_t value() const noexcept {
+        return m_hash;
+    }
+
+private:
+    using Params = internal::Fnv1Params<std::uint64_t>;
+
+private:
+    std::uint64_t m_hash = Params::offset;
+};
+
+//! Whether an existing output, starting with a header of type \p Header, was
+//! cooked from sources and settings of the same hash.
+template<typename Header>
+[[nodiscard]]
+bool is_up_to_date(
+    const std::filesystem::path& output_path,
+    const decltype(Header::magic)& magic,
+    std::uint32_t version,
+    std::uint64_t hash
+) {
+    std::ifstream file{output_path, std::ios::binary};
+    Header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    return header.magic == magic && header.version == version &&
+           header.source_hash == hash;
+}
+
+} // namespace kzn::cooker
@@ -0,0 +1,64 @@
+#include "core/job_system.hpp"
+#include "core/log.hpp"
+#include "resources/kpak.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+using namespace kzn;
+
+//! Packs every file of a directory in a .kpak archive.
+//! \code
+//! kpak_cooker <input_dir> <output.kpak> [--compress]
+//! \endcode
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 4 ||
+        (argc == 4 && std::string_view{argv[3]} != "--compress")) {
+        Log::error("Usage: kpak_cooker <input_dir> <output.kpak> [--compress]");
+        return 1;
+    }
+    const std::filesystem::path input_path = argv[1];
+    const std::filesystem::path output_path = argv[2];
+    const bool compress = (argc == 4);
+
+    if (!std::filesystem::is_directory(input_path)) {
+        Log::error("'{}' is not a directory", input_path.c_str());
+        return 1;
+    }
+
+    // Compresses entries in parallel
+    JobSystem job_system;
+
+    PackWriter writer;
+    std::size_t file_count = 0;
+    for (const auto& dir_entry :
+         std::filesystem::recursive_directory_iterator{input_path}) {
+        if (!dir_entry.is_regular_file()) {
+            continue;
+        }
+
+        std::ifstream file{dir_entry.path(), std::ios::ate | std::ios::binary};
+        if (!file.is_open()) {
+            Log::error("Failed to open file '{}'", dir_entry.path().c_str());
+            return 1;
+        }
+        std::vector<std::byte> bytes(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+
+        // Entries are named like the aliased paths that load them
+        auto name = std::filesystem::relative(dir_entry.path(), input_path)
+                        .generic_string();
+        Log::trace("Adding '{}'", name);
+        writer.add(std::move(name), std::move(bytes));
+        ++file_count;
+    }
+
+    if (!writer.write(output_path, compress)) {
+        return 1;
+    }
+    Log::info("Packed {} files in '{}'", file_count, output_path.c_str());
+    return 0;
+}
@@ -0,0 +1,314 @@
+#include "core/job_system.hpp"
+#include "core/log.hpp"
+#include "graphics/kmesh.hpp"
+#include "graphics/ktex.hpp"
+#include "graphics/mesh_cooker.hpp"
+#include "graphics/mesh_optimizer.hpp"
+#include "graphics/mesh_simplifier.hpp"
+#include "graphics/scene3d.hpp"
+#include "graphics/texture_cooker.hpp"
+#include "resources/resource.hpp"
+#include "tools/cooker_utils.hpp"
+
+#include <fastgltf/core.hpp>
+#include <fastgltf/types.hpp>
+#include <fmt/format.h>
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace kzn;
+
+namespace {
+
+constexpr std::string_view usage =
+    "Usage: mesh_cooker <input> <output> [--lods <count>] [--no-optimize] "
+    "[--texture-format rgba8|bc1|bc3|bc5|bc7] "
+    "[--normal-format rgba8|bc1|bc3|bc5|bc7] [--force]";
+
+struct MeshCookOptions {
+    std::uint32_t lod_count = 3;
+    bool optimize = true;
+    //! Format of color textures and of other non-normal maps.
+    TextureFormat texture_format = TextureFormat::Bc7;
+    //! Format of normal maps, whose two channels BC5 keeps the most precise.
+    TextureFormat normal_format = TextureFormat::Bc5;
+};
+
+//! How a material uses an image, which decides how it's cooked.
+enum class TextureRole {
+    //! sRGB color, such as albedo.
+    Color,
+    //! Tangent space normals.
+    Normal,
+    //! Other linear data, such as metallic-roughness or occlusion.
+    Linear,
+};
+
+//! Role of each image of a scene. Images used in more than one role are
+//! cooked for the most demanding one, normals first, then color.
+std::vector<TextureRole> texture_roles(const Scene3DData& scene) {
+    std::vector<TextureRole> roles(scene.images.size(), TextureRole::Linear);
+    for (const auto& material_ptr : scene.materials) {
+        if (material_ptr == nullptr) {
+            continue;
+        }
+        for (std::size_t i = 0; i < scene.images.size(); ++i) {
+            if (material_ptr->normal_ptr == scene.images[i]) {
+                roles[i] = TextureRole::Normal;
+            }
+            else if (material_ptr->albedo_ptr == scene.images[i] &&
+                     roles[i] != TextureRole::Normal) {
+                roles[i] = TextureRole::Color;
+            }
+        }
+    }
+    return roles;
+}
+
+//! Local files a glTF scene references by URI, such as its .bin buffers and
+//! its images, which the output depends on as much as on the scene file.
+//! Empty if the scene can't be parsed, loading it reports why.
+std::vector<std::filesystem::path> external_files(
+    const std::filesystem::path& input_path
+) {
+    auto gltf_file_res = fastgltf::MappedGltfFile::FromPath(input_path);
+    if (gltf_file_res.error() != fastgltf::Error::None) {
+        return {};
+    }
+    // Without loading external data, buffers and images keep their URIs
+    fastgltf::Parser parser;
+    auto asset_res = parser.loadGltf(
+        gltf_file_res.get(), input_path.parent_path(), fastgltf::Options::None
+    );
+    if (asset_res.error() != fastgltf::Error::None) {
+        return {};
+    }
+
+    std::vector<std::filesystem::path> paths;
+    const auto add_uri = [&](const fastgltf::DataSource& data) {
+        const auto* uri_ptr = std::get_if<fastgltf::sources::URI>(&data);
+        if (uri_ptr != nullptr && uri_ptr->uri.isLocalPath()) {
+            paths.push_back(input_path.parent_path() / uri_ptr->uri.fspath());
+        }
+    };
+    for (const auto& buffer : asset_res->buffers) {
+        add_uri(buffer.data);
+    }
+    for (const auto& image : asset_res->images) {
+        add_uri(image.data);
+    }
+    return paths;
+}
+
+//! Hash of the source scene, the files it references and everything else
+//! that changes the output.
+std::uint64_t source_hash(
+    const std::filesystem::path& input_path,
+    std::span<const std::byte> source_bytes,
+    const MeshCookOptions& options
+) {
+    const std::array<std::uint32_t, 6> settings = {
+        kmesh::version,
+        ktex::version,
+        options.lod_count,
+        options.optimize,
+        std::uint32_t(options.texture_format),
+        std::uint32_t(options.normal_format),
+    };
+    cooker::SourceHasher hasher;
+    hasher.add(std::span<const std::uint32_t>{settings});
+    hasher.add(source_bytes);
+    for (const auto& path : external_files(input_path)) {
+        // Missing files fail the load, their path is enough
+        const auto path_str = path.generic_string();
+        hasher.add(std::span<const char>{path_str});
+        if (const auto bytes_opt = cooker::read_file(path)) {
+            hasher.add(*bytes_opt);
+        }
+    }
+    return hasher.value();
+}
+
+//! Texture as a .ktex file, cooked unless it already is.
+std::vector<std::byte> texture_bytes(
+    const TextureData& texture,
+    const TextureCookOptions& options,
+    std::uint64_t hash
+) {
+    if (texture.format == TextureFormat::Rgba8 && texture.mip_levels == 1) {
+        return cook_texture(texture, options, hash);
+    }
+    const ktex::Header header{
+        .magic = ktex::magic,
+        .version = ktex::version,
+        .source_hash = hash,
+        .format = texture.format,
+        .flags = texture.is_srgb ? ktex::flag_srgb : 0,
+        .width = texture.extent.x,
+        .height = texture.extent.y,
+        .depth = texture.extent.z,
+        .mip_levels = texture.mip_levels,
+    };
+    std::vector<std::byte> bytes(sizeof(header) + texture.byte_size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), texture.bytes, texture.byte_size());
+    return bytes;
+}
+
+bool cook_file(
+    const std::filesystem::path& input_path,
+    const std::filesystem::path& output_path,
+    const MeshCookOptions& options,
+    bool force
+) {
+    const auto source_bytes_opt = cooker::read_file(input_path);
+    if (!source_bytes_opt.has_value()) {
+        Log::error("Failed to open file '{}'", input_path.c_str());
+        return false;
+    }
+    const auto hash = source_hash(input_path, *source_bytes_opt, options);
+    if (!force &&
+        cooker::is_up_to_date<kmesh::Header>(output_path, kmesh::magic, kmesh::version, hash)) {
+        Log::trace("'{}' is up to date", output_path.c_str());
+        return true;
+    }
+
+    // Optimized and simplified by the scene loader
+    cvar_res_optimize_meshes.set(options.optimize);
+    cvar_res_mesh_lods.set(int(options.lod_count));
+    std::shared_ptr<Scene3DData> scene_ptr;
+    try {
+        scene_ptr = Scene3DData::load(input_path);
+    }
+    catch (const LoadingError& e) {
+        Log::error("Failed to load '{}': {}", input_path.c_str(), e.message);
+        return false;
+    }
+
+    const auto roles = texture_roles(*scene_ptr);
+
+    // Textures next to the mesh, named after it
+    std::vector<std::string> image_paths(scene_ptr->images.size());
+    for (std::size_t i = 0; i < scene_ptr->images.size(); ++i) {
+        const auto& image_ptr = scene_ptr->images[i];
+        if (image_ptr == nullptr) {
+            continue;
+        }
+        image_paths[i] = fmt::format("{}.{}.ktex", output_path.stem().native(), i);
+        // Only color is sRGB, other textures hold linear data
+        const auto texture_options = TextureCookOptions{
+            .format = roles[i] == TextureRole::Normal ? options.normal_format
+                                                      : options.texture_format,
+            .generate_mips = true,
+            .srgb = roles[i] == TextureRole::Color,
+        };
+        const auto texture_path = output_path.parent_path() / image_paths[i];
+        if (!cooker::write_file(texture_path, texture_bytes(*image_ptr, texture_options, hash))) {
+            return false;
+        }
+    }
+
+    const auto kmesh_bytes = cook_mesh(*scene_ptr, image_paths, hash);
+    if (!cooker::write_file(output_path, kmesh_bytes)) {
+        return false;
+    }
+    Log::info(
+        "Cooked '{}' ({} meshes, {} KiB -> {} KiB)",
+        output_path.c_str(),
+        scene_ptr->meshes.size(),
+        source_bytes_opt->size() / 1024,
+        kmesh_bytes.size() / 1024
+    );
+    return true;
+}
+
+bool is_source_scene(const std::filesystem::path& path) {
+    const auto extension = path.extension();
+    return extension == ".gltf" || extension == ".glb";
+}
+
+} // namespace
+
+//! Cooks glTF scenes into .kmesh meshes, with their textures as .ktex files
+//! next to them. If the input is a directory, every scene in it is cooked to
+//! the same relative path in the output directory. Outputs cooked from the
+//! same source file and options are skipped.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        Log::error("{}", usage);
+        return 1;
+    }
+    const std::filesystem::path input_path = argv[1];
+    const std::filesystem::path output_path = argv[2];
+
+    MeshCookOptions options;
+    bool force = false;
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--lods" && i + 1 < argc) {
+            const std::string_view count = argv[++i];
+            const auto [end_ptr, error] = std::from_chars(
+                count.data(), count.data() + count.size(), options.lod_count
+            );
+            if (error != std::errc{} || end_ptr != count.data() + count.size()) {
+                Log::error("Invalid LOD count '{}'", count);
+                return 1;
+            }
+        }
+        else if (arg == "--no-optimize") {
+            options.optimize = false;
+        }
+        else if (arg == "--texture-format" && i + 1 < argc) {
+            const auto format_opt = texture_format_from_string(argv[++i]);
+            if (!format_opt.has_value()) {
+                Log::error("Unknown format '{}'", argv[i]);
+                return 1;
+            }
+            options.texture_format = *format_opt;
+        }
+        else if (arg == "--normal-format" && i + 1 < argc) {
+            const auto format_opt = texture_format_from_string(argv[++i]);
+            if (!format_opt.has_value()) {
+                Log::error("Unknown format '{}'", argv[i]);
+                return 1;
+            }
+            options.normal_format = *format_opt;
+        }
+        else if (arg == "--force") {
+            force = true;
+        }
+        else {
+            Log::error("{}", usage);
+            return 1;
+        }
+    }
+
+    // Decodes images, simplifies meshes and compresses blocks in parallel
+    JobSystem job_system;
+
+    if (!std::filesystem::is_directory(input_path)) {
+        return cook_file(input_path, output_path, options, force) ? 0 : 1;
+    }
+
+    bool success = true;
+    for (const auto& dir_entry :
+         std::filesystem::recursive_directory_iterator{input_path}) {
+        if (!dir_entry.is_regular_file() || !is_source_scene(dir_entry.path())) {
+            continue;
+        }
+        auto file_output_path =
+            output_path / std::filesystem::relative(dir_entry.path(), input_path);
+        file_output_path.replace_extension(".kmesh");
+        success &= cook_file(dir_entry.path(), file_output_path, options, force);
+    }
+    return success ? 0 : 1;
+}
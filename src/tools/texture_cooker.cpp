@@ -0,0 +1,149 @@
+#include "core/job_system.hpp"
+#include "core/log.hpp"
+#include "graphics/ktex.hpp"
+#include "graphics/texture.hpp"
+#include "graphics/texture_cooker.hpp"
+#include "resources/resource.hpp"
+#include "tools/cooker_utils.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+using namespace kzn;
+
+namespace {
+
+constexpr std::string_view usage =
+    "Usage: texture_cooker <input> <output> [--format rgba8|bc1|bc3|bc5|bc7] "
+    "[--linear] [--no-mips] [--force]";
+
+//! Hash of the source image and everything else that changes the output.
+std::uint64_t source_hash(
+    std::span<const std::byte> source_bytes,
+    const TextureCookOptions& options
+) {
+    const std::array<std::uint32_t, 4> settings = {
+        ktex::version,
+        std::uint32_t(options.format),
+        options.generate_mips,
+        options.srgb,
+    };
+    cooker::SourceHasher hasher;
+    hasher.add(std::span<const std::uint32_t>{settings});
+    hasher.add(source_bytes);
+    return hasher.value();
+}
+
+bool cook_file(
+    const std::filesystem::path& input_path,
+    const std::filesystem::path& output_path,
+    const TextureCookOptions& options,
+    bool force
+) {
+    const auto source_bytes_opt = cooker::read_file(input_path);
+    if (!source_bytes_opt.has_value()) {
+        Log::error("Failed to open file '{}'", input_path.c_str());
+        return false;
+    }
+    const auto hash = source_hash(*source_bytes_opt, options);
+    if (!force &&
+        cooker::is_up_to_date<ktex::Header>(output_path, ktex::magic, ktex::version, hash)) {
+        Log::trace("'{}' is up to date", output_path.c_str());
+        return true;
+    }
+
+    std::shared_ptr<TextureData> source_ptr;
+    try {
+        source_ptr = TextureData::load_from_memory(*source_bytes_opt);
+    }
+    catch (const LoadingError& e) {
+        Log::error("Failed to decode '{}': {}", input_path.c_str(), e.message);
+        return false;
+    }
+    if (source_ptr->format != TextureFormat::Rgba8) {
+        Log::error("'{}' is already cooked", input_path.c_str());
+        return false;
+    }
+
+    const auto ktex_bytes = cook_texture(*source_ptr, options, hash);
+    if (!cooker::write_file(output_path, ktex_bytes)) {
+        return false;
+    }
+    Log::info(
+        "Cooked '{}' ({} KiB -> {} KiB)",
+        output_path.c_str(),
+        source_ptr->byte_size() / 1024,
+        ktex_bytes.size() / 1024
+    );
+    return true;
+}
+
+bool is_source_image(const std::filesystem::path& path) {
+    const auto extension = path.extension();
+    return extension == ".png" || extension == ".jpg" ||
+           extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+} // namespace
+
+//! Cooks source images into .ktex textures. If the input is a directory,
+//! every image in it is cooked to the same relative path in the output
+//! directory. Outputs cooked from the same source and options are skipped.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        Log::error("{}", usage);
+        return 1;
+    }
+    const std::filesystem::path input_path = argv[1];
+    const std::filesystem::path output_path = argv[2];
+
+    TextureCookOptions options;
+    bool force = false;
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            const auto format_opt = texture_format_from_string(argv[++i]);
+            if (!format_opt.has_value()) {
+                Log::error("Unknown format '{}'", argv[i]);
+                return 1;
+            }
+            options.format = *format_opt;
+        }
+        else if (arg == "--linear") {
+            options.srgb = false;
+        }
+        else if (arg == "--no-mips") {
+            options.generate_mips = false;
+        }
+        else if (arg == "--force") {
+            force = true;
+        }
+        else {
+            Log::error("{}", usage);
+            return 1;
+        }
+    }
+
+    // Compresses blocks in parallel
+    JobSystem job_system;
+
+    if (!std::filesystem::is_directory(input_path)) {
+        return cook_file(input_path, output_path, options, force) ? 0 : 1;
+    }
+
+    bool success = true;
+    for (const auto& dir_entry :
+         std::filesystem::recursive_directory_iterator{input_path}) {
+        if (!dir_entry.is_regular_file() || !is_source_image(dir_entry.path())) {
+            continue;
+        }
+        auto file_output_path =
+            output_path / std::filesystem::relative(dir_entry.path(), input_path);
+        file_output_path.replace_extension(".ktex");
+        success &= cook_file(dir_entry.path(), file_output_path, options, force);
+    }
+    return success ? 0 : 1;
+}
@@ -3,6 +3,7 @@
 #include "core/assert.hpp"
 #include "utils.hpp"
 
+#include <cstddef>
 #include <cstring>
 
 namespace kzn::vk {
@@ -68,6 +69,18 @@ void VertexBuffer::upload(const void* vertices) {
     vmaUnmapMemory(m_device_ptr->allocator(), m_allocation);
 }
 
+void VertexBuffer::upload(
+    const void* vertices,
+    VkDeviceSize offset,
+    VkDeviceSize size
+) {
+    KZN_ASSERT_MSG(offset + size <= m_buffer_size, "Upload out of bounds");
+    void* data;
+    vmaMapMemory(m_device_ptr->allocator(), m_allocation, &data);
+    memcpy(static_cast<std::byte*>(data) + offset, vertices, size);
+    vmaUnmapMemory(m_device_ptr->allocator(), m_allocation);
+}
+
 IndexBuffer::IndexBuffer(Device& device, VkDeviceSize buffer_size)
     : m_device_ptr{&device}
     , m_buffer_size(buffer_size) {
@@ -129,6 +142,18 @@ void IndexBuffer::upload(const uint32_t* indices) {
     vmaUnmapMemory(m_device_ptr->allocator(), m_allocation);
 }
 
+void IndexBuffer::upload(
+    const uint32_t* indices,
+    uint32_t first_index,
+    uint32_t count
+) {
+    KZN_ASSERT_MSG(first_index + count <= size(), "Upload out of bounds");
+    void* data;
+    vmaMapMemory(m_device_ptr->allocator(), m_allocation, &data);
+    memcpy(static_cast<uint32_t*>(data) + first_index, indices, count * sizeof(uint32_t));
+    vmaUnmapMemory(m_device_ptr->allocator(), m_allocation);
+}
+
 UniformBuffer::UniformBuffer(Device& device, VkDeviceSize buffer_size)
     : m_device_ptr{&device}
     , m_buffer_size(buffer_size) {
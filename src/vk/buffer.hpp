@@ -27,6 +27,8 @@ public:
     ~VertexBuffer();
 
     void upload(const void* vertices);
+    //! Copies \p size bytes of vertices at \p offset bytes into the buffer.
+    void upload(const void* vertices, VkDeviceSize offset, VkDeviceSize size);
 
     [[nodiscard]]
     VkBuffer vk_buffer() const {
@@ -54,6 +56,8 @@ public:
     ~IndexBuffer();
 
     void upload(const uint32_t* indices);
+    //! Copies \p count indices starting at index \p first_index.
+    void upload(const uint32_t* indices, uint32_t first_index, uint32_t count);
 
     [[nodiscard]]
     VkBuffer vk_buffer() const {
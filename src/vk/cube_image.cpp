@@ -1,16 +1,13 @@
 #include "cube_image.hpp"
 
 #include "vk/error.hpp"
+#include "vk/format.hpp"
 #include "vk/utils.hpp"
 
 #include <cstring>
 
 namespace kzn::vk {
 
-// FIXME: This should be according to format
-// Pixel size for format: 4 bytes
-constexpr uint32_t pixel_size = 4;
-
 CubeImage::CubeImage(
     Device& device,
     VkExtent3D extent,
@@ -19,7 +16,8 @@ CubeImage::CubeImage(
     VkImageAspectFlags aspect_mask
 )
     : m_device_ptr{&device}
-    , m_extent{extent} {
+    , m_extent{extent}
+    , m_format{format} {
     const uint64_t image_size = size();
 
     // 1. Create staging buffer
@@ -136,6 +134,7 @@ CubeImage& CubeImage::operator=(CubeImage&& other) {
     delete_image_data();
     m_device_ptr = other.m_device_ptr;
     m_extent = other.m_extent;
+    m_format = other.m_format;
     m_staging_buffer = other.m_staging_buffer;
     m_staging_buffer_allocation = other.m_staging_buffer_allocation;
     m_texture_image = other.m_texture_image;
@@ -154,7 +153,7 @@ CubeImage::~CubeImage() {
 }
 
 uint64_t CubeImage::size() const noexcept {
-    return m_extent.width * m_extent.height * m_extent.depth * pixel_size * 6;
+    return level_size(m_format, m_extent, 0) * 6;
 }
 
 DescriptorInfo CubeImage::info() const noexcept {
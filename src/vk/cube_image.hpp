@@ -48,6 +48,7 @@ public:
 private:
     Device* m_device_ptr;
     VkExtent3D m_extent;
+    VkFormat m_format;
     // Staging buffer
     VkBuffer m_staging_buffer;
     VmaAllocation m_staging_buffer_allocation;
@@ -3,6 +3,7 @@
 #include "core/assert.hpp"
 #include "error.hpp"
 #include "vk/dset_layout.hpp"
+#include "vk/format.hpp"
 #include <core/log.hpp>
 #include <optional>
 #include <vulkan/vulkan_core.h>
@@ -11,6 +12,8 @@
 // #define VMA_NOT_
 #include "vk_mem_alloc.h"
 
+#include <array>
+#include <cstring>
 #include <tuple>
 #include <unordered_set>
 
@@ -28,15 +31,16 @@ VkSurfaceFormatKHR SwapchainSupport::select_format() const {
     return formats[0];
 }
 
-VkPresentModeKHR SwapchainSupport::select_present_mode() const {
+VkPresentModeKHR SwapchainSupport::select_present_mode(
+    VkPresentModeKHR preferred
+) const {
     for (const auto& present_mode : present_modes) {
-        if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+        if (present_mode == preferred) {
             return present_mode;
         }
     }
     // FIFO mode is guaranteed to be available
     return VK_PRESENT_MODE_FIFO_KHR;
-    // return VK_PRESENT_MODE_IMMEDIATE_KHR;
 }
 
 VkExtent2D SwapchainSupport::select_extent(VkExtent2D extent) const {
@@ -228,6 +232,32 @@ static Device::SelectedDevice select_device(
     );
 }
 
+//! Required features plus the optional ones the device supports.
+static VkPhysicalDeviceFeatures merge_optional_features(
+    VkPhysicalDevice vk_physical_device,
+    const DeviceParams& params
+) {
+    VkPhysicalDeviceFeatures supported;
+    vkGetPhysicalDeviceFeatures(vk_physical_device, &supported);
+
+    // VkPhysicalDeviceFeatures only has VkBool32 members
+    constexpr std::size_t feature_count =
+        sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
+    std::array<VkBool32, feature_count> enabled;
+    std::array<VkBool32, feature_count> optional;
+    std::array<VkBool32, feature_count> available;
+    std::memcpy(enabled.data(), &params.features, sizeof(enabled));
+    std::memcpy(optional.data(), &params.optional_features, sizeof(optional));
+    std::memcpy(available.data(), &supported, sizeof(available));
+    for (std::size_t i = 0; i < feature_count; ++i) {
+        enabled[i] = enabled[i] || (optional[i] && available[i]);
+    }
+
+    VkPhysicalDeviceFeatures features;
+    std::memcpy(&features, enabled.data(), sizeof(features));
+    return features;
+}
+
 VkDevice create_device(
     VkPhysicalDevice vk_physical_device,
     QueueFamilies const& queue_families,
@@ -297,10 +327,13 @@ Device::Device(Instance& instance, DeviceParams&& params)
         m_instance, m_instance.available_devices(), params.extensions, params.surface
     )}
     // Create device
+    , m_enabled_features{
+        merge_optional_features(std::get<0>(m_selected_device), params)
+    }
     , m_vk_device{create_device(
         std::get<0>(m_selected_device),
         std::get<1>(m_selected_device),
-        params.features,
+        m_enabled_features,
         params.extensions
     )}
     , m_dset_allocator{m_vk_device}
@@ -324,6 +357,21 @@ Device::Device(Instance& instance, DeviceParams&& params)
     VK_CHECK_MSG(result, "Failed to create Vma allocator");
 }
 
+bool Device::supports_format(
+    VkFormat format,
+    VkFormatFeatureFlags features
+) const {
+    if (is_block_compressed(format) &&
+        !m_enabled_features.textureCompressionBC) {
+        return false;
+    }
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(
+        std::get<0>(m_selected_device), format, &properties
+    );
+    return (properties.optimalTilingFeatures & features) == features;
+}
+
 Device::~Device() {
     m_dset_layout_cache = std::nullopt;
     m_dset_allocator = std::nullopt;
@@ -30,7 +30,9 @@ struct SwapchainSupport {
     std::vector<VkPresentModeKHR> present_modes;
 
     VkSurfaceFormatKHR select_format() const;
-    VkPresentModeKHR select_present_mode() const;
+    //! Selects \p preferred if supported, otherwise falls back to FIFO which is
+    //! guaranteed to be available.
+    VkPresentModeKHR select_present_mode(VkPresentModeKHR preferred) const;
     VkExtent2D select_extent(VkExtent2D extent) const;
 };
 
@@ -105,6 +107,8 @@ struct Queue {
 struct DeviceParams {
     std::vector<char const*> extensions = {};
     VkPhysicalDeviceFeatures features = {};
+    //! Features enabled only if the selected device supports them.
+    VkPhysicalDeviceFeatures optional_features = {};
     VkSurfaceKHR surface = VK_NULL_HANDLE;
 };
 
@@ -145,6 +149,17 @@ public:
         return std::get<1>(m_selected_device);
     }
 
+    [[nodiscard]]
+    const VkPhysicalDeviceFeatures& enabled_features() const {
+        return m_enabled_features;
+    }
+
+    //! Whether images of \p format with optimal tiling support all
+    //! \p features. Block compressed formats also require their device
+    //! feature to be enabled.
+    [[nodiscard]]
+    bool supports_format(VkFormat format, VkFormatFeatureFlags features) const;
+
     [[nodiscard]]
     VmaAllocator allocator() {
         return m_vma_allocator;
@@ -179,6 +194,7 @@ public:
 private:
     vk::Instance& m_instance;
     SelectedDevice m_selected_device;
+    VkPhysicalDeviceFeatures m_enabled_features;
     VkDevice m_vk_device = VK_NULL_HANDLE;
     VkQueue m_vk_graphics_queue;
     VkQueue m_vk_present_queue;
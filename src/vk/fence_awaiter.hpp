@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/job_system.hpp"
+#include "core/log.hpp"
+#include "vk/device.hpp"
+#include "vk/error.hpp"
+
+#include <coroutine>
+#include <thread>
+
+namespace kzn::vk {
+
+//! Awaitable that resumes the awaiting coroutine once a fence is signaled.
+//! The fence is polled by a job that schedules itself again until the fence
+//! is signaled, so no worker is blocked waiting for the GPU and other jobs
+//! run in between. Without a job system the awaiting thread polls.
+//!
+//! \example
+//! \code
+//! vkQueueSubmit(queue, 1, &submit_info, upload_fence);
+//! co_await vk::FenceAwaiter{.device = device, .fence = upload_fence};
+//! \endcode
+//! \warning The fence must not be destroyed or reset before the awaiting
+//! coroutine is resumed.
+//! \throws ResultError on resume if the fence couldn't be waited for, e.g.
+//! when the device is lost.
+struct FenceAwaiter {
+    Device& device;
+    VkFence fence;
+    VkResult status = VK_NOT_READY;
+
+    bool await_ready() {
+        status = vkGetFenceStatus(device, fence);
+        return status != VK_NOT_READY;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        if (!JobSystem::exists()) {
+            while (!await_ready()) {
+                std::this_thread::yield();
+            }
+            return false;
+        }
+        poll(JobSystem::singleton(), handle);
+        return true;
+    }
+
+    void await_resume() const {
+        VK_CHECK_MSG(status, "Failed to wait for fence");
+    }
+
+    //! Schedules a job resuming \p handle if the fence is signaled, or
+    //! polling again otherwise.
+    void poll(JobSystem& job_system, std::coroutine_handle<> handle) {
+        job_system.schedule([this, &job_system, handle] {
+            if (await_ready()) {
+                handle.resume();
+                return;
+            }
+            // Let other threads run before the fence is polled again
+            std::this_thread::yield();
+            poll(job_system, handle);
+        });
+    }
+};
+
+} // namespace kzn::vk
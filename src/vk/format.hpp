@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+namespace kzn::vk {
+
+//! Memory layout of a format. Uncompressed formats have 1x1 blocks.
+struct FormatInfo {
+    //! Width and height of a block in pixels.
+    uint32_t block_extent;
+    //! Size of a block in bytes.
+    uint32_t block_size;
+};
+
+//! Layout of the formats used by the engine, or a zero block size for other
+//! formats.
+[[nodiscard]]
+constexpr FormatInfo format_info(VkFormat format) {
+    switch (format) {
+        // 8 bit
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_SRGB:
+            return {1, 1};
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R8G8_SRGB:
+            return {1, 2};
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return {1, 4};
+        // 16 bit
+        case VK_FORMAT_R16_UNORM:
+        case VK_FORMAT_R16_SFLOAT:
+        case VK_FORMAT_D16_UNORM:
+            return {1, 2};
+        case VK_FORMAT_R16G16_UNORM:
+        case VK_FORMAT_R16G16_SFLOAT:
+            return {1, 4};
+        case VK_FORMAT_R16G16B16A16_UNORM:
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return {1, 8};
+        // 32 bit
+        case VK_FORMAT_R32_SFLOAT:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+            return {1, 4};
+        case VK_FORMAT_R32G32_SFLOAT:
+            return {1, 8};
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return {1, 16};
+        // Block compressed
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            return {4, 8};
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return {4, 16};
+        default:
+            return {1, 0};
+    }
+}
+
+[[nodiscard]]
+constexpr bool is_block_compressed(VkFormat format) {
+    return format_info(format).block_extent > 1;
+}
+
+//! Size in bytes of one layer of a mip level.
+[[nodiscard]]
+constexpr uint64_t level_size(
+    VkFormat format,
+    VkExtent3D extent,
+    uint32_t level
+) {
+    const auto info = format_info(format);
+    const auto blocks = [&](uint32_t size) {
+        const uint32_t level_size = (size >> level) > 0 ? (size >> level) : 1;
+        return uint64_t{(level_size + info.block_extent - 1) / info.block_extent};
+    };
+    const uint64_t depth = (extent.depth >> level) > 0 ? (extent.depth >> level) : 1;
+    return blocks(extent.width) * blocks(extent.height) * depth * info.block_size;
+}
+
+} // namespace kzn::vk
@@ -2,25 +2,58 @@
 
 #include "core/assert.hpp"
 #include "vk/error.hpp"
+#include "vk/fence_awaiter.hpp"
+#include "vk/format.hpp"
 #include "vk/utils.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <exception>
+#include <vector>
 
 namespace kzn::vk {
 
-// FIXME: This should be according to format
-// Pixel size for format: 4 bytes
-constexpr uint32_t pixel_size = 4;
+//! Format features needed to create an image with some usage.
+static VkFormatFeatureFlags required_format_features(VkImageUsageFlags usage_flags) {
+    VkFormatFeatureFlags features = 0;
+    if (usage_flags & VK_IMAGE_USAGE_SAMPLED_BIT) {
+        features |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    }
+    if (usage_flags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) {
+        features |= VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    }
+    if (usage_flags & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) {
+        features |= VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
+    }
+    if (usage_flags & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+        features |= VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    }
+    return features;
+}
 
 Image::Image(
     Device& device,
     VkExtent3D extent,
     VkFormat format,
     VkImageUsageFlags usage_flags,
-    VkImageAspectFlags aspect_mask
+    VkImageAspectFlags aspect_mask,
+    uint32_t mip_levels,
+    uint32_t array_layers
 )
     : m_device_ptr{&device}
-    , m_extent{extent} {
+    , m_extent{extent}
+    , m_format{format}
+    , m_mip_levels{mip_levels}
+    , m_array_layers{array_layers} {
+    KZN_ASSERT_MSG(
+        format_info(format).block_size != 0,
+        "Image format size is unknown"
+    );
+    KZN_ASSERT_MSG(
+        device.supports_format(format, required_format_features(usage_flags)),
+        "Image format is not supported by the device"
+    );
     const uint64_t image_size = size();
     KZN_ASSERT_MSG(image_size != 0, "Cannot have a zero sized image");
 
@@ -52,8 +85,8 @@ Image::Image(
     image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     image_info.imageType = VK_IMAGE_TYPE_2D;
     image_info.extent = m_extent;
-    image_info.mipLevels = 1;
-    image_info.arrayLayers = 1;
+    image_info.mipLevels = m_mip_levels;
+    image_info.arrayLayers = m_array_layers;
     // Image format
     image_info.format = format;
     image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -80,13 +113,14 @@ Image::Image(
     VkImageViewCreateInfo view_info{};
     view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     view_info.image = m_texture_image;
-    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.viewType = (m_array_layers > 1) ? VK_IMAGE_VIEW_TYPE_2D_ARRAY
+                                              : VK_IMAGE_VIEW_TYPE_2D;
     view_info.format = format;
     view_info.subresourceRange.aspectMask = aspect_mask;
     view_info.subresourceRange.baseMipLevel = 0;
-    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.levelCount = m_mip_levels;
     view_info.subresourceRange.baseArrayLayer = 0;
-    view_info.subresourceRange.layerCount = 1;
+    view_info.subresourceRange.layerCount = m_array_layers;
 
     result = vkCreateImageView(
         *m_device_ptr, &view_info, nullptr, &m_texture_image_view
@@ -113,7 +147,7 @@ Image::Image(
     sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     sampler_info.mipLodBias = 0.0f;
     sampler_info.minLod = 0.0f;
-    sampler_info.maxLod = 0.0f;
+    sampler_info.maxLod = static_cast<float>(m_mip_levels);
 
     result = vkCreateSampler(
         *m_device_ptr, &sampler_info, nullptr, &m_texture_sampler
@@ -124,6 +158,9 @@ Image::Image(
 Image::Image(Image&& other)
     : m_device_ptr{other.m_device_ptr}
     , m_extent{other.m_extent}
+    , m_format{other.m_format}
+    , m_mip_levels{other.m_mip_levels}
+    , m_array_layers{other.m_array_layers}
     , m_staging_buffer{other.m_staging_buffer}
     , m_staging_buffer_allocation{other.m_staging_buffer_allocation}
     , m_texture_image{other.m_texture_image}
@@ -138,6 +175,9 @@ Image& Image::operator=(Image&& other) {
     delete_image_data();
     m_device_ptr = other.m_device_ptr;
     m_extent = other.m_extent;
+    m_format = other.m_format;
+    m_mip_levels = other.m_mip_levels;
+    m_array_layers = other.m_array_layers;
     m_staging_buffer = other.m_staging_buffer;
     m_staging_buffer_allocation = other.m_staging_buffer_allocation;
     m_texture_image = other.m_texture_image;
@@ -156,7 +196,11 @@ Image::~Image() {
 }
 
 uint64_t Image::size() const noexcept {
-    return m_extent.width * m_extent.height * m_extent.depth * pixel_size;
+    uint64_t image_size = 0;
+    for (uint32_t level = 0; level < m_mip_levels; ++level) {
+        image_size += level_size(m_format, m_extent, level);
+    }
+    return image_size * m_array_layers;
 }
 
 DescriptorInfo Image::info() const noexcept {
@@ -171,42 +215,233 @@ DescriptorInfo Image::info() const noexcept {
 }
 
 void Image::upload(const void* data) {
-    // 1. Upload data to staging buffer
+    write_staging(data);
+    vk::immediate_submit(
+        m_device_ptr->graphics_queue(),
+        [&](vk::CommandBuffer& cmd_buffer) { record_upload(cmd_buffer); }
+    );
+}
+
+Task<void> Image::upload_async(const void* data) {
+    write_staging(data);
+
+    auto cmd_pool = vk::CommandPool(*m_device_ptr);
+    auto cmd_buffer = cmd_pool.allocate();
+    cmd_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    record_upload(cmd_buffer);
+    cmd_buffer.end();
+
+    const auto queue = m_device_ptr->graphics_queue();
+    const auto upload_fence = create_fence(*m_device_ptr);
+    VkCommandBuffer cmd_buffers[] = {cmd_buffer.vk_cmd_buffer()};
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = cmd_buffers;
+    auto result = vkQueueSubmit(queue.vk_queue, 1, &submit_info, upload_fence);
+    if (result != VK_SUCCESS) {
+        destroy_fence(*m_device_ptr, upload_fence);
+        VK_CHECK_MSG(result, "Failed to submit image upload");
+    }
+
+    // The fence is destroyed even if waiting for it failed
+    std::exception_ptr exception;
+    try {
+        co_await FenceAwaiter{.device = *m_device_ptr, .fence = upload_fence};
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+    destroy_fence(*m_device_ptr, upload_fence);
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void Image::write_staging(const void* data) {
     void* mapped_memory;
     vmaMapMemory(
         m_device_ptr->allocator(), m_staging_buffer_allocation, &mapped_memory
     );
     std::memcpy(mapped_memory, data, static_cast<size_t>(size()));
     vmaUnmapMemory(m_device_ptr->allocator(), m_staging_buffer_allocation);
+}
+
+void Image::record_upload(vk::CommandBuffer& cmd_buffer) {
+    // 1. Transition image to transfer dst layout
+    VkImageSubresourceRange range;
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.baseMipLevel = 0;
+    range.levelCount = m_mip_levels;
+    range.baseArrayLayer = 0;
+    range.layerCount = m_array_layers;
 
-    // 2. Copy data to image
+    VkImageMemoryBarrier image_barrier_transfer_dst = {};
+    image_barrier_transfer_dst.sType =
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_barrier_transfer_dst.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_barrier_transfer_dst.newLayout =
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    image_barrier_transfer_dst.image = m_texture_image;
+    image_barrier_transfer_dst.subresourceRange = range;
+    image_barrier_transfer_dst.srcAccessMask = 0;
+    image_barrier_transfer_dst.dstAccessMask =
+        VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    // Barrier the image into the transfer-receive layout
+    vkCmdPipelineBarrier(
+        cmd_buffer.vk_cmd_buffer(),
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &image_barrier_transfer_dst
+    );
+
+    // 2. Copy buffer to image, one region per mip level
+    std::vector<VkBufferImageCopy> copy_regions(m_mip_levels);
+    VkDeviceSize buffer_offset = 0;
+    for (uint32_t level = 0; level < m_mip_levels; ++level) {
+        auto& copy_region = copy_regions[level];
+        copy_region.bufferOffset = buffer_offset;
+        copy_region.bufferRowLength = 0;
+        copy_region.bufferImageHeight = 0;
+        copy_region.imageSubresource.aspectMask =
+            VK_IMAGE_ASPECT_COLOR_BIT;
+        copy_region.imageSubresource.mipLevel = level;
+        copy_region.imageSubresource.baseArrayLayer = 0;
+        copy_region.imageSubresource.layerCount = m_array_layers;
+        copy_region.imageExtent = VkExtent3D{
+            .width = std::max(m_extent.width >> level, 1u),
+            .height = std::max(m_extent.height >> level, 1u),
+            .depth = std::max(m_extent.depth >> level, 1u),
+        };
+        buffer_offset +=
+            level_size(m_format, m_extent, level) * m_array_layers;
+    }
+
+    // Copy the staging buffer into the image
+    vkCmdCopyBufferToImage(
+        cmd_buffer.vk_cmd_buffer(),
+        m_staging_buffer,
+        m_texture_image,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<uint32_t>(copy_regions.size()),
+        copy_regions.data()
+    );
+
+    // 3. Transition image to shader read optimal layout
+    VkImageMemoryBarrier image_barrier_shader_readeable =
+        image_barrier_transfer_dst;
+    image_barrier_shader_readeable.oldLayout =
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    image_barrier_shader_readeable.newLayout =
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    image_barrier_shader_readeable.srcAccessMask =
+        VK_ACCESS_TRANSFER_WRITE_BIT;
+    image_barrier_shader_readeable.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT;
+    // Barrier the image into the shader readable layout
+    vkCmdPipelineBarrier(
+        cmd_buffer.vk_cmd_buffer(),
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &image_barrier_shader_readeable
+    );
+}
+
+void Image::upload_regions(
+    const void* data,
+    std::span<const VkRect2D> rects
+) {
+    const auto pixel_size = format_info(m_format).block_size;
+    KZN_ASSERT_MSG(
+        !is_block_compressed(m_format) && m_mip_levels == 1 &&
+            m_array_layers == 1,
+        "Regions can only be uploaded to uncompressed single level images"
+    );
+    if (rects.empty()) {
+        return;
+    }
+
+    // 1. Pack the rows of every rectangle into the staging buffer
+    void* mapped_memory;
+    vmaMapMemory(
+        m_device_ptr->allocator(), m_staging_buffer_allocation, &mapped_memory
+    );
+    const auto* src_bytes = static_cast<const std::byte*>(data);
+    auto* dst_bytes = static_cast<std::byte*>(mapped_memory);
+    const std::size_t src_row_size = std::size_t{m_extent.width} * pixel_size;
+    std::vector<VkBufferImageCopy> copy_regions;
+    copy_regions.reserve(rects.size());
+    VkDeviceSize buffer_offset = 0;
+    for (const auto& rect : rects) {
+        KZN_ASSERT_MSG(
+            rect.offset.x >= 0 && rect.offset.y >= 0 &&
+                rect.offset.x + rect.extent.width <= m_extent.width &&
+                rect.offset.y + rect.extent.height <= m_extent.height,
+            "Region is out of the image bounds"
+        );
+        const std::size_t row_size = std::size_t{rect.extent.width} * pixel_size;
+        for (uint32_t y = 0; y < rect.extent.height; ++y) {
+            std::memcpy(
+                dst_bytes + buffer_offset + y * row_size,
+                src_bytes + (std::size_t(rect.offset.y) + y) * src_row_size +
+                    std::size_t(rect.offset.x) * pixel_size,
+                row_size
+            );
+        }
+        copy_regions.push_back(VkBufferImageCopy{
+            .bufferOffset = buffer_offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {rect.offset.x, rect.offset.y, 0},
+            .imageExtent = {rect.extent.width, rect.extent.height, 1},
+        });
+        buffer_offset += VkDeviceSize{row_size} * rect.extent.height;
+    }
+    vmaUnmapMemory(m_device_ptr->allocator(), m_staging_buffer_allocation);
+
+    // 2. Copy the regions, keeping the rest of the image
     vk::immediate_submit(
         m_device_ptr->graphics_queue(),
         [&](vk::CommandBuffer& cmd_buffer) {
-            // 2.1. Transition image to transfer dst layout
-            VkImageSubresourceRange range;
-            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            range.baseMipLevel = 0;
-            range.levelCount = 1;
-            range.baseArrayLayer = 0;
-            range.layerCount = 1;
-
-            VkImageMemoryBarrier image_barrier_transfer_dst = {};
-            image_barrier_transfer_dst.sType =
-                VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            image_barrier_transfer_dst.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            image_barrier_transfer_dst.newLayout =
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            image_barrier_transfer_dst.image = m_texture_image;
-            image_barrier_transfer_dst.subresourceRange = range;
-            image_barrier_transfer_dst.srcAccessMask = 0;
-            image_barrier_transfer_dst.dstAccessMask =
-                VK_ACCESS_TRANSFER_WRITE_BIT;
-
-            // Barrier the image into the transfer-receive layout
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = m_texture_image;
+            barrier.subresourceRange = VkImageSubresourceRange{
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            };
+            // Earlier frames on the queue may still be sampling the image
+            barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
             vkCmdPipelineBarrier(
                 cmd_buffer.vk_cmd_buffer(),
-                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                 VK_PIPELINE_STAGE_TRANSFER_BIT,
                 0,
                 0,
@@ -214,53 +449,33 @@ void Image::upload(const void* data) {
                 0,
                 nullptr,
                 1,
-                &image_barrier_transfer_dst
+                &barrier
             );
 
-            // 2.2. Copy buffer to image
-            VkBufferImageCopy copy_region = {};
-            copy_region.bufferOffset = 0;
-            copy_region.bufferRowLength = 0;
-            copy_region.bufferImageHeight = 0;
-            copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            copy_region.imageSubresource.mipLevel = 0;
-            copy_region.imageSubresource.baseArrayLayer = 0;
-            copy_region.imageSubresource.layerCount = 1;
-            copy_region.imageExtent = m_extent;
-
-            // Copy the staging buffer into the image
             vkCmdCopyBufferToImage(
                 cmd_buffer.vk_cmd_buffer(),
                 m_staging_buffer,
                 m_texture_image,
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &copy_region
+                static_cast<uint32_t>(copy_regions.size()),
+                copy_regions.data()
             );
 
-            // 2.3. Transition image to shader read optimal layout
-            VkImageMemoryBarrier image_barrier_shader_readeable =
-                image_barrier_transfer_dst;
-            image_barrier_shader_readeable.oldLayout =
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            image_barrier_shader_readeable.newLayout =
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            image_barrier_shader_readeable.srcAccessMask =
-                VK_ACCESS_TRANSFER_WRITE_BIT;
-            image_barrier_shader_readeable.dstAccessMask =
-                VK_ACCESS_SHADER_READ_BIT;
-            // Barrier the image into the shader readable layout
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
             vkCmdPipelineBarrier(
                 cmd_buffer.vk_cmd_buffer(),
                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                 0,
                 0,
                 nullptr,
                 0,
                 nullptr,
                 1,
-                &image_barrier_shader_readeable
+                &barrier
             );
         }
     );
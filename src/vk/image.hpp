@@ -1,22 +1,30 @@
 #pragma once
 
+#include "core/task.hpp"
+#include "vk/cmd_buffer.hpp"
 #include "vk/device.hpp"
 #include "vk/dset.hpp"
 
 #include <vulkan/vulkan_core.h>
 
+#include <span>
+
 namespace kzn::vk {
 
+//! Sampled 2D image, or 2D array image with more than one layer.
 class Image {
 public:
     // Ctor
+    //! \warning Asserts that the device supports \p format for \p usage_flags.
     Image(
         Device& device,
         VkExtent3D extent,
         VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
         VkImageUsageFlags usage_flags = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
                                         VK_IMAGE_USAGE_SAMPLED_BIT,
-        VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT
+        VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT,
+        uint32_t mip_levels = 1,
+        uint32_t array_layers = 1
     );
     // Copy
     Image(const Image&) = delete;
@@ -27,9 +35,25 @@ public:
     // Dtor
     ~Image();
 
+    //! Size in bytes of all mip levels and layers.
     [[nodiscard]]
     uint64_t size() const noexcept;
 
+    [[nodiscard]]
+    VkFormat format() const noexcept {
+        return m_format;
+    }
+
+    [[nodiscard]]
+    uint32_t mip_levels() const noexcept {
+        return m_mip_levels;
+    }
+
+    [[nodiscard]]
+    uint32_t array_layers() const noexcept {
+        return m_array_layers;
+    }
+
     [[nodiscard]]
     VkImageView vk_image_view() const noexcept {
         return m_texture_image_view;
@@ -43,11 +67,31 @@ public:
     [[nodiscard]]
     DescriptorInfo info() const noexcept;
 
+    //! Uploads every mip level and layer of the image.
+    //! \param data Mip levels tightly packed, largest first, each with all
+    //! its layers.
     void upload(const void* data);
 
+    //! Uploads every mip level and layer of the image like upload(), but
+    //! resumes once the copy is done instead of blocking until then.
+    //! \param data Mip levels tightly packed, largest first, each with all
+    //! its layers. Copied when the task starts.
+    //! \warning The image must outlive the task, and must not be uploaded to
+    //! again until the task finishes.
+    Task<void> upload_async(const void* data);
+
+    //! Uploads rectangles of an uncompressed single mip, single layer image
+    //! that was already uploaded and may be sampled by frames in flight. The
+    //! copy waits for earlier fragment shader reads.
+    //! \param data Pixels of the whole image, tightly packed.
+    void upload_regions(const void* data, std::span<const VkRect2D> rects);
+
 private:
     Device* m_device_ptr;
     VkExtent3D m_extent;
+    VkFormat m_format;
+    uint32_t m_mip_levels;
+    uint32_t m_array_layers;
     // Staging buffer
     VkBuffer m_staging_buffer;
     VmaAllocation m_staging_buffer_allocation;
@@ -58,6 +102,10 @@ private:
     VkSampler m_texture_sampler;
 
 private:
+    //! Copies all mip levels and layers into the staging buffer.
+    void write_staging(const void* data);
+    //! Records the copy of the staging buffer into the whole image.
+    void record_upload(vk::CommandBuffer& cmd_buffer);
     void delete_image_data();
 };
 
@@ -1,11 +1,14 @@
 #include "pipeline.hpp"
 
+#include "core/assert.hpp"
 #include "core/log.hpp"
 #include "vk/error.hpp"
+#include "vk/pipeline_builder.hpp"
 #include "vk/shader_code.hpp"
 
 #include <array>
 #include <fstream>
+#include <utility>
 #include <vulkan/vulkan_core.h>
 
 namespace kzn::vk {
@@ -306,6 +309,23 @@ Pipeline::Pipeline(
     Log::trace("Pipeline created");
 }
 
+bool Pipeline::uses_shader(const ShaderCode* shader_ptr) const {
+    return m_builder_ptr != nullptr && m_builder_ptr->uses_shader(shader_ptr);
+}
+
+void Pipeline::rebuild() {
+    KZN_ASSERT_MSG(
+        m_builder_ptr != nullptr, "Pipeline wasn't created by a PipelineBuilder"
+    );
+    auto new_pipeline = m_builder_ptr->build(m_device);
+    // Frames in flight may still be using the current pipeline
+    m_device.wait_idle();
+    std::swap(m_vk_pipeline, new_pipeline.m_vk_pipeline);
+    std::swap(m_pipeline_layout, new_pipeline.m_pipeline_layout);
+    std::swap(m_sparse_dset_layouts, new_pipeline.m_sparse_dset_layouts);
+    Log::trace("Pipeline rebuilt");
+}
+
 Pipeline::~Pipeline() {
     vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
     vkDestroyPipeline(m_device, m_vk_pipeline, nullptr);
@@ -8,8 +8,12 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <memory>
+
 namespace kzn::vk {
 
+class PipelineBuilder;
+
 struct PipelineLayout {
     std::vector<VkPushConstantRange> push_constants;
     std::vector<VkDescriptorSetLayout> descriptor_sets;
@@ -143,11 +147,24 @@ public:
     [[nodiscard]]
     VkPipeline vk_pipeline() const { return m_vk_pipeline; }
 
+    //! Check if \p shader_ptr is one of the stages of a pipeline created by a
+    //! `PipelineBuilder`.
+    [[nodiscard]]
+    bool uses_shader(const ShaderCode* shader_ptr) const;
+
+    //! Creates the pipeline again from its `PipelineBuilder`, with the current
+    //! contents of its shaders. Waits for the device to be idle.
+    //! \warning Only pipelines created by a `PipelineBuilder` can be rebuilt.
+    void rebuild();
+
 private:
+    friend class PipelineBuilder;
+
     Device& m_device;
     VkPipeline m_vk_pipeline;
     VkPipelineLayout m_pipeline_layout = VK_NULL_HANDLE;
     std::vector<DescriptorSetLayout> m_sparse_dset_layouts;
+    std::shared_ptr<PipelineBuilder> m_builder_ptr = nullptr;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
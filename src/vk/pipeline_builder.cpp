@@ -145,6 +145,12 @@ PipelineBuilder& PipelineBuilder::set_fragment_stage(std::shared_ptr<ShaderCode>
     return *this;
 }
 
+PipelineBuilder& PipelineBuilder::set_vertex_input(const VertexLayout& layout) {
+    m_vertex_bindings = std::vector{vertex_binding(layout.stride, 0)};
+    m_vertex_attributes = layout.vk_attributes(0);
+    return *this;
+}
+
 PipelineBuilder& PipelineBuilder::set_topology(VkPrimitiveTopology topology) {
     m_input_assembly_info.topology = topology;
     return *this;
@@ -339,7 +345,19 @@ static VkShaderModule create_shader_module(
     return shader_module;
 }
 
+bool PipelineBuilder::uses_shader(const ShaderCode* shader_ptr) const {
+    return shader_ptr != nullptr
+        && (m_vertex_stage.get() == shader_ptr
+            || m_tess_control_stage.get() == shader_ptr
+            || m_tess_evaluation_stage.get() == shader_ptr
+            || m_geometry_stage.get() == shader_ptr
+            || m_fragment_stage.get() == shader_ptr);
+}
+
 Pipeline PipelineBuilder::build(Device& device) {
+    // Builder may have been copied or moved since the create infos were set
+    m_color_blend_info.pAttachments = &m_color_blend_attachment;
+    m_dynamic_state_info.pDynamicStates = m_dynamic_state_enables.data();
 
     // Partition array to have null stages at last
     // No need to take ownership in this auxiliary function.
@@ -479,6 +497,7 @@ Pipeline PipelineBuilder::build(Device& device) {
     pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
     
     Pipeline pipeline{device, pipeline_create_info, sparse_dset_layouts};
+    pipeline.m_builder_ptr = std::make_shared<PipelineBuilder>(*this);
 
     ///////////////////////////////////////////////////////////////////////////
     // Destroy shader modules and dset layouts
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vk/pipeline.hpp"
+#include "vk/vertex_layout.hpp"
 
 #include <memory>
 #include <vulkan/vulkan_core.h>
@@ -11,7 +12,7 @@ class PipelineBuilder {
 public:
     PipelineBuilder(VkRenderPass render_pass);
     PipelineBuilder(PipelineBuilder&&) = default;
-    PipelineBuilder(const PipelineBuilder&) = delete;
+    PipelineBuilder(const PipelineBuilder&) = default;
     ~PipelineBuilder() = default;
 
     // Pipeline Stages
@@ -22,6 +23,7 @@ public:
     PipelineBuilder& set_fragment_stage(std::shared_ptr<ShaderCode> shader);
 
     // Vertex Input
+    PipelineBuilder& set_vertex_input(const VertexLayout& layout);
     template<typename... Ts>
     PipelineBuilder& set_vertex_input();
 
@@ -43,7 +45,12 @@ public:
     PipelineBuilder& set_max_depth(float max);
     PipelineBuilder& set_stencil_test(VkBool32 enable);
 
+    //! Check if \p shader_ptr is one of the pipeline stages.
+    [[nodiscard]]
+    bool uses_shader(const ShaderCode* shader_ptr) const;
 
+    //! Creates the pipeline. The pipeline keeps a copy of this builder to be
+    //! rebuilt when its shaders are reloaded.
     [[nodiscard]]
     Pipeline build(Device& device);
 
@@ -77,11 +84,7 @@ private:
 
 template<typename... Ts>
 PipelineBuilder& PipelineBuilder::set_vertex_input() {
-    uint32_t stride = (sizeof(Ts) + ...);
-    m_vertex_bindings = std::vector{vertex_binding(stride, 0)};
-    auto attribs = vertex_attributes<Ts...>(0);
-    m_vertex_attributes = std::vector(attribs.begin(), attribs.end());
-    return *this;
+    return set_vertex_input(VertexLayout::of<Ts...>());
 }
 
 } // namespace kzn::vk
\ No newline at end of file
@@ -28,4 +28,13 @@ std::shared_ptr<ShaderCode> ShaderCode::load(const std::filesystem::path& path)
     return std::make_shared<ShaderCode>(std::move(bytecode));
 }
 
+std::shared_ptr<ShaderCode> ShaderCode::load_from_memory(
+    std::span<const std::byte> bytes
+) {
+    const auto* data_ptr = reinterpret_cast<const char*>(bytes.data());
+    return std::make_shared<ShaderCode>(
+        std::vector<char>(data_ptr, data_ptr + bytes.size())
+    );
+}
+
 } // namespace kzn::vk
\ No newline at end of file
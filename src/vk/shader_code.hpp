@@ -1,16 +1,26 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace kzn::vk {
 
 struct ShaderCode {
     std::vector<char> bytecode;
-    
+
+    [[nodiscard]]
+    std::size_t byte_size() const { return bytecode.size(); }
+
     [[nodiscard]]
     static std::shared_ptr<ShaderCode> load(const std::filesystem::path& path);
+
+    [[nodiscard]]
+    static std::shared_ptr<ShaderCode> load_from_memory(
+        std::span<const std::byte> bytes
+    );
 };
 
 } // namespace kzn::vk
\ No newline at end of file
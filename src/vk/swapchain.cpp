@@ -8,17 +8,19 @@ namespace kzn::vk {
 Swapchain::Swapchain(
     Device& device,
     Surface& surface,
-    VkExtent2D requested_extent
+    VkExtent2D requested_extent,
+    VkPresentModeKHR preferred_present_mode
 )
     : m_device{device}
-    , m_surface{surface} {
+    , m_surface{surface}
+    , m_preferred_present_mode{preferred_present_mode} {
 
     const auto& support = m_device.swapchain_support();
     const auto& queue_families = m_device.queue_families();
 
     // 1. Create Swapchain //
     m_surface_format = support.select_format();
-    m_present_mode = support.select_present_mode();
+    m_present_mode = support.select_present_mode(m_preferred_present_mode);
     m_extent = support.select_extent(requested_extent);
 
     // Select image count
@@ -148,7 +150,7 @@ void Swapchain::recreate(VkExtent2D new_extent) {
 
     // Create new swapchain
     m_surface_format = support.select_format();
-    m_present_mode = support.select_present_mode();
+    m_present_mode = support.select_present_mode(m_preferred_present_mode);
     m_extent = support.select_extent(new_extent);
 
     auto image_count = static_cast<uint32_t>(m_images.size());
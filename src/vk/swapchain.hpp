@@ -11,7 +11,12 @@ namespace kzn::vk {
 class Swapchain {
 public:
     // Ctor
-    Swapchain(Device& device, Surface& surface, VkExtent2D extent);
+    Swapchain(
+        Device& device,
+        Surface& surface,
+        VkExtent2D extent,
+        VkPresentModeKHR preferred_present_mode = VK_PRESENT_MODE_MAILBOX_KHR
+    );
     // Copy
     Swapchain(const Swapchain&) = delete;
     Swapchain& operator=(const Swapchain&) = delete;
@@ -42,6 +47,19 @@ public:
         return std::span{m_image_views.data(), m_image_views.size()};
     }
     [[nodiscard]]
+    constexpr VkPresentModeKHR present_mode() const {
+        return m_present_mode;
+    }
+    [[nodiscard]]
+    constexpr VkPresentModeKHR preferred_present_mode() const {
+        return m_preferred_present_mode;
+    }
+    //! Present mode to use when the swapchain is next (re)created. Falls back
+    //! to FIFO if not supported by the surface.
+    constexpr void set_preferred_present_mode(VkPresentModeKHR present_mode) {
+        m_preferred_present_mode = present_mode;
+    }
+    [[nodiscard]]
     constexpr size_t current_index() const {
         return m_current_index;
     }
@@ -55,6 +73,7 @@ private:
     VkSwapchainKHR m_vk_swapchain = VK_NULL_HANDLE;
     VkSurfaceFormatKHR m_surface_format;
     VkPresentModeKHR m_present_mode;
+    VkPresentModeKHR m_preferred_present_mode;
     VkExtent2D m_extent;
     uint32_t m_image_count;
     std::vector<VkImage> m_images;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "vk/utils.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+namespace kzn::vk {
+
+//! Layout of the vertices of a single interleaved vertex buffer. Attributes
+//! are bound to consecutive shader locations starting at 0.
+struct VertexLayout {
+    struct Attribute {
+        VkFormat format;
+        std::uint32_t offset;
+    };
+
+    std::uint32_t stride;
+    std::vector<Attribute> attributes;
+
+    //! Layout of tightly packed float attributes of types \p Ts.
+    //! Usage: VertexLayout::of<Vec3, Vec3, Vec2>();
+    template<typename... Ts>
+    [[nodiscard]]
+    static VertexLayout of() {
+        VertexLayout layout{.stride = (0 + ... + sizeof(Ts)), .attributes = {}};
+        for (const auto& attribute : vertex_attributes<Ts...>(0)) {
+            layout.attributes.push_back({attribute.format, attribute.offset});
+        }
+        return layout;
+    }
+
+    [[nodiscard]]
+    std::vector<VkVertexInputAttributeDescription> vk_attributes(
+        std::uint32_t binding = 0
+    ) const {
+        std::vector<VkVertexInputAttributeDescription> vk_attributes;
+        vk_attributes.reserve(attributes.size());
+        for (std::uint32_t location = 0; location < attributes.size(); ++location) {
+            vk_attributes.push_back(VkVertexInputAttributeDescription{
+                .location = location,
+                .binding = binding,
+                .format = attributes[location].format,
+                .offset = attributes[location].offset,
+            });
+        }
+        return vk_attributes;
+    }
+};
+
+} // namespace kzn::vk